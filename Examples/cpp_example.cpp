@@ -1,6 +1,5 @@
 #include "CallbackLogger.hpp"
 #include <iostream>
-#include <thread>
 #include <chrono>
 #include <string>
 
@@ -60,9 +59,9 @@ int main() {
     LOG(logger, Severity::Info, MyComponent::DATABASE, "Database query executed");
     LOG(logger, Severity::Info, MyComponent::NETWORK, "Network packet sent");
 
-    std::cout << "\nCheck 'all_logs_cpp.log' and 'db_warnings_cpp.log' for file output." << std::endl;
+    // Wait for the worker to deliver the entries logged so far
+    logger.flush(std::chrono::seconds(1));
 
-    // Give time for async logging
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    std::cout << "\nCheck 'all_logs_cpp.log' and 'db_warnings_cpp.log' for file output." << std::endl;
     return 0;
 }
@@ -1,4 +1,5 @@
 #include "python_logger_types.hpp"
+#include <pybind11/stl.h>
 
 ComponentEnumEntry py_enum_to_entry(const py::object& enum_object)
 {
@@ -11,6 +12,37 @@ ComponentEnumEntry py_enum_to_entry(const py::object& enum_object)
     return ComponentEnumEntry{std::variant<std::type_index, std::string>{py_enum_module_name + MODULE_CLASS_DELIMITER + py_enum_class_name}, value};
 }
 
+py::object component_entry_to_py(const ComponentEnumEntry& component)
+{
+    const std::variant<std::type_index, std::string>& type_variant = component.get_type();
+
+    if (std::holds_alternative<std::string>(type_variant))
+    {
+        const std::string& component_string = std::get<std::string>(type_variant);
+        size_t module_class_delimiter_position = component_string.find(MODULE_CLASS_DELIMITER);
+        if (module_class_delimiter_position == std::string::npos)
+            throw std::runtime_error("[!] Invalid enum type string format (expected module and class data)");
+
+        std::string module_name = component_string.substr(0, module_class_delimiter_position);
+        std::string class_name = component_string.substr(module_class_delimiter_position + std::strlen(MODULE_CLASS_DELIMITER));
+        uint32_t value = component.get_enum_value();
+
+        py::object py_module = py::module_::import(module_name.c_str());
+        py::object enum_class = py_module.attr(class_name.c_str());//
+        if (!py::hasattr(enum_class, "__members__"))
+            throw std::runtime_error("[!] Enum class '" + class_name + "' not found in module '" + module_name + "'");
+        return enum_class(value);
+    }
+    else if (std::holds_alternative<std::type_index>(type_variant)) // A cpp enum
+    {
+        return py::object(py::int_(component.get_enum_value()));
+    }
+    else
+    {
+        throw std::runtime_error("[!] Unknown enum type in log entry!");
+    }
+}
+
 void register_python_logger_types(py::module_& m)
 {
     py::enum_<Severity>(m, "Severity")
@@ -22,44 +54,42 @@ void register_python_logger_types(py::module_& m)
         .value("Fatal", Severity::Fatal)
         .export_values();
 
+    py::enum_<FileFormat>(m, "FileFormat")
+        .value("Text", FileFormat::Text)
+        .value("JsonLines", FileFormat::JsonLines);
+
+    py::enum_<CallbackPriority>(m, "CallbackPriority")
+        .value("Low", CallbackPriority::Low)
+        .value("Normal", CallbackPriority::Normal)
+        .value("High", CallbackPriority::High);
+
 
     py::class_<LogEntry>(m, "LogEntry")
             .def_readonly("severity", &LogEntry::severity)
             .def_property_readonly("component", [](const LogEntry& entry)
             {
-                const ComponentEnumEntry& component = entry.component;
-                const std::variant<std::type_index, std::string>& type_variant = component.get_type();
-
-                if (std::holds_alternative<std::string>(type_variant))
-                {
-                    const std::string& component_string = std::get<std::string>(type_variant);
-                    size_t module_class_delimiter_position = component_string.find(MODULE_CLASS_DELIMITER);
-                    if (module_class_delimiter_position == std::string::npos)
-                        throw std::runtime_error("[!] Invalid enum type string format (expected module and class data)");
-                    
-                    std::string module_name = component_string.substr(0, module_class_delimiter_position);
-                    std::string class_name = component_string.substr(module_class_delimiter_position + std::strlen(MODULE_CLASS_DELIMITER));
-                    uint32_t value = component.get_enum_value();
-
-                    py::object py_module = py::module_::import(module_name.c_str());
-                    py::object enum_class = py_module.attr(class_name.c_str());//
-                    if (!py::hasattr(enum_class, "__members__"))
-                        throw std::runtime_error("[!] Enum class '" + class_name + "' not found in module '" + module_name + "'");
-                    return enum_class(value);
-                }
-                else if (std::holds_alternative<std::type_index>(type_variant)) // A cpp enum
-                {
-                    return py::object(py::int_(component.get_enum_value()));
-                }
-                else
-                {
-                    throw std::runtime_error("[!] Unknown enum type in log entry!");
-                }
+                return component_entry_to_py(entry.component);
             })
             .def_readonly("message", &LogEntry::message)
             .def_readonly("file", &LogEntry::file)
             .def_readonly("line", &LogEntry::line)
-            .def_readonly("timestamp", &LogEntry::timestamp);
+            .def_readonly("timestamp", &LogEntry::timestamp)
+            .def_property_readonly("fields", [](const LogEntry& entry)
+            {
+                py::dict fields;
+                for (size_t index = 0; index < entry.fields.size(); ++index)
+                {
+                    const LogField field = entry.fields[index];
+                    py::str key(field.key.data(), field.key.size());
+                    if (field.type == LogFieldType::Int)
+                        fields[key] = py::int_(field.int_value);
+                    else if (field.type == LogFieldType::Double)
+                        fields[key] = py::float_(field.double_value);
+                    else
+                        fields[key] = py::str(field.string_value.data(), field.string_value.size());
+                }
+                return fields;
+            });
 
     py::class_<ComponentEnumEntry>(m, "ComponentEnumEntry")
         .def(py::init<>())
@@ -74,4 +104,79 @@ void register_python_logger_types(py::module_& m)
         .def("__gt__", &ComponentEnumEntry::operator>)
         .def("__le__", &ComponentEnumEntry::operator<=)
         .def("__ge__", &ComponentEnumEntry::operator>=);
-}
\ No newline at end of file
+
+    py::class_<ComponentSubtreeFilter>(m, "ComponentSubtreeFilter")
+        .def(py::init([](const py::dict& roots)
+            {
+                ComponentSubtreeFilter subtree_filter;
+                for (const std::pair<py::handle, py::handle> root : roots)
+                    subtree_filter.roots[py_enum_to_entry(py::reinterpret_borrow<py::object>(root.first))] = root.second.cast<Severity>();
+                return subtree_filter;
+            }), py::arg("roots"))
+        .def(py::init([](const py::object& root, Severity min_severity)
+            {
+                return ComponentSubtreeFilter(py_enum_to_entry(root), min_severity);
+            }), py::arg("root"), py::arg("min_severity") = Severity::Debug);
+
+    py::class_<MessageFilter>(m, "MessageFilter")
+        .def_static("contains", &MessageFilter::contains, py::arg("substring"))
+        .def_static("contains_any", &MessageFilter::contains_any, py::arg("substrings"))
+        .def_static("matches_regex", &MessageFilter::matches_regex, py::arg("pattern"));
+
+    py::class_<CallbackStatistics>(m, "CallbackStatistics")
+        .def_readonly("invocations", &CallbackStatistics::invocations)
+        .def_readonly("exceptions", &CallbackStatistics::exceptions)
+        .def_readonly("is_disabled", &CallbackStatistics::is_disabled)
+        .def_readonly("latency_histogram", &CallbackStatistics::latency_histogram);
+
+    py::class_<ShutdownReport>(m, "ShutdownReport")
+        .def_readonly("is_drained", &ShutdownReport::is_drained)
+        .def_readonly("dropped_tasks", &ShutdownReport::dropped_tasks)
+        .def_readonly("stuck_workers", &ShutdownReport::stuck_workers);
+
+    py::class_<LaneStatistics>(m, "LaneStatistics")
+        .def_readonly("queue_depth", &LaneStatistics::queue_depth)
+        .def_readonly("tasks_dequeued", &LaneStatistics::tasks_dequeued)
+        .def_readonly("wait_histogram", &LaneStatistics::wait_histogram);
+
+    py::class_<LoggerStatistics>(m, "LoggerStatistics")
+        .def_property_readonly("logged_per_severity", [](const LoggerStatistics& statistics)
+        {
+            py::dict per_severity;
+            for (size_t severity = 0; severity < statistics.logged_per_severity.size(); ++severity)
+                per_severity[py::cast(static_cast<Severity>(severity))] = statistics.logged_per_severity[severity];
+            return per_severity;
+        })
+        .def_property_readonly("logged_per_component", [](const LoggerStatistics& statistics)
+        {
+            py::dict per_component;
+            for (const auto& component_count : statistics.logged_per_component)
+                per_component[component_entry_to_py(component_count.first)] = component_count.second;
+            return per_component;
+        })
+        .def_readonly("filtered_out", &LoggerStatistics::filtered_out)
+        .def_readonly("message_filter_rejections", &LoggerStatistics::message_filter_rejections)
+        .def_readonly("rate_limited", &LoggerStatistics::rate_limited)
+        .def_readonly("truncated_fields", &LoggerStatistics::truncated_fields)
+        .def_property_readonly("sampled_out_per_severity", [](const LoggerStatistics& statistics)
+        {
+            py::dict per_severity;
+            for (size_t severity = 0; severity < statistics.sampled_out_per_severity.size(); ++severity)
+                per_severity[py::cast(static_cast<Severity>(severity))] = statistics.sampled_out_per_severity[severity];
+            return per_severity;
+        })
+        .def_readonly("tasks_enqueued", &LoggerStatistics::tasks_enqueued)
+        .def_readonly("queue_depth", &LoggerStatistics::queue_depth)
+        .def_readonly("peak_queue_depth", &LoggerStatistics::peak_queue_depth)
+        .def_readonly("worker_busy_time_ns", &LoggerStatistics::worker_busy_time_ns)
+        .def_readonly("unpinned_workers", &LoggerStatistics::unpinned_workers)
+        .def_readonly("function_callbacks", &LoggerStatistics::function_callbacks)
+        .def_readonly("file_callbacks", &LoggerStatistics::file_callbacks)
+        .def_property_readonly("lanes", [](const LoggerStatistics& statistics)
+        {
+            py::dict per_priority;
+            for (size_t priority = 0; priority < statistics.lanes.size(); ++priority)
+                per_priority[py::cast(static_cast<CallbackPriority>(priority))] = statistics.lanes[priority];
+            return per_priority;
+        });
+}
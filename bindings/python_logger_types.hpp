@@ -4,6 +4,9 @@
 #include "Models/ComponentEnumEntry.hpp"
 #include "Models/LogEntry.hpp"
 #include "Models/Severity.hpp"
+#include "Models/LoggerStatistics.hpp"
+#include "Models/ComponentSubtreeFilter.hpp"
+#include "Models/MessageFilter.hpp"
 
 namespace py = pybind11;
 
@@ -18,7 +21,15 @@ static constexpr const char* MODULE_CLASS_DELIMITER = "#";
 ComponentEnumEntry py_enum_to_entry(const py::object& enum_object);
 
 /**
- * @brief Registers Python types (Severity, LogEntry, ComponentEnumEntry) with the module.
+ * @brief Converts a ComponentEnumEntry back to the Python object it was logged with.
+ *
+ * @param component The component to convert.
+ * @return The Python enum member for Python components, or the enum value as an int for Cpp components.
+ */
+py::object component_entry_to_py(const ComponentEnumEntry& component);
+
+/**
+ * @brief Registers Python types (Severity, LogEntry, ComponentEnumEntry, filters, statistics) with the module.
  *
  * @param m The pybind11 module.
  */
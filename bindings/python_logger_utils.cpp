@@ -31,7 +31,11 @@ uint32_t handle_register_callback(
         py::object filter,
         RegisterFunc register_function)
 {
-    if (py::isinstance<py::dict>(filter))
+    if (py::isinstance<ComponentSubtreeFilter>(filter))
+    {
+        return register_function(filter.cast<ComponentSubtreeFilter>());
+    }
+    else if (py::isinstance<py::dict>(filter))
     {
         std::unordered_map<ComponentEnumEntry, Severity, ComponentEnumEntryHasher> native_filter;
         for (std::pair<pybind11::handle, pybind11::handle> item : filter.cast<py::dict>())
@@ -125,15 +129,54 @@ void register_python_logger_utils(py::module_& m)
 {
     py::class_<CallbackLogger>(m, "CallbackLoggerBase")
         .def(py::init<>())
-        .def("shutdown", &CallbackLogger::shutdown)
+        .def("shutdown", py::overload_cast<>(&CallbackLogger::shutdown))
+        .def("shutdown",
+            [](CallbackLogger& logger, double timeout)
+            {
+                const auto deadline = std::chrono::steady_clock::now()
+                    + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(timeout));
+                return logger.shutdown(deadline);
+            },
+            py::arg("timeout"), py::call_guard<py::gil_scoped_release>())
+        .def("flush",
+            [](CallbackLogger& logger, double timeout)
+            {
+                return logger.flush(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::duration<double>(timeout)));
+            },
+            py::arg("timeout"), py::call_guard<py::gil_scoped_release>())
         .def("unregister_function_callback", &CallbackLogger::unregister_function_callback, py::arg("handle"))
-        .def("unregister_file_callback", &CallbackLogger::unregister_file_callback, py::arg("handle"));
+        .def("unregister_file_callback", &CallbackLogger::unregister_file_callback, py::arg("handle"))
+        .def("stats", &CallbackLogger::stats)
+        .def("set_callback_priority", &CallbackLogger::set_callback_priority, py::arg("handle"), py::arg("priority"))
+        .def("set_callback_failure_threshold", &CallbackLogger::set_callback_failure_threshold, py::arg("consecutive_failures"))
+        .def("set_call_site_rate_limit", &CallbackLogger::set_call_site_rate_limit,
+             py::arg("entries_per_second"), py::arg("burst") = 1)
+        .def("set_sampling_rate", py::overload_cast<Severity, double>(&CallbackLogger::set_sampling_rate),
+             py::arg("severity"), py::arg("rate"))
+        .def("set_sampling_rate",
+            [](CallbackLogger& logger, py::object component, Severity severity, double rate)
+            {
+                logger.set_sampling_rate(py_enum_to_entry(component), severity, rate);
+            },
+            py::arg("component"), py::arg("severity"), py::arg("rate"))
+        .def_static("set_thread_trace_id", &CallbackLogger::set_thread_trace_id, py::arg("trace_id"))
+        .def("enable_flight_recorder",
+            [](CallbackLogger& logger, const std::string& dump_path, size_t records_per_thread, bool install_crash_handler)
+            {
+                FlightRecorderOptions options;
+                options.dump_path = dump_path;
+                options.records_per_thread = records_per_thread;
+                options.install_crash_handler = install_crash_handler;
+                logger.enable_flight_recorder(options);
+            },
+            py::arg("dump_path"), py::arg("records_per_thread") = 1024, py::arg("install_crash_handler") = false)
+        .def("dump_flight_recorder", &CallbackLogger::dump_flight_recorder);
 
+    // shutdown and flush are inherited, redefining one here would hide the base overloads
     py::class_<PyCallbackLogger, CallbackLogger>(m, "CallbackLogger")
         .def(py::init<>())
-        .def("shutdown", &CallbackLogger::shutdown)
         .def("register_function_callback",
-            [](CallbackLogger& logger, py::function py_callback, py::object filter)
+            [](CallbackLogger& logger, py::function py_callback, py::object filter, py::object message_filter)
             {
                 LogCallback safe_callback = [py_callback](const LogEntry& entry)
                 {
@@ -152,30 +195,71 @@ void register_python_logger_utils(py::module_& m)
                         py::print("[!] Unknown exception in Python callback.");
                     }
                 };
+                const MessageFilter native_message_filter =
+                    message_filter.is_none() ? MessageFilter{} : message_filter.cast<MessageFilter>();
                 return handle_register_callback(
                     logger, safe_callback, filter,
                     [&](auto&& native_filter) {
-                        return logger.register_function_callback(safe_callback, std::forward<decltype(native_filter)>(native_filter));
+                        return logger.register_function_callback(safe_callback, std::forward<decltype(native_filter)>(native_filter),
+                                                                 native_message_filter);
                     }
                 );
-            }, py::arg("callback"), py::arg("filter") = py::none())
+            }, py::arg("callback"), py::arg("filter") = py::none(), py::arg("message_filter") = py::none())
         .def("register_file_callback",
-            [](CallbackLogger& logger, const std::string& filename, py::object filter)
+            [](CallbackLogger& logger, const std::string& filename, py::object filter, FileFormat format, py::object pattern,
+               py::object message_filter)
             {
+                // A pattern replaces the layout of the built-in format
+                const LogFormatterPtr formatter = pattern.is_none()
+                    ? make_log_formatter(format)
+                    : std::make_shared<const PatternFormatter>(pattern.cast<std::string>());
+                const MessageFilter native_message_filter =
+                    message_filter.is_none() ? MessageFilter{} : message_filter.cast<MessageFilter>();
                 return handle_register_callback(
                     logger, nullptr, filter,
                     [&](auto&& native_filter) {
-                        return logger.register_file_callback(filename, std::forward<decltype(native_filter)>(native_filter));
+                        return logger.register_file_callback(filename, std::forward<decltype(native_filter)>(native_filter),
+                                                             native_message_filter, formatter);
                     }
                 );
-            }, py::arg("filename"), py::arg("filter") = py::none())
+            }, py::arg("filename"), py::arg("filter") = py::none(), py::arg("format") = FileFormat::Text,
+               py::arg("pattern") = py::none(), py::arg("message_filter") = py::none())
         .def("log",
             [](CallbackLogger& logger, Severity severity, py::object component, const std::string& message,
-               const std::string& file, uint32_t line)
+               const std::string& file, uint32_t line, py::object fields)
             {
                 ComponentEnumEntry entry = py_enum_to_entry(component);
-                logger.log(severity, entry, message, file, line);
+                if (fields.is_none())
+                {
+                    logger.log(severity, entry, message, file, line);
+                    return;
+                }
+                // Keys and string values are copied by LogFields::add, the strings only need to outlive the call
+                LogFields native_fields;
+                for (const auto& item : fields.cast<py::dict>())
+                {
+                    const std::string key = py::cast<std::string>(item.first);
+                    const py::handle value = item.second;
+                    if (py::isinstance<py::bool_>(value) || py::isinstance<py::int_>(value))
+                        (void)native_fields.add(LogField(key, value.cast<int64_t>()));
+                    else if (py::isinstance<py::float_>(value))
+                        (void)native_fields.add(LogField(key, value.cast<double>()));
+                    else if (py::isinstance<py::str>(value))
+                    {
+                        const std::string string_value = value.cast<std::string>();
+                        (void)native_fields.add(LogField(key, std::string_view(string_value)));
+                    }
+                    else
+                        throw std::invalid_argument("Log field values must be int, float or str, got one for key: " + key);
+                }
+                logger.log(severity, entry, message, native_fields, file, line);
             },
             py::arg("severity"), py::arg("component"), py::arg("message"),
-            py::arg("file") = "", py::arg("line") = 0);
+            py::arg("file") = "", py::arg("line") = 0, py::arg("fields") = py::none())
+        .def("set_component_parent",
+            [](CallbackLogger& logger, py::object component, py::object parent)
+            {
+                logger.set_component_parent(py_enum_to_entry(component), py_enum_to_entry(parent));
+            },
+            py::arg("component"), py::arg("parent"));
 }
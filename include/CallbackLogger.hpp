@@ -3,8 +3,21 @@
 #include "Models/Severity.hpp"
 #include "Models/ComponentEnumEntry.hpp"
 #include "Models/LogEntry.hpp"
+#include "Models/LogFields.hpp"
 #include "Models/CallbackFilters.hpp"
+#include "Models/CallbackError.hpp"
+#include "Models/LoggerStatistics.hpp"
+#include "Models/CallbackPriority.hpp"
+#include "Models/ShutdownReport.hpp"
+#include "Models/MessageFilter.hpp"
+#include "Models/FlightRecorderOptions.hpp"
+#include "Models/FileWriterOptions.hpp"
+#include "Models/FileFormat.hpp"
 #include "Utils/LoggerInternalCallbacks.hpp"
+#include "Utils/JsonLinesFormat.hpp"
+#include "Utils/LogFormatter.hpp"
+#include "Utils/EpochDomain.hpp"
 #include "Utils/SeverityUtils.hpp"
 #include "Utils/ComponentEnumEntryUtils.hpp"
 #include "CallbackLoggerClass.hpp"
+#include "SharedMemoryTransport.hpp"
@@ -1,14 +1,19 @@
 #pragma once
+#include <algorithm>
+#include <array>
 #include <unordered_map>
 #include <set>
 #include <queue>
+#include <deque>
 #include <thread>
 #include <condition_variable>
 #include <atomic>
 #include <mutex>
+#include <shared_mutex>
 #include <vector>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <iostream>
 
 #include "Utils/SeverityUtils.hpp"
@@ -16,10 +21,32 @@
 #include "Utils/LoggerInternalCallbacks.hpp"
 #include "Models/LogEntry.hpp"
 #include "Models/ComponentEnumEntry.hpp"
+#include "Utils/ComponentEnumEntryUtils.hpp"
 #include "Models/Severity.hpp"
+#include "Models/LoggerStatistics.hpp"
+#include "Models/CallbackError.hpp"
+#include "Models/LoggerOptions.hpp"
+#include "Models/CallbackPriority.hpp"
+#include "Models/ShutdownReport.hpp"
+#include "Models/ComponentSubtreeFilter.hpp"
+#include "Models/MessageFilter.hpp"
+#include "Models/FlightRecorderOptions.hpp"
+#include "Models/FileFormat.hpp"
+#include "Utils/ComponentHierarchy.hpp"
+#include "Utils/LoggerCounters.hpp"
 #include "Utils/TimeUtils.hpp"
+#include "Utils/ThreadUtils.hpp"
+#include "Utils/LogEntryPool.hpp"
+#include "Utils/CallSiteRateLimiter.hpp"
+#include "Utils/LogSampler.hpp"
+#include "Utils/FlightRecorder.hpp"
+#include "Utils/LogFormatter.hpp"
+#include "Utils/EpochDomain.hpp"
+#include "Utils/ForkHandlers.hpp"
 
 using Task = std::function<void()>;
+// Tasks to enqueue, by priority lane
+using LaneTasks = std::array<std::vector<Task>, static_cast<size_t>(CallbackPriority::PRIORITY_COUNT)>;
 
 class CallbackLogger
 {
@@ -31,6 +58,13 @@ public:
      */
     explicit CallbackLogger(size_t thread_count = DEFAULT_THREAD_COUNT);
 
+    /**
+     * @brief Constructs a CallbackLogger from construction options.
+     *
+     * @param options The logger options. A thread count of 0 makes the logger single-threaded.
+     */
+    explicit CallbackLogger(const LoggerOptions& options);
+
     /**
      * @brief Destructor. Stops all worker threads and cleans up resources.
      */
@@ -40,10 +74,46 @@ public:
     CallbackLogger& operator=(const CallbackLogger& other) = delete;
 
     /**
-     * @brief Stops all worker threads and cleans up resources.
+     * @brief Stops all worker threads, flushes the file writers and cleans up resources.
+     * Every entry logged before the call is delivered first, however long it takes.
      */
     void shutdown();
 
+    /**
+     * @brief Delivers the entries logged before the call until a deadline, then stops all worker threads, dropping
+     * the tasks still queued, and flushes the file writers. Callbacks already running at the deadline cannot be
+     * interrupted: their workers are left running, reported as stuck and joined by the destructor.
+     *
+     * @param deadline Time after which the queued tasks are dropped.
+     * @return Whether everything was delivered, how many tasks were dropped and how many workers are stuck.
+     * Concurrent and later calls wait for the first shutdown and return its report.
+     */
+    ShutdownReport shutdown(std::chrono::steady_clock::time_point deadline);
+
+    /**
+     * @brief Waits until every entry logged before the call was delivered to its callbacks, then flushes the
+     * file writers. The logger keeps running.
+     *
+     * @param timeout Maximal time to wait for the deliveries.
+     * @return True if every entry was delivered in time, false on timeout.
+     */
+    bool flush(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Enables the in-memory flight recorder, which keeps the most recent entries of every logging thread,
+     * including the ones filtered out of the callbacks, and dumps them on Fatal entries, on shutdown or on a crash.
+     *
+     * @param options The flight recorder options.
+     */
+    void enable_flight_recorder(const FlightRecorderOptions& options);
+
+    /**
+     * @brief Dumps the flight recorder to its dump file.
+     *
+     * @return True if the dump file was written, false if the recorder is disabled or the file could not be opened.
+     */
+    bool dump_flight_recorder() const;
+
     /**
      * @brief Registers a function callback with a full component and severity filter.
      *
@@ -136,6 +206,168 @@ public:
      */
     void unregister_file_callback(uint32_t handle);
 
+    /**
+     * @brief Registers a function callback with a component and severity filter and a message content filter.
+     *
+     * @param callback The callback function to register.
+     * @param filter Map of components to minimum severities for filtering, empty for all components.
+     * @param message_filter Filter on the message, compiled here and evaluated on the worker threads.
+     * @return Handle to the callback, which can be used to unregister it.
+     */
+    uint32_t register_function_callback(const std::function<void(const LogEntry&)>& callback,
+                                   const std::unordered_map<ComponentEnumEntry, Severity, ComponentEnumEntryHasher>& filter,
+                                   const MessageFilter& message_filter);
+
+    /**
+     * @brief Registers a function callback with a minimum severity and a message content filter.
+     *
+     * @param callback The callback function to register.
+     * @param min_severity Minimum severity for all components.
+     * @param message_filter Filter on the message, compiled here and evaluated on the worker threads.
+     * @return Handle to the callback, which can be used to unregister it.
+     */
+    uint32_t register_function_callback(const std::function<void(const LogEntry&)>& callback,
+                                   Severity min_severity, const MessageFilter& message_filter);
+
+    /**
+     * @brief Registers a file callback with a component and severity filter and a message content filter.
+     *
+     * @param filename The file to write logs to.
+     * @param filter Map of components to minimum severities for filtering, empty for all components.
+     * @param message_filter Filter on the message, compiled here and evaluated on the worker threads.
+     * @param format Layout of the written lines, which must match the other callbacks of the same file.
+     * @return Handle to the callback, which can be used to unregister it.
+     * @throws std::invalid_argument If another callback writes the same file in another format.
+     */
+    uint32_t register_file_callback(const std::string& filename,
+                               const std::unordered_map<ComponentEnumEntry, Severity, ComponentEnumEntryHasher>& filter,
+                               const MessageFilter& message_filter, FileFormat format = FileFormat::Text);
+
+    /**
+     * @brief Registers a file callback with a minimum severity and a message content filter.
+     *
+     * @param filename The file to write logs to.
+     * @param min_severity Minimum severity for all components.
+     * @param message_filter Filter on the message, compiled here and evaluated on the worker threads.
+     * @param format Layout of the written lines, which must match the other callbacks of the same file.
+     * @return Handle to the callback, which can be used to unregister it.
+     * @throws std::invalid_argument If another callback writes the same file in another format.
+     */
+    uint32_t register_file_callback(const std::string& filename,
+                               Severity min_severity, const MessageFilter& message_filter,
+                               FileFormat format = FileFormat::Text);
+
+    /**
+     * @brief Registers a file callback with a component and severity filter and a custom line layout.
+     *
+     * @param filename The file to write logs to.
+     * @param filter Map of components to minimum severities for filtering, empty for all components.
+     * @param message_filter Filter on the message, compiled here and evaluated on the worker threads.
+     * @param formatter Renders the written lines, such as a PatternFormatter. Its layout must match the other callbacks of the same file.
+     * @return Handle to the callback, which can be used to unregister it.
+     * @throws std::invalid_argument If the formatter is null or another callback writes the same file with another layout.
+     */
+    uint32_t register_file_callback(const std::string& filename,
+                               const std::unordered_map<ComponentEnumEntry, Severity, ComponentEnumEntryHasher>& filter,
+                               const MessageFilter& message_filter, LogFormatterPtr formatter);
+
+    /**
+     * @brief Registers a file callback with a minimum severity and a custom line layout.
+     *
+     * @param filename The file to write logs to.
+     * @param min_severity Minimum severity for all components.
+     * @param message_filter Filter on the message, compiled here and evaluated on the worker threads.
+     * @param formatter Renders the written lines, such as a PatternFormatter. Its layout must match the other callbacks of the same file.
+     * @return Handle to the callback, which can be used to unregister it.
+     * @throws std::invalid_argument If the formatter is null or another callback writes the same file with another layout.
+     */
+    uint32_t register_file_callback(const std::string& filename,
+                               Severity min_severity, const MessageFilter& message_filter,
+                               LogFormatterPtr formatter);
+
+    /**
+     * @brief Registers a function callback for whole subtrees of the component hierarchy.
+     *
+     * @param callback The callback function to register.
+     * @param subtree_filter Subtree roots and their minimum severities.
+     * @return Handle to the callback, which can be used to unregister it.
+     */
+    uint32_t register_function_callback(const std::function<void(const LogEntry&)>& callback,
+                                   const ComponentSubtreeFilter& subtree_filter);
+
+    /**
+     * @brief Registers a function callback for whole subtrees of the component hierarchy and a message content filter.
+     *
+     * @param callback The callback function to register.
+     * @param subtree_filter Subtree roots and their minimum severities.
+     * @param message_filter Filter on the message, compiled here and evaluated on the worker threads.
+     * @return Handle to the callback, which can be used to unregister it.
+     */
+    uint32_t register_function_callback(const std::function<void(const LogEntry&)>& callback,
+                                   const ComponentSubtreeFilter& subtree_filter, const MessageFilter& message_filter);
+
+    /**
+     * @brief Registers a file callback for whole subtrees of the component hierarchy.
+     *
+     * @param filename The file to write logs to.
+     * @param subtree_filter Subtree roots and their minimum severities.
+     * @return Handle to the callback, which can be used to unregister it.
+     */
+    uint32_t register_file_callback(const std::string& filename,
+                               const ComponentSubtreeFilter& subtree_filter);
+
+    /**
+     * @brief Registers a file callback for whole subtrees of the component hierarchy and a message content filter.
+     *
+     * @param filename The file to write logs to.
+     * @param subtree_filter Subtree roots and their minimum severities.
+     * @param message_filter Filter on the message, compiled here and evaluated on the worker threads.
+     * @param format Layout of the written lines, which must match the other callbacks of the same file.
+     * @return Handle to the callback, which can be used to unregister it.
+     * @throws std::invalid_argument If another callback writes the same file in another format.
+     */
+    uint32_t register_file_callback(const std::string& filename,
+                               const ComponentSubtreeFilter& subtree_filter, const MessageFilter& message_filter,
+                               FileFormat format = FileFormat::Text);
+
+    /**
+     * @brief Registers a file callback for whole subtrees of the component hierarchy and a custom line layout.
+     *
+     * @param filename The file to write logs to.
+     * @param subtree_filter Subtree roots and their minimum severities.
+     * @param message_filter Filter on the message, compiled here and evaluated on the worker threads.
+     * @param formatter Renders the written lines, such as a PatternFormatter. Its layout must match the other callbacks of the same file.
+     * @return Handle to the callback, which can be used to unregister it.
+     * @throws std::invalid_argument If the filename is empty, the formatter is null or another callback writes the
+     * same file with another layout.
+     */
+    uint32_t register_file_callback(const std::string& filename,
+                               const ComponentSubtreeFilter& subtree_filter, const MessageFilter& message_filter,
+                               LogFormatterPtr formatter);
+
+    /**
+     * @brief Makes a component a child of another, so subtree filters of the parent also match it.
+     * Subtree filters are re-expanded here, keeping their per-entry matching a single lookup.
+     *
+     * @param component The child component.
+     * @param parent The parent component.
+     */
+    void set_component_parent(const ComponentEnumEntry& component, const ComponentEnumEntry& parent);
+
+    /**
+     * @brief Makes an enum component a child of another enum component.
+     *
+     * @tparam EnumT Enum type of the child.
+     * @tparam ParentEnumT Enum type of the parent.
+     * @param component The child component.
+     * @param parent The parent component.
+     */
+    template <typename EnumT, typename ParentEnumT>
+    void set_component_parent(EnumT component, ParentEnumT parent)
+    {
+        set_component_parent(make_component_entry(component), make_component_entry(parent));
+    }
+
     /**
      * @brief Registers a function callback for a specific enum component.
      *
@@ -181,6 +413,40 @@ public:
         log(severity, make_component_entry(component), message, file, line);
     }
 
+    /**
+     * @brief Logs a message with structured fields asynchronously for a specific enum component.
+     *
+     * @tparam EnumT Enum type.
+     * @param severity The severity level of the log.
+     * @param component The enum component generating the log.
+     * @param message The log message.
+     * @param fields The structured fields of the entry.
+     * @param file The source file where the log was generated.
+     * @param line The line number in the source file.
+     */
+    template <typename EnumT>
+    void log(Severity severity, EnumT component, const std::string& message, const LogFields& fields,
+             const std::string& file, uint32_t line)
+    {
+        log(severity, make_component_entry(component), message, fields, file, line);
+    }
+
+    /**
+     * @brief Logs a message for a component known at compile time, whose entry is built only once.
+     * With an enum declared by CALLBACK_LOGGER_STATIC_COMPONENT, filters match it by its constexpr component ID.
+     *
+     * @tparam Component The enum component generating the log.
+     * @param severity The severity level of the log.
+     * @param message The log message.
+     * @param file The source file where the log was generated.
+     * @param line The line number in the source file.
+     */
+    template <auto Component>
+    void log(Severity severity, const std::string& message, const std::string& file, uint32_t line)
+    {
+        log(severity, static_component_entry<Component>(), message, file, line);
+    }
+
     /**
      * @brief Registers a function callback for a set of enum components.
      *
@@ -259,7 +525,183 @@ public:
     void log(Severity severity, const ComponentEnumEntry& component, const std::string& message,
              const std::string& file, uint32_t line);
 
+    /**
+     * @brief Logs a message with structured fields asynchronously. The fields are copied once into the entry,
+     * which every callback then receives by reference. Fields LogFields cut short or dropped are counted in
+     * stats().truncated_fields.
+     *
+     * @param severity The severity level of the log.
+     * @param component The component generating the log.
+     * @param message The log message.
+     * @param fields The structured fields of the entry.
+     * @param file The source file where the log was generated.
+     * @param line The line number in the source file.
+     */
+    void log(Severity severity, const ComponentEnumEntry& component, const std::string& message,
+             const LogFields& fields, const std::string& file, uint32_t line);
+
+    /**
+     * @brief Delivers a complete entry, such as one received from another process, keeping its timestamp.
+     * The entry already went through its producer's sampling and rate limits, so they are not applied again.
+     *
+     * @param entry The log entry.
+     */
+    void log_entry(const LogEntry& entry);
+
+    /**
+     * @brief Takes a snapshot of the logger's counters.
+     *
+     * Counters are updated with relaxed atomics, so the snapshot is consistent per counter but not across counters.
+     *
+     * @return The current statistics of the logger and of each registered callback.
+     */
+    LoggerStatistics stats() const;
+
+    /**
+     * @brief Sets the handler that is notified when a callback throws.
+     *
+     * Reports are rate-limited per callback, see set_error_report_interval().
+     * Without a handler, reports are written to stderr. The handler runs on the thread of the failing callback,
+     * outside the logger's locks, so it may log through the logger.
+     *
+     * @param handler The handler to notify, or an empty function to restore the default report.
+     */
+    void set_error_handler(const CallbackErrorHandler& handler);
+
+    /**
+     * @brief Sets the minimal interval between two error reports of the same callback.
+     *
+     * Exceptions thrown within the interval are still counted, and the next report carries how many were suppressed.
+     *
+     * @param interval The minimal interval between reports.
+     */
+    void set_error_report_interval(std::chrono::milliseconds interval);
+
+    /**
+     * @brief Sets after how many consecutive exceptions a callback is disabled.
+     *
+     * A disabled callback stays registered but no longer receives entries.
+     *
+     * @param consecutive_failures Number of consecutive exceptions, 0 to never disable callbacks.
+     */
+    void set_callback_failure_threshold(uint32_t consecutive_failures);
+
+    /**
+     * @brief Sets the scheduling lane of a callback's tasks. With the shared queue scheduler, workers take tasks
+     * from higher lanes first, serving a waiting lower lane after LoggerOptions::lane_starvation_limit tasks
+     * were taken from higher lanes. The work-stealing scheduler ignores priorities.
+     *
+     * @param handle The handle of a function or file callback.
+     * @param priority The lane of the callback's tasks, Normal by default.
+     * @throws std::invalid_argument If the priority is not a lane.
+     * @throws std::runtime_error If no callback has this handle.
+     */
+    void set_callback_priority(uint32_t handle, CallbackPriority priority);
+
+    /**
+     * @brief Limits how fast each call site (file, line and component) may log, dropping the excess entries.
+     *
+     * Every call site owns a token bucket checked before its entry is built. The next admitted entry of a call site
+     * that had entries dropped is preceded by a "Last message repeated N times" entry. Counts of call sites that go
+     * quiet are reported the same way by flush() and shutdown(), but not by the destructor.
+     *
+     * @param entries_per_second Sustained number of entries per second of one call site, 0 to disable the limit.
+     * @param burst Number of entries a call site may log at once before being limited.
+     */
+    void set_call_site_rate_limit(double entries_per_second, uint32_t burst = 1);
+
+    /**
+     * @brief Keeps only a fraction of the entries of a severity, decided before the entry is built.
+     * Dropped entries are counted in LoggerStatistics::sampled_out_per_severity.
+     *
+     * @param severity The severity to sample.
+     * @param rate Fraction of the entries kept, between 0 and 1.
+     */
+    void set_sampling_rate(Severity severity, double rate);
+
+    /**
+     * @brief Keeps only a fraction of the entries of a component and severity, overriding the severity's rate.
+     *
+     * @param component The component to sample.
+     * @param severity The severity to sample.
+     * @param rate Fraction of the entries kept, between 0 and 1.
+     */
+    void set_sampling_rate(const ComponentEnumEntry& component, Severity severity, double rate);
+
+    /**
+     * @brief Keeps only a fraction of the entries of an enum component and severity.
+     *
+     * @tparam EnumT Enum type.
+     * @param component The enum component to sample.
+     * @param severity The severity to sample.
+     * @param rate Fraction of the entries kept, between 0 and 1.
+     */
+    template <typename EnumT>
+    void set_sampling_rate(EnumT component, Severity severity, double rate)
+    {
+        set_sampling_rate(make_component_entry(component), severity, rate);
+    }
+
+    /**
+     * @brief Derives the sampling decisions of the calling thread from a trace ID instead of a random generator,
+     * so all the entries of a trace are kept or dropped together, by every logger.
+     *
+     * @param trace_id The trace ID, 0 to go back to random sampling.
+     */
+    static void set_thread_trace_id(uint64_t trace_id);
+
 private:
+    /**
+     * @brief Validates the arguments of a log call.
+     *
+     * @param severity The severity level of the log.
+     * @param message The log message.
+     * @param file The source file where the log was generated.
+     * @param line The line number in the source file.
+     * @throws std::runtime_error If an argument is empty or invalid.
+     */
+    static void _validate_log_arguments(Severity severity, const std::string& message, const std::string& file, uint32_t line);
+
+    /**
+     * @brief Delivers a complete log entry to the matching callbacks.
+     *
+     * @param log_entry The entry, moved into the pooled entry shared by the callback tasks.
+     */
+    void _log_entry(LogEntry&& log_entry);
+
+    /**
+     * @brief Logs the "Last message repeated N times" entry of a rate limited call site.
+     *
+     * @param call_site The call site whose entries were dropped.
+     * @param suppressed_count Number of dropped entries.
+     */
+    void _log_repeated_entries(const RateLimitedCallSite& call_site, uint64_t suppressed_count);
+
+    /**
+     * @brief Logs the repeat entries of the call sites that had entries dropped and logged nothing since,
+     * so flush() and shutdown() deliver every pending count.
+     */
+    void _log_pending_repeats();
+
+    /**
+     * @brief Implements shutdown(deadline).
+     *
+     * @param deadline Time after which the queued tasks are dropped.
+     * @param is_logging_pending_repeats False from the destructor, whose callbacks may capture state already destroyed.
+     * @return The report of the first shutdown.
+     */
+    ShutdownReport _shutdown(std::chrono::steady_clock::time_point deadline, bool is_logging_pending_repeats);
+
+    /**
+     * @brief Hashes a call site into a rate limiter key.
+     *
+     * @param component The component generating the log.
+     * @param file The source file where the log was generated.
+     * @param line The line number in the source file.
+     * @return A non-zero key of the call site.
+     */
+    static uint64_t _call_site_key(const ComponentEnumEntry& component, const std::string& file, uint32_t line);
+
     /**
      * @brief Checks if a log entry matches a callback's filter.
      *
@@ -270,44 +712,564 @@ private:
      */
     bool _is_matching_callback_filter(
         const std::variant<std::unordered_map<ComponentEnumEntry, Severity, ComponentEnumEntryHasher>, Severity>& filter,
-        const Severity severity, const ComponentEnumEntry component) const;
+        const Severity severity, const ComponentEnumEntry& component) const;
+
+    /**
+     * @brief Checks if a log entry matches a callback, through its subtree filter if it has one.
+     *
+     * @tparam CallbackT FunctionCallbackFilter or FileCallBackFilter.
+     * @param callback The callback to check.
+     * @param severity The severity of the log entry.
+     * @param component The component of the log entry.
+     * @return True if the entry matches the callback, false otherwise.
+     */
+    template <typename CallbackT>
+    bool _is_matching_callback(const CallbackT& callback, Severity severity, const ComponentEnumEntry& component) const;
+
+    /**
+     * @brief Checks if a log entry matches a callback of the dispatch snapshot, without reading its shared pointers.
+     *
+     * @tparam CallbackT FunctionCallbackFilter or FileCallBackFilter.
+     * @param view The callback and its resolved subtree table.
+     * @param severity The severity of the log entry.
+     * @param component The component of the log entry.
+     * @return True if the entry matches the callback, false otherwise.
+     */
+    template <typename CallbackT>
+    bool _is_matching_callback_view(const CallbackView<CallbackT>& view, Severity severity,
+                                    const ComponentEnumEntry& component) const;
+
+    /**
+     * @brief Checks a log message against a callback's message filter, on the thread running the callback.
+     *
+     * @tparam CallbackT FunctionCallbackFilter or FileCallBackFilter.
+     * @param callback The callback to check.
+     * @param message The log message.
+     * @return True if the callback has no message filter or the message matches it.
+     */
+    template <typename CallbackT>
+    static bool _is_matching_message(const CallbackT& callback, const std::string& message);
+
+    /**
+     * @brief Compiles a message filter once, at registration.
+     *
+     * @param message_filter The filter to compile.
+     * @return The compiled matcher, or null if the filter accepts every message.
+     */
+    static std::shared_ptr<const MessageMatcher> _compile_message_filter(const MessageFilter& message_filter);
+
+    /**
+     * @brief Validates the roots of a subtree filter.
+     *
+     * @param subtree_filter The subtree filter.
+     * @param callback_kind Human readable kind of the registered callback, used in error messages.
+     * @throws std::invalid_argument If the filter has no root or a root has an invalid severity.
+     */
+    static void _validate_subtree_filter(const ComponentSubtreeFilter& subtree_filter, const char* callback_kind);
+
+    /**
+     * @brief Expands the subtree roots of a callback over the current component hierarchy.
+     * Must be called with m_register_mutex held.
+     *
+     * @tparam CallbackT FunctionCallbackFilter or FileCallBackFilter.
+     * @param callback The callback whose subtree filter is expanded.
+     */
+    template <typename CallbackT>
+    void _expand_subtree_filter(CallbackT& callback) const;
+
+    /**
+     * @brief Starts the worker threads, waiting until the work-stealing workers have allocated their queues.
+     *
+     * @param thread_count Number of workers to start.
+     */
+    void _start_workers(size_t thread_count);
+
+    /**
+     * @brief Runs before fork(): takes the locks of the queue, the registrations and the counters, so the child
+     * copies them in a consistent state. They are only held for short sections, forking never waits for a callback.
+     */
+    void _prepare_fork();
+
+    /**
+     * @brief Runs in the child after fork(), where only the forking thread exists. Drops the tasks queued in the
+     * parent, which delivers them, reopens the files of the file writers and starts new workers.
+     */
+    void _complete_fork_in_child();
+
+    /**
+     * @brief Releases the locks taken by _prepare_fork.
+     *
+     * @param is_child Whether the caller is the child of the fork.
+     */
+    void _unlock_after_fork(bool is_child);
 
     /**
      * @brief Worker thread function that processes log tasks from the queue.
      */
     void _worker_thread();
 
+    /**
+     * @brief Names the calling worker thread and applies the configured CPU affinity.
+     */
+    void _configure_worker_thread();
+
+    /**
+     * @brief Worker thread function of the work-stealing scheduler.
+     *
+     * @param worker_index Index of the worker's own queue in m_worker_queues.
+     */
+    void _work_stealing_worker_thread(size_t worker_index);
+
+    /**
+     * @brief Pops a task from the worker's own queue, or steals one from another worker.
+     *
+     * @param worker_index Index of the worker's own queue in m_worker_queues.
+     * @param task Receives the popped task.
+     * @return True if a task was popped, false if all queues were empty.
+     */
+    bool _try_pop_or_steal_task(size_t worker_index, Task& task);
+
+    /**
+     * @brief Hands tasks to the workers according to the scheduler mode.
+     *
+     * @param tasks The tasks to enqueue by priority lane, moved from.
+     */
+    void _enqueue_tasks(LaneTasks& tasks);
+
+    /**
+     * @brief Hands a callback task to the scheduler, through the callback's serial executor when sink order is preserved.
+     *
+     * @param callback The callback the task invokes.
+     * @param task The task to schedule.
+     * @param priority The lane of the task, or of the drain task it needs.
+     * @param tasks Receives the tasks to enqueue on the worker pool.
+     */
+    template <typename CallbackPtrT>
+    void _schedule_callback_task(const CallbackPtrT& callback, Task task, CallbackPriority priority, LaneTasks& tasks);
+
+    /**
+     * @brief Creates a pool task that drains a serial executor, rescheduling itself while tasks remain.
+     *
+     * @param executor The executor to drain.
+     * @param priority The lane the drain task is rescheduled in.
+     * @return The drain task.
+     */
+    Task _make_drain_task(const std::shared_ptr<SerialExecutor>& executor, CallbackPriority priority);
+
+    /**
+     * @brief Gets the lane of an entry's task for a callback.
+     *
+     * @param callback_priority The priority of the callback.
+     * @param severity The severity of the entry.
+     * @return The callback's lane, or the High lane for entries at or above the high priority severity.
+     */
+    CallbackPriority _task_priority(CallbackPriority callback_priority, Severity severity) const;
+
+    /**
+     * @brief Takes the next task from the shared queue lanes. Must be called with m_queue_mutex held and a task queued.
+     *
+     * @return The task, whose wait is accounted in its lane's statistics.
+     */
+    Task _pop_shared_queue_task();
+
+    /**
+     * @brief Gets the enqueue time of the oldest task of the shared queue. Must be called with m_queue_mutex held
+     * and a task queued.
+     *
+     * @return The enqueue time of the oldest task of all lanes.
+     */
+    std::chrono::steady_clock::time_point _oldest_queued_task_time() const;
+
+    /**
+     * @brief Counts the tasks of a log entry as undelivered in the slot of the current flush generation.
+     * One task is reserved before the entry's tasks are built, so a flush that started before cannot miss them.
+     *
+     * @return The generation slot, holding one reserved task.
+     */
+    size_t _reserve_undelivered_task();
+
+    /**
+     * @brief Counts delivered tasks, waking the flushes waiting for their generation.
+     *
+     * @param generation_slot The slot the tasks were counted in.
+     * @param count Number of delivered tasks.
+     */
+    void _complete_undelivered_tasks(size_t generation_slot, uint64_t count);
+
+    /**
+     * @brief Waits until the tasks submitted before the call were delivered. Flushes advance the flush generation
+     * one at a time, each one waiting for the slot of the generation it closes to empty.
+     *
+     * @param deadline Time after which the wait gives up, time_point::max() to wait without deadline.
+     * @return True if the tasks were delivered before the deadline.
+     */
+    bool _wait_for_delivered_tasks(std::chrono::steady_clock::time_point deadline);
+
+    /**
+     * @brief Waits on the flush condition until a predicate holds or a deadline passes.
+     *
+     * @param lock Lock of m_flush_mutex, held by the caller.
+     * @param deadline Time after which the wait gives up, time_point::max() to wait without deadline.
+     * @param predicate The condition waited for.
+     * @return True if the predicate holds.
+     */
+    template <typename Predicate>
+    bool _wait_for_flush_condition(std::unique_lock<std::mutex>& lock, std::chrono::steady_clock::time_point deadline,
+                                   Predicate predicate);
+
+    /**
+     * @brief Checks whether the adaptive pool should grow. Must be called with m_queue_mutex held.
+     *
+     * @param now The current time.
+     * @return True if the queue is deep or old enough, no worker is idle and the pool is below its maximal size.
+     */
+    bool _should_grow_pool(std::chrono::steady_clock::time_point now) const;
+
+    /**
+     * @brief Starts one more shared queue worker, taking the thread objects of the workers that retired.
+     * Must be called with m_queue_mutex held.
+     *
+     * @param retired_workers Receives the retired workers, for the caller to join after unlocking.
+     */
+    void _spawn_worker(std::vector<std::thread>& retired_workers);
+
+    /**
+     * @brief Reports a pool size change to the pool resize handler, if any.
+     *
+     * @param previous_thread_count The pool size before the change.
+     * @param thread_count The pool size after the change.
+     */
+    void _report_pool_resize(size_t previous_thread_count, size_t thread_count);
+
+    /**
+     * @brief Joins the workers once they exited. Past the deadline, the workers still running a callback are
+     * left running.
+     *
+     * @param deadline Time after which the workers inside a callback are no longer waited for.
+     * @return The number of workers left running.
+     */
+    size_t _join_workers(std::chrono::steady_clock::time_point deadline);
+
+    /**
+     * @brief Records that the calling worker stops. Must be called with m_queue_mutex held.
+     */
+    void _mark_worker_exited();
+
+    /**
+     * @brief Runs a task on the calling worker, accounting its busy time.
+     *
+     * @param task The task to run.
+     */
+    void _run_task(Task& task);
+
     /**
      * @brief Asynchronous log implementation (enqueues tasks).
      *
-     * @param entry The log entry to process.
+     * @param entry The pooled log entry to process, shared by all the tasks it produces.
      */
-    void _async_log(const LogEntry& entry);
+    void _async_log(const LogEntryPtr& entry);
 
     /**
-     * @brief Single-threaded log implementation (directly executes callbacks).
+     * @brief Single-threaded log implementation (directly executes callbacks). Reads the published callback
+     * snapshot while pinned, so it takes no lock and is safe while other threads register and unregister.
      *
      * @param entry The log entry to process.
      */
     void _single_threaded_log(const LogEntry& entry);
 
+    /**
+     * @brief Adds a file callback to the sink of its canonical path, creating the sink and its writer
+     * for the first callback of the path. Must be called with m_register_mutex held.
+     *
+     * @param callback The file callback, with its handle.
+     */
+    void _add_file_callback(const FileCallbackFilterPtr& callback);
+
+    /**
+     * @brief Removes a file callback from its sink. Must be called with m_register_mutex held.
+     *
+     * @param callback The file callback.
+     * @return The sink if this was its last callback, so the caller can release it after unlocking.
+     */
+    FileSinkPtr _remove_file_callback(const FileCallbackFilterPtr& callback);
+
+    /**
+     * @brief Checks if any enabled callback of a file sink accepts an entry's severity and component.
+     *
+     * @param callbacks The callbacks of the sink.
+     * @param severity The severity of the log entry.
+     * @param component The component of the log entry.
+     * @param is_delivery_certain Set if a matching callback has no message filter, so the sink writes the entry
+     * whatever its message. Left unchanged otherwise.
+     * @return True if the sink has a matching callback.
+     */
+    bool _is_matching_file_sink(const std::vector<FileCallbackFilterPtr>& callbacks, Severity severity,
+                                const ComponentEnumEntry& component, bool& is_delivery_certain) const;
+
+    /**
+     * @brief Counts a callback task whose message filter rejected the entry, on the thread running the callback.
+     *
+     * @param pending_rejections Rejections left before the entry reached no callback at all, shared by the tasks
+     * of the entry, or null if another callback receives the entry anyway.
+     */
+    void _count_message_rejection(std::atomic<size_t>* pending_rejections);
+
+    /**
+     * @brief Writes a log entry to a file sink once, through the first of its callbacks that accepts it.
+     *
+     * @param sink The file sink.
+     * @param callbacks The callbacks of the sink.
+     * @param entry The log entry to write.
+     * @return True if a callback accepted the entry.
+     */
+    bool _write_file_sink_entry(FileSink& sink, const std::vector<FileCallbackFilterPtr>& callbacks,
+                                const LogEntry& entry);
+
+    /**
+     * @brief Renders a log entry and writes it to a file sink, on behalf of one of its callbacks.
+     *
+     * @param sink The file sink.
+     * @param callback The callback credited with the invocation.
+     * @param entry The log entry to write.
+     */
+    void _write_file_line(FileSink& sink, FileCallBackFilter& callback, const LogEntry& entry);
+
+    /**
+     * @brief Publishes a new dispatch snapshot of the registered callbacks for the single-threaded logger, and
+     * frees the previous snapshots no producer reads anymore. Must be called with m_register_mutex held.
+     */
+    void _publish_callback_snapshot();
+
+    /**
+     * @brief Adds a callback to a dispatch snapshot being built, keeping it and its subtree table alive.
+     *
+     * @tparam CallbackT FunctionCallbackFilter or FileCallBackFilter.
+     * @param callback The callback.
+     * @param snapshot The snapshot owning the callback.
+     * @return The view of the callback.
+     */
+    template <typename CallbackT>
+    static CallbackView<CallbackT> _make_callback_view(const std::shared_ptr<CallbackT>& callback, CallbackSnapshot& snapshot);
+
+    /**
+     * @brief Waits until the entries handed to the file writers have reached their files.
+     */
+    void _flush_file_writers();
+
+    /**
+     * @brief Counts a log entry in the per-severity and per-component counters.
+     *
+     * @param entry The log entry being logged.
+     */
+    void _count_logged_entry(const LogEntry& entry);
+
+    /**
+     * @brief Finds the counter of a component, creating it for the first entry of the component.
+     *
+     * @param component The component of the log entry.
+     * @return The counter, which lives as long as the logger.
+     */
+    PaddedCounter& _find_or_add_component_counter(const ComponentEnumEntry& component);
+
+    /**
+     * @brief Runs a single callback invocation, timing it and accounting anything it throws.
+     *
+     * @param callback The invoked callback.
+     * @param callback_kind Human readable kind of the callback, used in error reports.
+     * @param invocation The invocation to run.
+     */
+    template <typename CallbackT, typename Invocation>
+    void _run_callback(CallbackT& callback, const char* callback_kind, Invocation&& invocation);
+
+    /**
+     * @brief Accounts an exception thrown by a callback, reporting it if the callback's report interval elapsed.
+     *
+     * @param handle The handle of the callback that threw.
+     * @param counters The counters of the callback that threw.
+     * @param callback_kind Human readable kind of the callback.
+     * @param message Description of the exception.
+     */
+    void _handle_callback_exception(uint32_t handle, CallbackCounters& counters, const char* callback_kind,
+                                    const char* message);
+
     std::unordered_map<uint32_t, FunctionCallbackFilterPtr> m_function_callbacks;
     std::unordered_map<uint32_t, FileCallbackFilterPtr> m_file_callbacks;
+    // File sinks by canonical path
+    std::unordered_map<std::string, FileSinkPtr> m_file_sinks;
     std::atomic<uint32_t> m_next_callback_handle{1};
     mutable std::mutex m_register_mutex;
+    ComponentParentMap m_component_parents;
 
     bool m_single_threaded{false};
+    SchedulerMode m_scheduler_mode{SchedulerMode::SharedQueue};
+    SinkOrdering m_sink_ordering{SinkOrdering::Unordered};
 
-    std::queue<std::function<void()>> m_task_queue;
+    /**
+     * @brief Queue owned by a single worker in the work-stealing scheduler.
+     */
+    struct alignas(CACHE_LINE_SIZE) WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    /**
+     * @brief A task waiting in the shared queue, with the time it was enqueued at.
+     */
+    struct QueuedTask
+    {
+        Task task;
+        std::chrono::steady_clock::time_point enqueued_at;
+    };
+
+    /**
+     * @brief A priority lane of the shared queue, with the statistics of its tasks. Guarded by m_queue_mutex.
+     */
+    struct TaskLane
+    {
+        std::queue<QueuedTask> tasks;
+        // Tasks taken from higher lanes while this one was waiting
+        size_t skipped_count{0};
+        uint64_t dequeued_count{0};
+        std::array<uint64_t, LATENCY_HISTOGRAM_BUCKET_COUNT> wait_histogram{};
+    };
+
+    std::array<TaskLane, static_cast<size_t>(CallbackPriority::PRIORITY_COUNT)> m_task_lanes;
+    size_t m_queued_task_count{0};
+    std::optional<Severity> m_high_priority_min_severity;
+    size_t m_lane_starvation_limit{0};
     std::vector<std::thread> m_workers;
-    std::mutex m_queue_mutex;
+    mutable std::mutex m_queue_mutex;
     std::condition_variable m_queue_condition;
     std::atomic<bool> m_stopping{false};
+    // Set when a shutdown deadline passed, workers then drop the tasks they take instead of running them
+    std::atomic<bool> m_is_discarding{false};
+    // Guarded by m_queue_mutex, set by the first shutdown when it starts and when it completes
+    bool m_is_shutting_down{false};
+    bool m_is_shut_down{false};
+    ShutdownReport m_shutdown_report;
+    // Guarded by m_queue_mutex, the workers that returned after the logger stopped
+    std::vector<std::thread::id> m_exited_workers;
+    std::atomic<size_t> m_running_task_count{0};
+
+    // Undelivered callback tasks, counted in the slot of the flush generation they were submitted in
+    std::atomic<uint64_t> m_flush_generation{0};
+    std::array<PaddedCounter, 2> m_undelivered_tasks;
+    std::mutex m_flush_mutex;
+    std::condition_variable m_flush_condition;
+    // Guarded by m_flush_mutex, set while a flush advances the generation and waits for its slot
+    bool m_is_flush_advancing{false};
+    std::atomic<uint32_t> m_flush_waiter_count{0};
+
+    size_t m_min_workers{0};
+    size_t m_max_workers{0};
+    size_t m_live_workers{0};
+    size_t m_idle_workers{0};
+    size_t m_scale_up_queue_depth{0};
+    std::chrono::steady_clock::duration m_scale_up_queue_latency{};
+    std::chrono::milliseconds m_idle_thread_timeout{};
+    PoolResizeHandler m_pool_resize_handler;
+    std::vector<std::thread::id> m_retired_workers;
+
+    std::vector<size_t> m_worker_cpu_set;
+    std::string m_worker_thread_name_prefix;
+    std::atomic<size_t> m_next_worker_number{0};
+    FileWriterOptions m_file_writer_options;
+
+    std::vector<std::unique_ptr<WorkerQueue>> m_worker_queues;
+    size_t m_ready_worker_queues{0};
+    std::atomic<size_t> m_pending_tasks{0};
+    std::atomic<size_t> m_sleeping_workers{0};
+
+    std::array<PaddedCounter, static_cast<size_t>(Severity::SEVERITY_COUNT)> m_logged_per_severity;
+    // Counters are never removed, so the threads cache pointers to them, see _count_logged_entry
+    std::unordered_map<ComponentEnumEntry, std::unique_ptr<PaddedCounter>, ComponentEnumEntryHasher> m_logged_per_component;
+    mutable std::mutex m_component_counters_mutex;
+    // Unique per logger, unlike its address, so thread caches of a destroyed logger are never used by a new one
+    const uint64_t m_logger_id;
+    PaddedCounter m_filtered_out;
+    PaddedCounter m_message_filter_rejections;
+    PaddedCounter m_rate_limited;
+    PaddedCounter m_truncated_fields;
+    CallSiteRateLimiter m_call_site_rate_limiter;
+    LogSampler m_sampler;
+    std::array<PaddedCounter, static_cast<size_t>(Severity::SEVERITY_COUNT)> m_sampled_out_per_severity;
+    // Inline dispatch of the single-threaded logger: producers pin m_callback_epochs and read the published snapshot
+    EpochDomain m_callback_epochs;
+    std::unique_ptr<CallbackSnapshot> m_callback_snapshot_owner;
+    std::atomic<const CallbackSnapshot*> m_callback_snapshot{nullptr};
+    std::unique_ptr<FlightRecorder> m_flight_recorder_owner;
+    std::atomic<FlightRecorder*> m_flight_recorder{nullptr};
+    FlightRecorderOptions m_flight_recorder_options;
+    PaddedCounter m_tasks_enqueued;
+    PaddedCounter m_peak_queue_depth;
+    PaddedCounter m_worker_busy_time_ns;
+    PaddedCounter m_unpinned_workers;
+
+    CallbackErrorHandler m_error_handler;
+    std::mutex m_error_handler_mutex;
+    std::atomic<int64_t> m_error_report_interval_ns{
+        std::chrono::duration_cast<std::chrono::nanoseconds>(DEFAULT_ERROR_REPORT_INTERVAL).count()};
+    std::atomic<uint32_t> m_callback_failure_threshold{0};
+
+    // Locks taken by _prepare_fork, released in the parent and in the child once the fork completed
+    std::vector<std::unique_lock<std::mutex>> m_fork_locks;
+    // Null when the logger is not fork safe
+    std::unique_ptr<ForkHandlerRegistration> m_fork_registration;
 
     constexpr static size_t DEFAULT_THREAD_COUNT = 1;
+    constexpr static size_t SERIAL_EXECUTOR_DRAIN_BATCH_SIZE = 64;
+    constexpr static size_t MAX_CACHED_COUNTER_LOGGERS = 16;
+    constexpr static std::chrono::milliseconds DEFAULT_ERROR_REPORT_INTERVAL{1000};
+    // Past a shutdown deadline, how often the workers leaving a callback are checked for, as they do not notify
+    constexpr static std::chrono::milliseconds STUCK_WORKER_POLL_INTERVAL{1};
 };
 
 #define LOG(logger, severity, component, message) \
     logger.log(severity, component, message, __FILE__, __LINE__)
 
+// The fields are LogField initializers, such as LOG_FIELDS(logger, Severity::Info, component, "done", {"latency_ms", 3.5})
+#define LOG_FIELDS(logger, severity, component, message, ...) \
+    logger.log(severity, component, message, LogFields{__VA_ARGS__}, __FILE__, __LINE__)
+
+// Lowest severity compiled in by the LOG_<SEVERITY> macros, matching the Severity values (0 = Debug ... 4 = Fatal).
+// Set through the CALLBACK_LOGGER_MIN_SEVERITY CMake option, or defined before including the logger.
+#ifndef CALLBACK_LOGGER_MIN_SEVERITY
+#define CALLBACK_LOGGER_MIN_SEVERITY 0
+#endif
+
+// A stripped statement is still type-checked but never evaluated, so its arguments cost nothing at runtime
+#define CALLBACK_LOGGER_STRIPPED_LOG(logger, severity, component, message) \
+    do { if (false) { LOG(logger, severity, component, message); } } while (false)
+
+#if CALLBACK_LOGGER_MIN_SEVERITY <= 0
+#define LOG_DEBUG(logger, component, message) LOG(logger, Severity::Debug, component, message)
+#else
+#define LOG_DEBUG(logger, component, message) CALLBACK_LOGGER_STRIPPED_LOG(logger, Severity::Debug, component, message)
+#endif
+
+#if CALLBACK_LOGGER_MIN_SEVERITY <= 1
+#define LOG_INFO(logger, component, message) LOG(logger, Severity::Info, component, message)
+#else
+#define LOG_INFO(logger, component, message) CALLBACK_LOGGER_STRIPPED_LOG(logger, Severity::Info, component, message)
+#endif
+
+#if CALLBACK_LOGGER_MIN_SEVERITY <= 2
+#define LOG_WARNING(logger, component, message) LOG(logger, Severity::Warning, component, message)
+#else
+#define LOG_WARNING(logger, component, message) CALLBACK_LOGGER_STRIPPED_LOG(logger, Severity::Warning, component, message)
+#endif
+
+#if CALLBACK_LOGGER_MIN_SEVERITY <= 3
+#define LOG_ERROR(logger, component, message) LOG(logger, Severity::Error, component, message)
+#else
+#define LOG_ERROR(logger, component, message) CALLBACK_LOGGER_STRIPPED_LOG(logger, Severity::Error, component, message)
+#endif
+
+#if CALLBACK_LOGGER_MIN_SEVERITY <= 4
+#define LOG_FATAL(logger, component, message) LOG(logger, Severity::Fatal, component, message)
+#else
+#define LOG_FATAL(logger, component, message) CALLBACK_LOGGER_STRIPPED_LOG(logger, Severity::Fatal, component, message)
+#endif
+
 using CallbackLoggerPtr = std::shared_ptr<CallbackLogger>;
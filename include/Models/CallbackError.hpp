@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <functional>
+
+/**
+ * @brief Describes an exception thrown by a registered callback, as reported to the error handler.
+ */
+struct CallbackError
+{
+    uint32_t handle;
+    std::string callback_kind;
+    std::string message;
+    uint64_t exception_count;
+    uint64_t suppressed_count;
+    bool is_disabled;
+};
+
+using CallbackErrorHandler = std::function<void(const CallbackError&)>;
@@ -1,13 +1,22 @@
 #pragma once
 
 #include <string>
+#include <atomic>
 #include <unordered_map>
 #include <memory>
+#include <mutex>
 #include <variant>
+#include <vector>
 
 #include "ComponentEnumEntry.hpp"
 #include "Severity.hpp"
+#include "CallbackPriority.hpp"
 #include "Models/LogEntry.hpp"
+#include "Utils/LoggerCounters.hpp"
+#include "Utils/SerialExecutor.hpp"
+#include "Utils/MessageMatcher.hpp"
+#include "Utils/FileWriter.hpp"
+#include "Utils/LogFormatter.hpp"
 
 using LogCallback = std::function<void(const LogEntry&)>;
 
@@ -21,9 +30,37 @@ struct FileCallBackFilter
         std::unordered_map<ComponentEnumEntry, Severity, ComponentEnumEntryHasher>,
         Severity
     > filter;
+    uint32_t handle;
+    CallbackCounters counters;
+    // Roots of a subtree filter, which replaces `filter`. Their expansion is swapped atomically when the hierarchy changes.
+    std::unordered_map<ComponentEnumEntry, Severity, ComponentEnumEntryHasher> subtree_roots;
+    std::shared_ptr<const std::unordered_map<ComponentEnumEntry, Severity, ComponentEnumEntryHasher>> subtree_filter;
+    // Null when the callback has no message filter
+    std::shared_ptr<const MessageMatcher> message_matcher;
+    LogFormatterPtr formatter;
+    std::atomic<CallbackPriority> priority{CallbackPriority::Normal};
 };
 using FileCallbackFilterPtr = std::shared_ptr<FileCallBackFilter>;
 
+/**
+ * @brief A file shared by all the file callbacks registered on the same canonical path.
+ * An entry matching any of their filters is written once.
+ */
+struct FileSink
+{
+    std::string file_path;
+    // Every callback of the file renders its entries with the same layout
+    LogFormatterPtr formatter;
+    // Null with FileWriterBackend::OpenPerEntry, where open_mutex serializes the writes instead
+    std::shared_ptr<FileWriter> writer;
+    std::mutex open_mutex;
+    SerialExecutor executor;
+    // Replaced rather than modified, under the logger's register mutex, so tasks keep the list they were built with
+    std::shared_ptr<const std::vector<FileCallbackFilterPtr>> callbacks;
+};
+using FileSinkCallbacksPtr = std::shared_ptr<const std::vector<FileCallbackFilterPtr>>;
+using FileSinkPtr = std::shared_ptr<FileSink>;
+
 /**
  * @brief Holds a function callback and its filter.
  */
@@ -34,6 +71,47 @@ struct FunctionCallbackFilter
         std::unordered_map<ComponentEnumEntry, Severity, ComponentEnumEntryHasher>,
         Severity
     > filter;
+    uint32_t handle;
+    CallbackCounters counters;
+    SerialExecutor executor;
+    // Roots of a subtree filter, which replaces `filter`. Their expansion is swapped atomically when the hierarchy changes.
+    std::unordered_map<ComponentEnumEntry, Severity, ComponentEnumEntryHasher> subtree_roots;
+    std::shared_ptr<const std::unordered_map<ComponentEnumEntry, Severity, ComponentEnumEntryHasher>> subtree_filter;
+    // Null when the callback has no message filter
+    std::shared_ptr<const MessageMatcher> message_matcher;
+    std::atomic<CallbackPriority> priority{CallbackPriority::Normal};
 };
 using FunctionCallbackFilterPtr = std::shared_ptr<FunctionCallbackFilter>;
 
+
+/**
+ * @brief A callback as read by the inline dispatch, with its subtree table resolved when the snapshot was built.
+ */
+template <typename CallbackT>
+struct CallbackView
+{
+    CallbackT* callback;
+    // Null when the callback has no subtree filter
+    const std::unordered_map<ComponentEnumEntry, Severity, ComponentEnumEntryHasher>* subtree_filter;
+};
+
+/**
+ * @brief A file sink as read by the inline dispatch, with the callbacks sharing it.
+ */
+struct FileSinkView
+{
+    FileSink* sink;
+    std::vector<CallbackView<FileCallBackFilter>> callbacks;
+};
+
+/**
+ * @brief Immutable copy of the registered callbacks, read by the inline dispatch of a single-threaded logger
+ * through plain pointers. A registration publishes a new snapshot, and the owners keep every callback, sink and
+ * subtree table of this one alive until no producer reads it anymore.
+ */
+struct CallbackSnapshot
+{
+    std::vector<FileSinkView> file_sinks;
+    std::vector<CallbackView<FunctionCallbackFilter>> function_callbacks;
+    std::vector<std::shared_ptr<const void>> owners;
+};
@@ -0,0 +1,12 @@
+#pragma once
+
+/**
+ * @brief Scheduling lane of the tasks of a callback. Workers take tasks from higher lanes first.
+ */
+enum class CallbackPriority
+{
+    Low = 0,
+    Normal,
+    High,
+    PRIORITY_COUNT
+};
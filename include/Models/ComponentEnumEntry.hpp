@@ -3,6 +3,7 @@
 #include <variant>
 #include <typeindex>
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <cstdint>
 #include <functional>
@@ -11,6 +12,7 @@ class ComponentEnumEntry {
 public:
     ComponentEnumEntry();
     ComponentEnumEntry(const std::variant<std::type_index, std::string>& type, uint32_t enum_value);
+    ComponentEnumEntry(const std::variant<std::type_index, std::string>& type, uint32_t enum_value, uint64_t static_id);
 
     ComponentEnumEntry(const ComponentEnumEntry& other);
     ComponentEnumEntry& operator=(const ComponentEnumEntry& other);
@@ -44,15 +46,28 @@ public:
     uint32_t get_enum_value() const;
 
     /**
-     * @brief Equality operator.
+     * @brief Gets the compile-time component ID of entries of statically declared enums.
+     *
+     * @return The static ID, or 0 if the enum was not declared with CALLBACK_LOGGER_STATIC_COMPONENT.
+     */
+    uint64_t get_static_id() const;
+
+    /**
+     * @brief Equality operator. Entries compare by static ID only as soon as either carries one, so an entry with
+     * a static ID never equals one without.
      *
      * @param other The other ComponentEnumEntry to compare.
      * @return True if equal, false otherwise.
      */
-    bool operator==(const ComponentEnumEntry& other) const;
+    bool operator==(const ComponentEnumEntry& other) const
+    {
+        if (static_id != 0 || other.static_id != 0)
+            return static_id == other.static_id;
+        return (other.type == type) && (other.enum_value == enum_value);
+    }
 
     /**
-     * @brief Less-than operator.
+     * @brief Less-than operator, ordering entries by static ID as soon as either carries one, like operator==.
      *
      * @param other The other ComponentEnumEntry to compare.
      * @return True if this is less than other.
@@ -90,9 +105,26 @@ public:
      */
     std::string to_string() const;
 
+    /**
+     * @brief Gets the string representation of the entry, built the first time the component is seen and then
+     * shared by every entry of the component. Each thread looks names up in its own cache, so rendering a known
+     * component takes no lock and no allocation.
+     *
+     * @return The name, "Type#value", valid until the program exits.
+     */
+    std::string_view name() const;
+
 private:
+    /**
+     * @brief Builds the string representation of the entry, stripping the length prefix of mangled type names.
+     *
+     * @return String representation of the entry.
+     */
+    std::string _build_name() const;
+
     std::variant<std::type_index, std::string> type;
     uint32_t enum_value;
+    uint64_t static_id;
 
     friend struct ComponentEnumEntryHasher;
 };
@@ -104,6 +136,14 @@ struct ComponentEnumEntryHasher
 {
     std::size_t operator()(const ComponentEnumEntry& entry) const
     {
+        if (entry.static_id != 0)
+            return std::hash<uint64_t>()(entry.static_id);
         return std::hash<std::variant<std::type_index, std::string>>()(entry.type) ^ std::hash<uint32_t>()(entry.enum_value);
     }
 };
+
+/**
+ * @brief Makes the component names usable in the child of a fork(), which then starts a new name table.
+ * Called once a logger is built with LoggerOptions::fork_safe, later calls do nothing.
+ */
+void enable_fork_safe_component_names();
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <type_traits>
+#include <unordered_map>
+
+#include "Models/ComponentEnumEntry.hpp"
+#include "Models/Severity.hpp"
+#include "Utils/ComponentEnumEntryUtils.hpp"
+
+/**
+ * @brief Filter matching whole subtrees of the component hierarchy built with CallbackLogger::set_component_parent.
+ * Each root matches itself and all its descendants from its minimum severity, the nearest root of a component wins.
+ */
+struct ComponentSubtreeFilter
+{
+    std::unordered_map<ComponentEnumEntry, Severity, ComponentEnumEntryHasher> roots;
+
+    ComponentSubtreeFilter() = default;
+
+    explicit ComponentSubtreeFilter(const std::unordered_map<ComponentEnumEntry, Severity, ComponentEnumEntryHasher>& roots)
+        : roots(roots) {}
+
+    ComponentSubtreeFilter(const ComponentEnumEntry& root, Severity min_severity = Severity::Debug)
+        : roots{{root, min_severity}} {}
+
+    template <typename EnumT, typename = std::enable_if_t<std::is_enum<EnumT>::value>>
+    ComponentSubtreeFilter(EnumT root, Severity min_severity = Severity::Debug)
+        : roots{{make_component_entry(root), min_severity}} {}
+};
@@ -0,0 +1,10 @@
+#pragma once
+
+/**
+ * @brief Layout of the lines file callbacks write.
+ */
+enum class FileFormat
+{
+    Text,      // "[*] [timestamp] [Severity] Component (file:line): message key=value..."
+    JsonLines  // One JSON object per line, with the fields in a nested "fields" object
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Severity.hpp"
+
+/**
+ * @brief How file callbacks write their entries.
+ */
+enum class FileWriterBackend
+{
+    OpenPerEntry,   // The file is opened, appended to and closed for every entry
+    BufferedStream, // Each file callback keeps a buffered std::ofstream open
+    IoUring         // Writes are submitted to an io_uring without waiting, falls back to BufferedStream without io_uring
+};
+
+/**
+ * @brief When buffered file writers force their entries to the disk.
+ */
+enum class FsyncPolicy
+{
+    Never,      // Left to the operating system
+    OnSeverity, // After each entry at or above FileWriterOptions::fsync_min_severity
+    Always      // After each entry
+};
+
+/**
+ * @brief Options of the writers of file callbacks, shared by every file callback of a logger.
+ */
+struct FileWriterOptions
+{
+    FileWriterBackend backend{FileWriterBackend::OpenPerEntry};
+    FsyncPolicy fsync_policy{FsyncPolicy::Never};
+    Severity fsync_min_severity{Severity::Error};
+    // Entries are coalesced into one write while the previous io_uring write is in flight, up to this many bytes
+    size_t max_buffered_bytes{64 * 1024};
+};
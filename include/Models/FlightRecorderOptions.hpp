@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Options of a logger's in-memory flight recorder.
+ */
+struct FlightRecorderOptions
+{
+    // File the recorder is dumped to, overwritten by every dump
+    std::string dump_path;
+    // Most recent entries kept per logging thread
+    size_t records_per_thread{1024};
+    bool dump_on_fatal{true};
+    bool dump_on_shutdown{true};
+    // Installs SIGSEGV and SIGABRT handlers that dump the recorder before the process dies
+    bool install_crash_handler{false};
+};
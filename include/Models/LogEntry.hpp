@@ -1,8 +1,10 @@
 #pragma once
 #include <string>
 #include <cstdint>
+#include <memory>
 #include "Severity.hpp"
 #include "ComponentEnumEntry.hpp"
+#include "LogFields.hpp"
 
 struct LogEntry
 {
@@ -12,4 +14,6 @@ struct LogEntry
     std::string file;
     uint32_t line;
     std::string timestamp;
+    LogFields fields;
 };
+using LogEntryPtr = std::shared_ptr<const LogEntry>;
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * @brief Type of the value of a structured log field.
+ */
+enum class LogFieldType : uint8_t
+{
+    Int,
+    Double,
+    String
+};
+
+/**
+ * @brief A typed key-value attribute of a log entry. Its key and string value are views, valid as long as
+ * the strings passed to log() or the LogFields it was read from.
+ */
+struct LogField
+{
+    template <typename IntT, typename std::enable_if<std::is_integral<IntT>::value, int>::type = 0>
+    LogField(std::string_view key, IntT value)
+        : key(key), type(LogFieldType::Int), int_value(static_cast<int64_t>(value)) {}
+
+    LogField(std::string_view key, double value)
+        : key(key), type(LogFieldType::Double), double_value(value) {}
+
+    LogField(std::string_view key, std::string_view value)
+        : key(key), type(LogFieldType::String), string_value(value) {}
+
+    LogField(std::string_view key, const char* value)
+        : key(key), type(LogFieldType::String), string_value(value) {}
+
+    std::string_view key;
+    LogFieldType type;
+    int64_t int_value{0};
+    double double_value{0.0};
+    std::string_view string_value;
+};
+
+/**
+ * @brief Structured fields of a log entry, stored in a fixed-size block allocated with the first field, so entries
+ * without fields carry no block at all. Keys and string values are copied into the block's text area and referred
+ * to by offset, so a copied LogFields stays self-contained. Callbacks receive it by reference as part of the shared
+ * LogEntry. Fields beyond the block's capacity are cut short or dropped rather than failing the log call.
+ */
+class LogFields
+{
+public:
+    static constexpr size_t MAX_FIELD_COUNT = 8;
+    static constexpr size_t TEXT_CAPACITY = 120;
+
+    LogFields() = default;
+
+    /**
+     * @brief Copies fields into the inline block.
+     *
+     * @param fields The fields, whose keys must be unique.
+     * @throws std::invalid_argument If a key is empty or duplicated.
+     */
+    LogFields(std::initializer_list<LogField> fields);
+
+    LogFields(const LogFields& other);
+    LogFields& operator=(const LogFields& other);
+    LogFields(LogFields&& other) noexcept = default;
+    LogFields& operator=(LogFields&& other) noexcept = default;
+
+    /**
+     * @brief Copies a field into the block. A string value that does not fit the text left is cut at a UTF-8
+     * character boundary, a field whose key does not fit or that exceeds MAX_FIELD_COUNT is dropped.
+     *
+     * @param field The field to add.
+     * @return True if the field was added whole, false if it was cut short or dropped.
+     * @throws std::invalid_argument If its key is empty or already used.
+     */
+    bool add(const LogField& field);
+
+    size_t size() const { return m_count; }
+
+    bool empty() const { return m_count == 0; }
+
+    /**
+     * @brief Gets how many fields add() cut short or dropped because they did not fit.
+     *
+     * @return The number of truncated fields.
+     */
+    size_t truncated_count() const { return m_truncated_count; }
+
+    /**
+     * @brief Gets a field by position, in the order the fields were added.
+     *
+     * @param index Position of the field, lower than size().
+     * @return The field, viewing this block's text.
+     */
+    LogField operator[](size_t index) const;
+
+    /**
+     * @brief Finds a field by key.
+     *
+     * @param key The key of the field.
+     * @return The field, viewing this block's text, or nothing if no field has that key.
+     */
+    std::optional<LogField> find(std::string_view key) const;
+
+    /**
+     * @brief Renders the fields as space-separated key=value pairs, string values quoted and escaped.
+     *
+     * @param text Receives the rendered fields, each preceded by a space.
+     */
+    void append_to(std::string& text) const;
+
+private:
+    struct FieldSlot
+    {
+        // The int64_t value, or the bits of the double value
+        uint64_t value_bits;
+        uint8_t key_offset;
+        uint8_t key_size;
+        uint8_t string_offset;
+        uint8_t string_size;
+        LogFieldType type;
+    };
+
+    struct FieldBlock
+    {
+        FieldSlot slots[MAX_FIELD_COUNT];
+        char text[TEXT_CAPACITY];
+        uint8_t text_size{0};
+    };
+
+    static_assert(TEXT_CAPACITY <= UINT8_MAX, "Field text offsets are stored on 8 bits");
+
+    /**
+     * @brief Copies a string into the text area.
+     *
+     * @param text The string to copy.
+     * @return Offset of the copy in the text area.
+     */
+    uint8_t _append_text(std::string_view text);
+
+    std::string_view _text(uint8_t offset, uint8_t size) const;
+
+    /**
+     * @brief Copies the used part of another block into this one, allocating the block if needed.
+     *
+     * @param other The fields to copy.
+     */
+    void _copy_from(const LogFields& other);
+
+    std::unique_ptr<FieldBlock> m_block;
+    uint8_t m_count{0};
+    uint8_t m_truncated_count{0};
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "FileWriterOptions.hpp"
+#include "Severity.hpp"
+
+/**
+ * @brief How asynchronous log tasks are distributed between worker threads.
+ */
+enum class SchedulerMode
+{
+    SharedQueue,    // All workers pop from one shared queue
+    WorkStealing    // Each worker owns a queue, producers are hashed to a home worker and idle workers steal
+};
+
+/**
+ * @brief Delivery order guarantees of asynchronous log tasks.
+ */
+enum class SinkOrdering
+{
+    Unordered,  // Tasks of the same callback may run concurrently on different workers
+    PerSink     // Each callback receives its entries one at a time, in the order they were logged
+};
+
+using PoolResizeHandler = std::function<void(size_t previous_thread_count, size_t thread_count)>;
+
+/**
+ * @brief Construction options of a CallbackLogger.
+ */
+struct LoggerOptions
+{
+    size_t thread_count{1};
+    SchedulerMode scheduler_mode{SchedulerMode::SharedQueue};
+    SinkOrdering sink_ordering{SinkOrdering::Unordered};
+
+    // Adaptive pool: thread_count is the minimal pool size and the pool grows up to max_thread_count (0 keeps it fixed)
+    size_t max_thread_count{0};
+    size_t scale_up_queue_depth{64};
+    std::chrono::microseconds scale_up_queue_latency{std::chrono::milliseconds(10)};
+    std::chrono::milliseconds idle_thread_timeout{std::chrono::seconds(5)};
+    PoolResizeHandler pool_resize_handler;
+
+    // CPUs the worker threads are pinned to, empty keeps the default affinity. Every CPU must be allowed to the process,
+    // workers that still cannot be pinned later are counted in LoggerStatistics::unpinned_workers.
+    // Work-stealing workers allocate their own queue after pinning, so it is first touched on their NUMA node.
+    std::vector<size_t> worker_cpu_set;
+    std::string worker_thread_name_prefix{"cblog-worker-"};
+
+    // How file callbacks write their entries, by default opening the file for every entry
+    FileWriterOptions file_writer;
+
+    // Shared queue priority lanes: entries at or above this severity go to the High lane whatever their callbacks'
+    // priority, and a waiting lower lane is served after lane_starvation_limit tasks were taken from higher lanes
+    std::optional<Severity> high_priority_min_severity;
+    size_t lane_starvation_limit{32};
+
+    // Keeps the logger usable in the child of a fork(): the queue is frozen while the process forks, and the child
+    // drops the tasks copied from the parent, starts its own workers and reopens the files of the file writers.
+    // Off by default, since every fork() of the process then waits for the logger's locks
+    bool fork_safe{false};
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+
+#include "Severity.hpp"
+#include "ComponentEnumEntry.hpp"
+#include "CallbackPriority.hpp"
+
+constexpr size_t LATENCY_HISTOGRAM_BUCKET_COUNT = 16;
+
+/**
+ * @brief Snapshot of the counters of a single registered callback.
+ */
+struct CallbackStatistics
+{
+    uint64_t invocations{0};
+    uint64_t exceptions{0};
+    bool is_disabled{false};
+    // Bucket i counts invocations that took less than 2^i microseconds, the last bucket is open-ended.
+    std::array<uint64_t, LATENCY_HISTOGRAM_BUCKET_COUNT> latency_histogram{};
+};
+
+/**
+ * @brief Snapshot of the counters of a priority lane of the shared queue.
+ */
+struct LaneStatistics
+{
+    uint64_t queue_depth{0};
+    uint64_t tasks_dequeued{0};
+    // Bucket i counts tasks that waited in the lane less than 2^i microseconds, the last bucket is open-ended.
+    std::array<uint64_t, LATENCY_HISTOGRAM_BUCKET_COUNT> wait_histogram{};
+};
+
+/**
+ * @brief Point-in-time snapshot of a logger's counters, as returned by CallbackLogger::stats().
+ */
+struct LoggerStatistics
+{
+    std::array<uint64_t, static_cast<size_t>(Severity::SEVERITY_COUNT)> logged_per_severity{};
+    std::unordered_map<ComponentEnumEntry, uint64_t, ComponentEnumEntryHasher> logged_per_component;
+    // Entries no callback received, including the ones every matching callback's message filter rejected
+    uint64_t filtered_out{0};
+    // Callback deliveries skipped by a message filter, evaluated after the task was enqueued
+    uint64_t message_filter_rejections{0};
+    uint64_t rate_limited{0};
+    // Structured fields cut short or dropped because they did not fit their entry's LogFields
+    uint64_t truncated_fields{0};
+    // Entries dropped by sampling, so dashboards can scale the logged counts back up
+    std::array<uint64_t, static_cast<size_t>(Severity::SEVERITY_COUNT)> sampled_out_per_severity{};
+    uint64_t tasks_enqueued{0};
+    uint64_t queue_depth{0};
+    uint64_t peak_queue_depth{0};
+    uint64_t worker_busy_time_ns{0};
+    uint64_t worker_count{0};
+    // Workers started since the logger was built whose LoggerOptions::worker_cpu_set could not be applied
+    uint64_t unpinned_workers{0};
+    // Indexed by CallbackPriority, only filled by the shared queue scheduler
+    std::array<LaneStatistics, static_cast<size_t>(CallbackPriority::PRIORITY_COUNT)> lanes{};
+    std::unordered_map<uint32_t, CallbackStatistics> function_callbacks;
+    std::unordered_map<uint32_t, CallbackStatistics> file_callbacks;
+};
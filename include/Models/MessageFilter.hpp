@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Kind of match a message filter performs on the log message.
+ */
+enum class MessageFilterType
+{
+    None,       // Every message matches
+    Substring,  // The message contains the single pattern
+    AnyOf,      // The message contains at least one of the patterns
+    Regex       // The message contains a match of the single ECMAScript pattern
+};
+
+/**
+ * @brief Filter on the content of log messages, compiled once at registration and evaluated on the worker threads.
+ */
+struct MessageFilter
+{
+    MessageFilterType type{MessageFilterType::None};
+    std::vector<std::string> patterns;
+
+    static MessageFilter contains(const std::string& substring)
+    {
+        return MessageFilter{MessageFilterType::Substring, {substring}};
+    }
+
+    static MessageFilter contains_any(const std::vector<std::string>& substrings)
+    {
+        return MessageFilter{MessageFilterType::AnyOf, substrings};
+    }
+
+    static MessageFilter matches_regex(const std::string& pattern)
+    {
+        return MessageFilter{MessageFilterType::Regex, {pattern}};
+    }
+};
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Outcome of a shutdown with a deadline, as returned by CallbackLogger::shutdown.
+ */
+struct ShutdownReport
+{
+    // True if every entry logged before the shutdown was delivered before the deadline
+    bool is_drained{true};
+    // Callback tasks still queued at the deadline, dropped without running their callback
+    uint64_t dropped_tasks{0};
+    // Workers still running a callback after the deadline, left running and joined by the logger's destructor
+    size_t stuck_workers{0};
+};
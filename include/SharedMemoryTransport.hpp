@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "CallbackLoggerClass.hpp"
+#include "Models/LogEntry.hpp"
+#include "Utils/SharedMemoryRing.hpp"
+
+/**
+ * @brief Function callback writing log entries as binary records into a shared memory ring,
+ * so several processes can feed one SharedMemoryCollector without any syscall per entry.
+ *
+ * Components cross the process boundary by type name and value. Enums declared with CALLBACK_LOGGER_STATIC_COMPONENT
+ * also carry their static ID, so the collector's filters on those enums match them exactly.
+ */
+class SharedMemorySink
+{
+public:
+    /**
+     * @brief Opens or creates the shared memory ring.
+     *
+     * @param name Name of the shared memory ring.
+     * @param slot_count Number of slots of the ring, equal in every process.
+     */
+    explicit SharedMemorySink(const std::string& name, size_t slot_count = SharedMemoryRing::DEFAULT_SLOT_COUNT);
+
+    /**
+     * @brief Writes an entry into the ring, dropping it if the ring is full. Long messages are truncated to fit a slot.
+     *
+     * @param entry The log entry.
+     */
+    void operator()(const LogEntry& entry) const;
+
+    /**
+     * @brief Gets how many entries were dropped because the ring was full.
+     *
+     * @return The number of dropped entries, over all producer processes.
+     */
+    uint64_t dropped_count() const;
+
+private:
+    std::shared_ptr<SharedMemoryRing> m_ring;
+};
+
+/**
+ * @brief Collector side of a shared memory ring, replaying the entries of every producer process
+ * into a logger so its callbacks and filters run in this single process.
+ *
+ * A component without a static ID is replayed with its type name as a string type. Filters registered with the
+ * enum itself compare its type_index and never match it, so enums crossing the process boundary should be declared
+ * with CALLBACK_LOGGER_STATIC_COMPONENT. Such records are counted in non_static_component_count().
+ */
+class SharedMemoryCollector
+{
+public:
+    /**
+     * @brief Opens or creates the shared memory ring.
+     *
+     * @param logger The logger receiving the collected entries.
+     * @param name Name of the shared memory ring.
+     * @param slot_count Number of slots of the ring, equal in every process.
+     */
+    SharedMemoryCollector(CallbackLogger& logger, const std::string& name,
+                          size_t slot_count = SharedMemoryRing::DEFAULT_SLOT_COUNT);
+
+    /**
+     * @brief Destructor. Stops the polling thread.
+     */
+    ~SharedMemoryCollector();
+
+    SharedMemoryCollector(const SharedMemoryCollector& other) = delete;
+    SharedMemoryCollector& operator=(const SharedMemoryCollector& other) = delete;
+
+    /**
+     * @brief Replays the pending records into the logger.
+     *
+     * @param max_records Maximal number of records to replay.
+     * @return The number of records replayed.
+     */
+    size_t poll(size_t max_records = SIZE_MAX);
+
+    /**
+     * @brief Gets how many replayed records had a component without a static ID, which filters on enum
+     * components cannot match.
+     *
+     * @return The number of records replayed with a string-typed component.
+     */
+    uint64_t non_static_component_count() const;
+
+    /**
+     * @brief Starts a thread polling the ring, sleeping while it is empty.
+     *
+     * @param idle_sleep How long the thread sleeps when the ring is empty.
+     */
+    void start(std::chrono::microseconds idle_sleep = std::chrono::milliseconds(1));
+
+    /**
+     * @brief Stops the polling thread after a last poll.
+     */
+    void stop();
+
+private:
+    CallbackLogger& m_logger;
+    SharedMemoryRing m_ring;
+    std::mutex m_poll_mutex;
+    std::thread m_polling_thread;
+    std::atomic<bool> m_is_polling{false};
+    std::atomic<uint64_t> m_non_static_component_count{0};
+};
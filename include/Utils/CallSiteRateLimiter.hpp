@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "Models/ComponentEnumEntry.hpp"
+#include "Models/Severity.hpp"
+
+/**
+ * @brief Outcome of a rate limit check of one log call.
+ */
+struct RateLimitDecision
+{
+    bool is_admitted;
+    // Entries of the call site dropped since its previous admitted entry, reported once by the admitted entry
+    uint64_t suppressed_count;
+    // Set when an entry is dropped from a call site the limiter cannot describe yet, see describe_call_site
+    bool needs_call_site;
+};
+
+/**
+ * @brief Origin of the entries of a call site, kept to report its dropped entries after it went quiet.
+ */
+struct RateLimitedCallSite
+{
+    Severity severity;
+    ComponentEnumEntry component;
+    std::string file;
+    uint32_t line;
+};
+
+/**
+ * @brief Token-bucket rate limits per call site, kept in a fixed-size lock-free open addressing table.
+ *
+ * Each bucket is tracked as a theoretical arrival time (GCRA), so admitting an entry is a single compare-and-swap.
+ * Call sites that do not fit in the table are never limited.
+ */
+class CallSiteRateLimiter
+{
+public:
+    static constexpr size_t TABLE_SIZE = 1024;
+    static constexpr size_t MAX_PROBES = 32;
+
+    CallSiteRateLimiter();
+
+    /**
+     * @brief Sets the rate limit applied to every call site.
+     *
+     * @param entries_per_second Sustained number of entries per second, 0 to disable rate limiting.
+     * @param burst Number of entries a call site may log at once before being limited.
+     */
+    void configure(double entries_per_second, uint32_t burst);
+
+    /**
+     * @brief Checks whether rate limiting is enabled, so disabled loggers skip hashing the call site.
+     *
+     * @return True if a rate limit is configured.
+     */
+    bool is_enabled() const { return m_emission_interval_ns.load(std::memory_order_relaxed) > 0; }
+
+    /**
+     * @brief Takes a token from the bucket of a call site.
+     *
+     * @param call_site Hash of the call site, must not be 0.
+     * @param now_ns Current steady clock time in nanoseconds.
+     * @return Whether the entry is admitted, and how many entries of the site were dropped before it.
+     */
+    RateLimitDecision admit(uint64_t call_site, int64_t now_ns);
+
+    /**
+     * @brief Describes a call site that had an entry dropped, once per call site, so its dropped entries can
+     * be reported even if it never logs again.
+     *
+     * @param call_site Hash of the call site, must not be 0.
+     * @param description Origin of the call site's entries.
+     */
+    void describe_call_site(uint64_t call_site, const RateLimitedCallSite& description);
+
+    /**
+     * @brief Takes the dropped entry counts of every described call site, as an admitted entry would.
+     *
+     * @param report Called with each call site that had entries dropped since its last admitted entry.
+     */
+    void take_suppressed_counts(const std::function<void(const RateLimitedCallSite&, uint64_t)>& report);
+
+private:
+    struct CallSiteSlot
+    {
+        std::atomic<uint64_t> call_site{0};
+        std::atomic<int64_t> theoretical_arrival_ns{0};
+        std::atomic<uint64_t> suppressed_count{0};
+        // Published once, a slot keeps its call site for the limiter's lifetime
+        std::atomic<RateLimitedCallSite*> description{nullptr};
+
+        ~CallSiteSlot() { delete description.load(std::memory_order_relaxed); }
+    };
+
+    /**
+     * @brief Finds the slot of a call site, claiming an empty one if the site is new.
+     *
+     * @param call_site Hash of the call site.
+     * @return The slot, or nullptr if the probe sequence is full.
+     */
+    CallSiteSlot* _find_slot(uint64_t call_site);
+
+    std::unique_ptr<CallSiteSlot[]> m_slots;
+    std::atomic<int64_t> m_emission_interval_ns{0};
+    std::atomic<int64_t> m_burst_tolerance_ns{0};
+};
@@ -1,7 +1,50 @@
 #pragma once
 
+#include <type_traits>
+
 #include "Models/ComponentEnumEntry.hpp"
 
+/**
+ * @brief Compile-time description of a component enum. Specialized by CALLBACK_LOGGER_STATIC_COMPONENT.
+ *
+ * @tparam EnumT Enum type.
+ */
+template <typename EnumT>
+struct ComponentTraits
+{
+    static constexpr bool is_static = false;
+    static constexpr uint32_t type_id = 0;
+};
+
+/**
+ * @brief Declares a component enum with a fixed, non-zero type ID, unique between the declared enums.
+ * Its entries then carry a constexpr component ID that is hashed and compared as a single integer.
+ * Must be used in the global namespace.
+ */
+#define CALLBACK_LOGGER_STATIC_COMPONENT(EnumT, enum_type_id)                                   \
+    template <>                                                                                 \
+    struct ComponentTraits<EnumT>                                                               \
+    {                                                                                           \
+        static_assert(std::is_enum<EnumT>::value, "EnumT must be an enum type");                \
+        static_assert((enum_type_id) != 0, "Static component type ID must not be 0");           \
+        static constexpr bool is_static = true;                                                 \
+        static constexpr uint32_t type_id = (enum_type_id);                                     \
+    }
+
+/**
+ * @brief Computes the compile-time component ID of a statically declared enum value.
+ *
+ * @tparam EnumT Enum type, declared with CALLBACK_LOGGER_STATIC_COMPONENT.
+ * @param value Enum value.
+ * @return The type ID in the high 32 bits and the enum value in the low 32 bits.
+ */
+template <typename EnumT>
+constexpr uint64_t static_component_id(EnumT value)
+{
+    static_assert(ComponentTraits<EnumT>::is_static, "EnumT must be declared with CALLBACK_LOGGER_STATIC_COMPONENT");
+    return (static_cast<uint64_t>(ComponentTraits<EnumT>::type_id) << 32) | static_cast<uint32_t>(value);
+}
+
 /**
  * @brief Converts an enum value to a ComponentEnumEntry.
  *
@@ -12,5 +55,21 @@
 template <typename EnumT>
 ComponentEnumEntry make_component_entry(EnumT value) {
     static_assert(std::is_enum<EnumT>::value, "EnumT must be an enum type");
-    return ComponentEnumEntry{std::type_index(typeid(EnumT)), static_cast<uint32_t>(value)};
+    if constexpr (ComponentTraits<EnumT>::is_static)
+        return ComponentEnumEntry{std::type_index(typeid(EnumT)), static_cast<uint32_t>(value), static_component_id(value)};
+    else
+        return ComponentEnumEntry{std::type_index(typeid(EnumT)), static_cast<uint32_t>(value)};
+}
+
+/**
+ * @brief Gets the entry of a component known at compile time, built once per component.
+ *
+ * @tparam Component Enum value.
+ * @return ComponentEnumEntry representing the enum value.
+ */
+template <auto Component>
+const ComponentEnumEntry& static_component_entry()
+{
+    static const ComponentEnumEntry entry = make_component_entry(Component);
+    return entry;
 }
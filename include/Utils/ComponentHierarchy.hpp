@@ -0,0 +1,29 @@
+#pragma once
+
+#include <unordered_map>
+
+#include "Models/ComponentEnumEntry.hpp"
+#include "Models/Severity.hpp"
+
+using ComponentParentMap = std::unordered_map<ComponentEnumEntry, ComponentEnumEntry, ComponentEnumEntryHasher>;
+
+/**
+ * @brief Checks whether a component is an ancestor of another, or the component itself.
+ *
+ * @param parents Map of components to their parent.
+ * @param ancestor The candidate ancestor.
+ * @param component The component whose parent chain is walked.
+ * @return True if ancestor is component or one of its ancestors.
+ */
+bool is_component_ancestor(const ComponentParentMap& parents, const ComponentEnumEntry& ancestor, const ComponentEnumEntry& component);
+
+/**
+ * @brief Flattens subtree roots into a component filter map covering every descendant, so matching stays a single lookup.
+ *
+ * @param roots Map of subtree roots to their minimum severities.
+ * @param parents Map of components to their parent.
+ * @return Map of every component under a root to the minimum severity of its nearest root.
+ */
+std::unordered_map<ComponentEnumEntry, Severity, ComponentEnumEntryHasher> expand_subtree_filter(
+    const std::unordered_map<ComponentEnumEntry, Severity, ComponentEnumEntryHasher>& roots,
+    const ComponentParentMap& parents);
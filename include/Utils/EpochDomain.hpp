@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Utils/LoggerCounters.hpp"
+
+/**
+ * @brief Epoch-based reclamation of objects read without locks or reference counts.
+ *
+ * Readers pin the domain for the time they use the published objects, which only stores the current epoch
+ * in the calling thread's record. A writer replaces an object, retires the previous one and frees it once
+ * every thread pinned before the replacement has unpinned, so readers never wait and never touch a shared
+ * cache line other than their own record and the epoch counter.
+ */
+class EpochDomain
+{
+    struct ThreadRecord;
+
+public:
+    /**
+     * @brief Pins the calling thread for its lifetime. Guards may be nested, only the outermost one pins.
+     */
+    class Guard
+    {
+    public:
+        explicit Guard(EpochDomain& domain);
+        ~Guard();
+
+        Guard(const Guard& other) = delete;
+        Guard& operator=(const Guard& other) = delete;
+
+    private:
+        ThreadRecord& m_record;
+    };
+
+    EpochDomain();
+
+    /**
+     * @brief Destructor. Frees the retired objects, no thread may be pinned anymore.
+     */
+    ~EpochDomain();
+
+    EpochDomain(const EpochDomain& other) = delete;
+    EpochDomain& operator=(const EpochDomain& other) = delete;
+
+    /**
+     * @brief Retires an object that was replaced, freeing it once no thread pinned before can read it.
+     * The object must no longer be reachable by threads pinning from now on.
+     *
+     * @param object The object to free.
+     */
+    template <typename T>
+    void retire(std::unique_ptr<T> object)
+    {
+        _retire(std::shared_ptr<const void>(std::move(object)));
+    }
+
+    /**
+     * @brief Frees the retired objects no pinned thread can read anymore. Never waits for readers.
+     *
+     * @return Number of retired objects still waiting for readers.
+     */
+    size_t reclaim();
+
+    /**
+     * @brief Resets the domain in the child of a fork(). The records of the parent's other threads are unpinned, since
+     * those threads do not exist in the child, and the objects retired before the fork are leaked rather than freed,
+     * as the parent owns whatever they hold. No thread may have been retiring or reclaiming during the fork.
+     */
+    void reset_after_fork();
+
+private:
+    struct alignas(CACHE_LINE_SIZE) ThreadRecord
+    {
+        std::thread::id owner;
+        // Epoch the thread pinned at, 0 while not pinned
+        std::atomic<uint64_t> epoch{0};
+        // Only accessed by the owning thread
+        uint32_t depth{0};
+        ThreadRecord* next{nullptr};
+    };
+
+    struct RetiredObject
+    {
+        uint64_t epoch;
+        std::shared_ptr<const void> object;
+    };
+
+    /**
+     * @brief Finds the calling thread's record, creating it on the thread's first pin.
+     *
+     * @return The calling thread's record.
+     */
+    ThreadRecord& _thread_record();
+
+    void _retire(std::shared_ptr<const void> object);
+
+    const uint64_t m_domain_id;
+    std::atomic<uint64_t> m_epoch{1};
+    std::atomic<ThreadRecord*> m_records{nullptr};
+    std::mutex m_retired_mutex;
+    std::vector<RetiredObject> m_retired;
+};
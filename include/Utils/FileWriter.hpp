@@ -0,0 +1,105 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "Models/FileWriterOptions.hpp"
+#include "Models/Severity.hpp"
+
+class IoUringQueue;
+
+/**
+ * @brief Appends text to a file it keeps open, shared by the workers running a file callback.
+ *
+ * With the io_uring backend, workers only copy their text into a staging buffer. A submission thread owned
+ * by the writer hands the staging buffer to the kernel as one appending write, and submits the next one only
+ * once it completed so the file keeps the order of the write() calls. Requested fsyncs are linked to the write
+ * they follow. The kernel fails the requests of
+ * a thread that exits, so submitting from the workers would lose writes whenever the pool shrinks.
+ * Workers only wait when max_buffered_bytes are staged. Without io_uring support, the writer falls back
+ * to a buffered std::ofstream written by the workers.
+ */
+class FileWriter
+{
+public:
+    /**
+     * @brief Opens the file for appending.
+     *
+     * @param file_path The path to the file.
+     * @param options The backend, fsync policy and buffering of the writer.
+     * @throws std::runtime_error If the file cannot be opened.
+     */
+    FileWriter(const std::string& file_path, const FileWriterOptions& options);
+
+    /**
+     * @brief Destructor. Flushes and closes the file.
+     */
+    ~FileWriter();
+
+    FileWriter(const FileWriter& other) = delete;
+    FileWriter& operator=(const FileWriter& other) = delete;
+
+    /**
+     * @brief Appends text to the file, syncing it to the disk if the fsync policy requests it for the severity.
+     *
+     * @param text The text to append.
+     * @param severity The severity of the entry the text renders.
+     */
+    void write(const std::string& text, Severity severity);
+
+    /**
+     * @brief Waits until everything written before the call has reached the file.
+     */
+    void flush();
+
+    /**
+     * @brief Checks whether the writes go through io_uring.
+     *
+     * @return True with the io_uring backend on a kernel supporting it, false for the std::ofstream fallback.
+     */
+    bool is_using_io_uring() const;
+
+    /**
+     * @brief Gets how many io_uring writes failed, whose text is missing from the file.
+     *
+     * @return The number of failed writes.
+     */
+    uint64_t failed_write_count() const;
+
+private:
+    /**
+     * @brief Body of the submission thread, which fails the writer if the ring becomes unusable.
+     */
+    void _submission_thread();
+
+    /**
+     * @brief Submits the staged text and reaps completions until the writer is destroyed.
+     */
+    void _submit_until_stopped();
+
+    bool _is_sync_requested(Severity severity) const;
+
+    const FileWriterOptions m_options;
+    mutable std::mutex m_mutex;
+    std::ofstream m_stream;
+
+    std::unique_ptr<IoUringQueue> m_io_uring;
+    std::thread m_submission_thread;
+    // Wakes the submission thread when text is staged while it is idle
+    std::condition_variable m_submission_condition;
+    // Wakes the writers waiting for the staging buffer to drain or for a flush
+    std::condition_variable m_drain_condition;
+    std::string m_staging;
+    bool m_is_sync_pending{false};
+    bool m_is_stopping{false};
+    bool m_is_ring_failed{false};
+    // Bytes handed to write(), and bytes whose write completed, a flush waits for the latter to catch up
+    uint64_t m_staged_bytes{0};
+    uint64_t m_completed_bytes{0};
+    uint64_t m_failed_write_count{0};
+};
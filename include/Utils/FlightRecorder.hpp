@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "Models/ComponentEnumEntry.hpp"
+#include "Models/Severity.hpp"
+
+/**
+ * @brief Fixed-size in-memory rings of the most recent log entries, one per logging thread.
+ *
+ * Recording is wait-free: the owning thread writes its own ring, each slot guarded by a sequence counter,
+ * and strings are truncated into the fixed record. Dumping only reads atomics and calls write(), so it is
+ * async-signal-safe and can run from a crash handler while other threads are still logging.
+ */
+class FlightRecorder
+{
+public:
+    /**
+     * @brief Constructs a flight recorder.
+     *
+     * @param dump_path File the recorder is dumped to.
+     * @param records_per_thread Most recent entries kept per logging thread.
+     */
+    FlightRecorder(const std::string& dump_path, size_t records_per_thread);
+
+    /**
+     * @brief Destructor. Unregisters the recorder from the crash handler and frees the rings.
+     */
+    ~FlightRecorder();
+
+    FlightRecorder(const FlightRecorder& other) = delete;
+    FlightRecorder& operator=(const FlightRecorder& other) = delete;
+
+    /**
+     * @brief Records an entry into the calling thread's ring.
+     *
+     * @param severity The severity level of the log.
+     * @param component The component generating the log.
+     * @param message The log message.
+     * @param file The source file where the log was generated.
+     * @param line The line number in the source file.
+     */
+    void record(Severity severity, const ComponentEnumEntry& component, const std::string& message,
+                const std::string& file, uint32_t line);
+
+    /**
+     * @brief Writes the rings to the dump file, oldest entry first per thread. Async-signal-safe.
+     *
+     * @return True if the dump file was written, false otherwise.
+     */
+    bool dump() const;
+
+    /**
+     * @brief Makes the SIGSEGV and SIGABRT handlers dump this recorder, installing the handlers on first use.
+     */
+    void install_crash_handler();
+
+private:
+    static constexpr size_t COMPONENT_SIZE = 40;
+    static constexpr size_t FILE_SIZE = 48;
+    static constexpr size_t MESSAGE_SIZE = 152;
+
+    struct FlightRecord
+    {
+        uint64_t index;
+        int64_t timestamp_ns;
+        uint32_t line;
+        int32_t severity;
+        char component[COMPONENT_SIZE];
+        char file[FILE_SIZE];
+        char message[MESSAGE_SIZE];
+    };
+    static constexpr size_t RECORD_WORDS = sizeof(FlightRecord) / sizeof(uint64_t);
+    static_assert(sizeof(FlightRecord) % sizeof(uint64_t) == 0, "FlightRecord must be a whole number of words");
+
+    // The record is stored as relaxed atomic words, so a dump racing the writer reads torn data instead of racing
+    struct FlightSlot
+    {
+        std::atomic<uint64_t> sequence{0};
+        std::array<std::atomic<uint64_t>, RECORD_WORDS> words{};
+    };
+
+    struct ThreadRing
+    {
+        std::thread::id owner;
+        uint64_t thread_number;
+        std::atomic<uint64_t> head{0};
+        std::unique_ptr<FlightSlot[]> slots;
+        ThreadRing* next{nullptr};
+    };
+
+    /**
+     * @brief Finds the calling thread's ring, creating it on the thread's first entry.
+     *
+     * @return The calling thread's ring.
+     */
+    ThreadRing& _thread_ring();
+
+    /**
+     * @brief Reads a slot, rejecting it if it was being written or did not hold the expected entry.
+     *
+     * @param slot The slot to read.
+     * @param index The expected entry index.
+     * @param record Receives the record.
+     * @return True if a consistent record was read.
+     */
+    static bool _read_slot(const FlightSlot& slot, uint64_t index, FlightRecord& record);
+
+    const std::string m_dump_path;
+    const size_t m_records_per_thread;
+    const uint64_t m_recorder_id;
+    std::atomic<ThreadRing*> m_rings{nullptr};
+    std::atomic<uint64_t> m_ring_count{0};
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+/**
+ * @brief Handlers run around fork() for one registration.
+ */
+struct ForkHandlers
+{
+    // Run in the forking thread before fork(), in reverse registration order
+    std::function<void()> prepare;
+    // Run after fork() in the parent, in registration order
+    std::function<void()> parent;
+    // Run after fork() in the child, in registration order. The forking thread is the only thread of the child.
+    std::function<void()> child;
+};
+
+/**
+ * @brief Registers handlers with the pthread_atfork hooks shared by every registration of the process, for its
+ * lifetime. The hooks are installed once, on the first registration, since pthread_atfork handlers cannot be removed.
+ * A registration or unregistration racing a fork waits until the child and parent handlers have run.
+ * Registrations are inert on platforms without fork().
+ */
+class ForkHandlerRegistration
+{
+public:
+    /**
+     * @brief Registers the handlers.
+     *
+     * @param handlers The handlers to run around every fork() of the process.
+     */
+    explicit ForkHandlerRegistration(ForkHandlers handlers);
+
+    /**
+     * @brief Destructor. Unregisters the handlers, no fork runs them afterwards.
+     */
+    ~ForkHandlerRegistration();
+
+    ForkHandlerRegistration(const ForkHandlerRegistration& other) = delete;
+    ForkHandlerRegistration& operator=(const ForkHandlerRegistration& other) = delete;
+
+private:
+    uint64_t m_id;
+};
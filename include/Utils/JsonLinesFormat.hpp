@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "Models/LogEntry.hpp"
+
+/**
+ * @brief Appends a string to JSON text with the escaping a JSON string requires, without the surrounding quotes.
+ * Runs of characters that need no escaping are found 16 (SSE2) or 32 (AVX2, when the CPU supports it) bytes at a
+ * time and copied at once. Bytes above 0x7F are copied as is, so UTF-8 text stays UTF-8.
+ *
+ * @param text Receives the escaped string.
+ * @param value The string to escape.
+ */
+void append_json_escaped(std::string& text, std::string_view value);
+
+/**
+ * @brief Renders a log entry as a JSON Lines record, with its fields in a nested "fields" object.
+ *
+ * @param entry The log entry to render.
+ * @param line Receives the record, ending with a newline.
+ */
+void append_json_log_line(const LogEntry& entry, std::string& line);
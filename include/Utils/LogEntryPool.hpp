@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Per-thread slab pool of fixed-size blocks for log records shared between callbacks.
+ *
+ * Each producer thread allocates from its own pool without locking. A block remembers its origin pool and is pushed
+ * back onto that pool's lock-free return list by whichever thread drops the last reference, so workers never touch
+ * the global allocator and a pool outlives its thread until its last block is returned.
+ */
+class LogEntryPool
+{
+public:
+    constexpr static size_t BLOCK_SIZE = 512;
+    constexpr static size_t BLOCKS_PER_SLAB = 64;
+
+    /**
+     * @brief Allocates memory from the calling thread's pool, or from the heap if it does not fit a block.
+     *
+     * @param size Number of bytes to allocate.
+     * @return The allocated memory, aligned for any standard type.
+     */
+    static void* allocate(size_t size);
+
+    /**
+     * @brief Returns memory obtained from allocate() to its origin pool.
+     *
+     * @param pointer The memory to return.
+     */
+    static void deallocate(void* pointer) noexcept;
+
+    LogEntryPool(const LogEntryPool& other) = delete;
+    LogEntryPool& operator=(const LogEntryPool& other) = delete;
+
+private:
+    struct alignas(alignof(std::max_align_t)) BlockHeader
+    {
+        LogEntryPool* origin;
+    };
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    LogEntryPool() = default;
+    ~LogEntryPool();
+
+    /**
+     * @brief Gets the calling thread's pool, creating it on first use.
+     *
+     * @return The pool, or nullptr while the thread is exiting.
+     */
+    static LogEntryPool* _thread_pool();
+
+    /**
+     * @brief Pops a free block, collecting returned blocks or carving a new slab when the local list is empty.
+     *
+     * @return A free block.
+     */
+    FreeBlock* _pop_block();
+
+    /**
+     * @brief Drops one reference to the pool, deleting it when the owner thread and all blocks are gone.
+     */
+    void _release() noexcept;
+
+    FreeBlock* m_local_free{nullptr};
+    std::atomic<FreeBlock*> m_returned_free{nullptr};
+    std::atomic<size_t> m_references{1};
+    std::vector<void*> m_slabs;
+
+    friend struct LogEntryPoolOwner;
+};
+
+/**
+ * @brief Standard allocator over LogEntryPool, used to allocate shared log entries with std::allocate_shared.
+ *
+ * @tparam T Allocated type.
+ */
+template <typename T>
+struct LogEntryPoolAllocator
+{
+    static_assert(alignof(T) <= alignof(std::max_align_t), "LogEntryPoolAllocator does not support over-aligned types");
+
+    using value_type = T;
+
+    LogEntryPoolAllocator() noexcept = default;
+
+    template <typename U>
+    LogEntryPoolAllocator(const LogEntryPoolAllocator<U>&) noexcept {}
+
+    T* allocate(size_t count) { return static_cast<T*>(LogEntryPool::allocate(count * sizeof(T))); }
+
+    void deallocate(T* pointer, size_t) noexcept { LogEntryPool::deallocate(pointer); }
+
+    template <typename U>
+    bool operator==(const LogEntryPoolAllocator<U>&) const noexcept { return true; }
+
+    template <typename U>
+    bool operator!=(const LogEntryPoolAllocator<U>&) const noexcept { return false; }
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Models/FileFormat.hpp"
+#include "Models/LogEntry.hpp"
+
+/**
+ * @brief Renders log entries as the lines of a file. Formatters are immutable once built, so the workers of a file
+ * share one without locking.
+ */
+class LogFormatter
+{
+public:
+    virtual ~LogFormatter() = default;
+
+    /**
+     * @brief Renders a log entry.
+     *
+     * @param entry The log entry to render.
+     * @param line Receives the line, ending with a newline. Its previous content is kept, so a buffer can be reused.
+     */
+    virtual void format(const LogEntry& entry, std::string& line) const = 0;
+
+    /**
+     * @brief Checks whether another formatter renders entries the same way, so both can write the same file.
+     *
+     * @param other The other formatter.
+     * @return True if both formatters produce the same lines.
+     */
+    virtual bool has_same_layout(const LogFormatter& other) const = 0;
+};
+using LogFormatterPtr = std::shared_ptr<const LogFormatter>;
+
+/**
+ * @brief Formatter laying entries out after a pattern, parsed once into a list of steps.
+ *
+ * The pattern is copied as is except for these directives:
+ * %T timestamp, %S severity, %C component, %F source file, %L source line, %M message,
+ * %A structured fields as " key=value" pairs (nothing without fields), %P "[!]" from Warning up and "[*]" below,
+ * %% a percent sign. A newline ends every line.
+ */
+class PatternFormatter : public LogFormatter
+{
+public:
+    // The layout of FileFormat::Text
+    static constexpr const char* DEFAULT_PATTERN = "%P [%T] [%S] %C (%F:%L): %M%A";
+
+    /**
+     * @brief Parses a pattern.
+     *
+     * @param pattern The pattern.
+     * @throws std::invalid_argument If the pattern is empty or has an unknown or incomplete directive.
+     */
+    explicit PatternFormatter(const std::string& pattern);
+
+    void format(const LogEntry& entry, std::string& line) const override;
+
+    bool has_same_layout(const LogFormatter& other) const override;
+
+    const std::string& pattern() const { return m_pattern; }
+
+private:
+    enum class StepType
+    {
+        Literal,
+        Timestamp,
+        Severity,
+        Component,
+        File,
+        Line,
+        Message,
+        Fields,
+        SeverityMarker
+    };
+
+    struct FormatStep
+    {
+        StepType type;
+        // Only for StepType::Literal
+        std::string literal;
+    };
+
+    std::string m_pattern;
+    std::vector<FormatStep> m_steps;
+};
+
+/**
+ * @brief Formatter writing each entry as a JSON object on its own line, see append_json_log_line.
+ */
+class JsonLinesFormatter : public LogFormatter
+{
+public:
+    void format(const LogEntry& entry, std::string& line) const override;
+
+    bool has_same_layout(const LogFormatter& other) const override;
+};
+
+/**
+ * @brief Gets the shared formatter of a built-in file format.
+ *
+ * @param format The file format.
+ * @return The formatter, shared by every caller.
+ */
+LogFormatterPtr make_log_formatter(FileFormat format);
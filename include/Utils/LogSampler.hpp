@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+#include "Models/ComponentEnumEntry.hpp"
+#include "Models/Severity.hpp"
+#include "Utils/EpochDomain.hpp"
+
+/**
+ * @brief Per-severity and per-component sampling rates, decided before a log entry is built.
+ *
+ * A decision draws from a thread-local xorshift generator, or from a hash of the thread's trace ID when one is set,
+ * so every entry of a trace is kept or dropped together. Component rates are read from an immutable snapshot
+ * under an epoch guard, so decisions never lock.
+ */
+class LogSampler
+{
+public:
+    LogSampler() = default;
+
+    /**
+     * @brief Destructor. Frees the component rates, no thread may be deciding anymore.
+     */
+    ~LogSampler();
+
+    LogSampler(const LogSampler& other) = delete;
+    LogSampler& operator=(const LogSampler& other) = delete;
+
+    /**
+     * @brief Sets the sampling rate of a severity for every component without its own rate.
+     *
+     * @param severity The severity to sample.
+     * @param rate Fraction of the entries kept, between 0 and 1.
+     */
+    void set_rate(Severity severity, double rate);
+
+    /**
+     * @brief Sets the sampling rate of a severity for one component, overriding the severity's rate. The other
+     * severities of the component keep following their rate for every component.
+     *
+     * @param component The component to sample.
+     * @param severity The severity to sample.
+     * @param rate Fraction of the entries kept, between 0 and 1.
+     */
+    void set_rate(const ComponentEnumEntry& component, Severity severity, double rate);
+
+    /**
+     * @brief Checks whether any rate below 1 was set, so unsampled loggers skip the decision entirely.
+     *
+     * @return True if sampling is enabled.
+     */
+    bool is_enabled() const { return m_is_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Decides whether an entry is kept.
+     *
+     * @param severity The severity of the entry.
+     * @param component The component of the entry.
+     * @return True if the entry is kept, false if it is sampled out.
+     */
+    bool should_keep(Severity severity, const ComponentEnumEntry& component) const;
+
+    /**
+     * @brief Sets the trace ID the sampling decisions of the calling thread are derived from.
+     *
+     * @param trace_id The trace ID, 0 to go back to random sampling.
+     */
+    static void set_thread_trace_id(uint64_t trace_id);
+
+    /**
+     * @brief Blocks component rate changes until unlock_after_fork, so a fork() copies them in a consistent state.
+     */
+    void lock_for_fork();
+
+    /**
+     * @brief Releases the rates blocked by lock_for_fork.
+     *
+     * @param is_child Whether the caller is the child of the fork.
+     */
+    void unlock_after_fork(bool is_child);
+
+private:
+    static constexpr size_t SEVERITY_COUNT = static_cast<size_t>(Severity::SEVERITY_COUNT);
+    // Threshold of a rate of 1, every sample is kept
+    static constexpr uint64_t KEEP_ALL = UINT64_MAX;
+
+    /**
+     * @brief Converts a rate to the threshold a uniform 64-bit sample is compared to.
+     *
+     * @param rate Fraction of the entries kept.
+     * @return The threshold.
+     */
+    static uint64_t _rate_to_threshold(double rate);
+
+    /**
+     * @brief Draws the uniform 64-bit sample of the calling thread's next decision.
+     *
+     * @return The sample.
+     */
+    static uint64_t _next_sample();
+
+    /**
+     * @brief Thresholds of the severities a component overrides, the others follow m_thresholds.
+     */
+    struct ComponentThresholds
+    {
+        // Bit i set when the component overrides severity i
+        uint32_t overridden_severities{0};
+        std::array<uint64_t, SEVERITY_COUNT> thresholds{};
+    };
+
+    using ComponentThresholdMap = std::unordered_map<ComponentEnumEntry, ComponentThresholds, ComponentEnumEntryHasher>;
+
+    std::array<std::atomic<uint64_t>, SEVERITY_COUNT> m_thresholds{KEEP_ALL, KEEP_ALL, KEEP_ALL, KEEP_ALL, KEEP_ALL};
+    // Replaced as a whole by set_rate, the previous snapshot is retired to m_component_threshold_epochs
+    std::atomic<const ComponentThresholdMap*> m_component_thresholds{nullptr};
+    // Serializes the writers of m_component_thresholds, decisions never take it
+    std::mutex m_component_thresholds_mutex;
+    mutable EpochDomain m_component_threshold_epochs;
+    std::atomic<bool> m_is_enabled{false};
+};
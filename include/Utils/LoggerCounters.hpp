@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "Models/LoggerStatistics.hpp"
+
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * @brief Relaxed atomic counter padded to its own cache line, so hot counters never share a line.
+ */
+struct alignas(CACHE_LINE_SIZE) PaddedCounter
+{
+    std::atomic<uint64_t> value{0};
+
+    void add(uint64_t amount = 1) { value.fetch_add(amount, std::memory_order_relaxed); }
+
+    void store_max(uint64_t candidate)
+    {
+        uint64_t current = value.load(std::memory_order_relaxed);
+        while (candidate > current && !value.compare_exchange_weak(current, candidate, std::memory_order_relaxed)) {}
+    }
+
+    uint64_t load() const { return value.load(std::memory_order_relaxed); }
+};
+
+/**
+ * @brief Live counters of a single registered callback.
+ */
+struct CallbackCounters
+{
+    PaddedCounter invocations;
+    PaddedCounter exceptions;
+    std::array<std::atomic<uint64_t>, LATENCY_HISTOGRAM_BUCKET_COUNT> latency_histogram{};
+
+    std::atomic<uint32_t> consecutive_exceptions{0};
+    std::atomic<uint64_t> suppressed_error_reports{0};
+    std::atomic<int64_t> last_error_report_ns{0};
+    std::atomic<bool> is_disabled{false};
+
+    /**
+     * @brief Records one invocation of the callback.
+     *
+     * @param elapsed How long the invocation took.
+     */
+    void record_invocation(std::chrono::nanoseconds elapsed);
+
+    /**
+     * @brief Copies the counters into a plain statistics struct.
+     *
+     * @return The current values of the counters.
+     */
+    CallbackStatistics snapshot() const;
+};
+
+/**
+ * @brief Maps a duration to its latency histogram bucket.
+ *
+ * @param elapsed The measured duration.
+ * @return Index of the smallest power-of-two microseconds bucket the duration fits in.
+ */
+size_t latency_bucket(std::chrono::nanoseconds elapsed);
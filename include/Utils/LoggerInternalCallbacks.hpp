@@ -7,6 +7,30 @@
 #include "Models/LogEntry.hpp"
 #include "Utils/SeverityUtils.hpp"
 
+/**
+ * @brief Renders a log entry as a line of a log file.
+ *
+ * @param entry The log entry to render.
+ * @return The line, ending with a newline.
+ */
+std::string format_file_log_line(const LogEntry& entry);
+
+/**
+ * @brief Resolves a file path to a canonical form, so different spellings of the same file compare equal.
+ *
+ * @param file_path The path to the file, which may not exist yet.
+ * @return The absolute path with symbolic links, "." and ".." resolved, or file_path if it cannot be resolved.
+ */
+std::string canonical_file_path(const std::string& file_path);
+
+/**
+ * @brief Appends text to a file, opening the file only for this operation.
+ *
+ * @param file_path The path to the file.
+ * @param text The text to append.
+ */
+void append_to_file(const std::string& file_path, const std::string& text);
+
 /**
  * @brief Writes a log entry to a file, opening the file for appending only for this operation.
  *
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "Models/MessageFilter.hpp"
+
+/**
+ * @brief Compiled form of a MessageFilter.
+ *
+ * A single substring is searched with Boyer-Moore-Horspool, several substrings with an Aho-Corasick automaton
+ * scanning the message once whatever the number of patterns, and regular expressions with std::regex.
+ */
+class MessageMatcher
+{
+public:
+    /**
+     * @brief Compiles a message filter.
+     *
+     * @param filter The filter to compile.
+     * @throws std::invalid_argument If the filter has no pattern, an empty pattern or an invalid regular expression.
+     */
+    explicit MessageMatcher(const MessageFilter& filter);
+
+    MessageMatcher(const MessageMatcher& other) = delete;
+    MessageMatcher& operator=(const MessageMatcher& other) = delete;
+
+    /**
+     * @brief Checks a message against the filter.
+     *
+     * @param message The log message.
+     * @return True if the message matches the filter, false otherwise.
+     */
+    bool matches(const std::string& message) const;
+
+private:
+    static constexpr size_t ALPHABET_SIZE = 256;
+
+    struct AutomatonState
+    {
+        std::array<uint32_t, ALPHABET_SIZE> transitions{};
+        bool is_match{false};
+    };
+
+    /**
+     * @brief Builds the Aho-Corasick automaton of the patterns, with failure links folded into the transitions.
+     *
+     * @param patterns The substrings to search for.
+     */
+    void _build_automaton(const std::vector<std::string>& patterns);
+
+    /**
+     * @brief Runs the automaton over a message.
+     *
+     * @param message The log message.
+     * @return True if any pattern occurs in the message.
+     */
+    bool _matches_any(const std::string& message) const;
+
+    MessageFilterType m_type;
+    std::string m_substring;
+    std::optional<std::boyer_moore_horspool_searcher<std::string::const_iterator>> m_substring_searcher;
+    std::vector<AutomatonState> m_automaton;
+    std::regex m_regex;
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <functional>
+
+/**
+ * @brief Runs the tasks submitted to it one at a time and in submission order, on whichever worker drains it.
+ *
+ * The executor owns no thread. The submitter that finds it idle is told to schedule a drain on the worker pool,
+ * so at most one drain of an executor is ever running or queued.
+ */
+class SerialExecutor
+{
+public:
+    /**
+     * @brief Appends a task to the executor.
+     *
+     * @param task The task to run.
+     * @return True if the executor was idle and the caller must schedule a drain, false otherwise.
+     */
+    bool submit(std::function<void()> task);
+
+    /**
+     * @brief Runs pending tasks in order, stopping after a batch so one busy sink cannot hog a worker.
+     *
+     * @param max_tasks Maximal number of tasks to run in this drain.
+     * @return True if tasks remain and the caller must schedule another drain, false if the executor became idle.
+     */
+    bool drain(size_t max_tasks);
+
+    /**
+     * @brief Blocks submissions and drains until unlock_after_fork, so a fork() copies the executor in a consistent state.
+     */
+    void lock_for_fork();
+
+    /**
+     * @brief Releases the executor blocked by lock_for_fork. In the child of the fork, the pending tasks are dropped
+     * and the executor becomes idle, since the drain scheduled in the parent does not exist there.
+     *
+     * @param is_child Whether the caller is the child of the fork.
+     */
+    void unlock_after_fork(bool is_child);
+
+private:
+    std::mutex m_mutex;
+    std::deque<std::function<void()>> m_pending;
+    bool m_is_scheduled{false};
+};
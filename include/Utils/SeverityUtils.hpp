@@ -1,11 +1,30 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <array>
 #include <cstdint>
 
 #include "Models/Severity.hpp"
 
+/**
+ * @brief Gets the name of a severity from a constant table, without building a string.
+ *
+ * @param severity The severity level.
+ * @return Name of the severity, or "UnknownSeverity" outside Debug to Fatal.
+ */
+constexpr std::string_view severity_name(const Severity severity)
+{
+    constexpr std::array<std::string_view, 5> SEVERITY_NAMES = {
+        "Debug", "Info", "Warning", "Error", "Fatal"
+    };
+
+    const uint32_t index = static_cast<uint32_t>(severity);
+    if (index < SEVERITY_NAMES.size())
+        return SEVERITY_NAMES[index];
+    return "UnknownSeverity";
+}
+
 /**
  * @brief Converts a Severity enum to its string representation.
  *
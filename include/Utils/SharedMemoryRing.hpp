@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Fixed-size multi-producer, single-consumer ring of binary records in a named shared memory segment.
+ *
+ * Every process opening the same name maps the same ring (/dev/shm on POSIX, a named file mapping on Windows).
+ * Producers reserve slots with a compare-and-swap and publish them through a per-slot sequence number,
+ * so pushing and popping a record never enters the kernel. A full ring drops the record instead of blocking.
+ *
+ * A producer that dies between reserving and publishing a slot would block the consumer forever, so a slot left
+ * unpublished for STALLED_SLOT_TIMEOUT is skipped and counted as dropped. A producer merely stalled that long loses
+ * its record, and if the ring wrapped meanwhile its late copy may garble the record of the slot's next producer,
+ * which readers must therefore bounds-check.
+ */
+class SharedMemoryRing
+{
+public:
+    static constexpr size_t SLOT_SIZE = 1024;
+    static constexpr size_t DEFAULT_SLOT_COUNT = 4096;
+    static constexpr std::chrono::milliseconds STALLED_SLOT_TIMEOUT{1000};
+
+    /**
+     * @brief Opens the ring with the given name, creating and initializing it if it does not exist yet.
+     *
+     * @param name Name of the shared memory segment.
+     * @param slot_count Number of slots, a power of two, equal in every process opening the ring.
+     * @throws std::invalid_argument If the name or slot count is invalid.
+     * @throws std::runtime_error If the segment cannot be mapped or was created with another layout.
+     */
+    SharedMemoryRing(const std::string& name, size_t slot_count = DEFAULT_SLOT_COUNT);
+
+    /**
+     * @brief Destructor. Unmaps the segment, which stays available to the other processes.
+     */
+    ~SharedMemoryRing();
+
+    SharedMemoryRing(const SharedMemoryRing& other) = delete;
+    SharedMemoryRing& operator=(const SharedMemoryRing& other) = delete;
+
+    /**
+     * @brief Copies a record into the ring.
+     *
+     * @param data The record bytes.
+     * @param size The record size, at most max_record_size().
+     * @return True if the record was pushed, false if the ring was full, the record too large, or the consumer
+     * skipped the slot because this producer stalled past STALLED_SLOT_TIMEOUT.
+     */
+    bool try_push(const void* data, size_t size);
+
+    /**
+     * @brief Takes the oldest record out of the ring, skipping its slot if it stayed reserved but unpublished for
+     * STALLED_SLOT_TIMEOUT. Only one process may consume a ring.
+     *
+     * @param record Receives the record bytes.
+     * @return True if a record was popped, false if the ring was empty or its oldest slot is not published yet.
+     */
+    bool try_pop(std::vector<char>& record);
+
+    /**
+     * @brief Gets how many records producers dropped because the ring was full.
+     *
+     * @return The number of dropped records, over all processes, including the skipped stalled slots.
+     */
+    uint64_t dropped_count() const;
+
+    /**
+     * @brief Gets the largest record a slot can hold.
+     *
+     * @return The maximal record size in bytes.
+     */
+    static constexpr size_t max_record_size() { return SLOT_SIZE - 2 * sizeof(uint64_t); }
+
+    /**
+     * @brief Removes the named segment. Processes that mapped it keep their mapping.
+     *
+     * @param name Name of the shared memory segment.
+     */
+    static void remove(const std::string& name);
+
+private:
+    struct RingHeader;
+    struct RingSlot;
+
+    /**
+     * @brief Initializes the header and slots if this process created the segment, or waits for the creator.
+     */
+    void _initialize();
+
+    /**
+     * @brief Unmaps the segment from this process.
+     */
+    void _unmap();
+
+    RingSlot& _slot(uint64_t position) const;
+
+    /**
+     * @brief Checks whether the slot at a position has stayed unpublished for STALLED_SLOT_TIMEOUT, starting the
+     * timer the first time the consumer finds it unpublished.
+     *
+     * @param position The dequeue position of the unpublished slot.
+     * @return True if the slot is stalled.
+     */
+    bool _is_stalled(uint64_t position);
+
+    size_t m_slot_count;
+    size_t m_mapping_size;
+    void* m_mapping{nullptr};
+#if defined(_WIN32)
+    void* m_mapping_handle{nullptr};
+#endif
+    RingHeader* m_header{nullptr};
+    // Consumer state, local to the consuming process
+    uint64_t m_stalled_position{UINT64_MAX};
+    std::chrono::steady_clock::time_point m_stalled_since;
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+/**
+ * @brief Restricts the calling thread to a set of CPUs.
+ *
+ * @param cpu_set Indices of the CPUs the thread may run on.
+ * @return True if the affinity was applied, false if the platform does not support it or refused it.
+ */
+bool set_current_thread_affinity(const std::vector<size_t>& cpu_set);
+
+/**
+ * @brief Checks whether the calling thread may run on a CPU, which cgroup cpusets and taskset can forbid even for
+ * CPUs below std::thread::hardware_concurrency().
+ *
+ * @param cpu Index of the CPU.
+ * @return True if the CPU is in the calling thread's allowed set, or if the platform cannot tell.
+ */
+bool is_cpu_allowed(size_t cpu);
+
+/**
+ * @brief Names the calling thread, so profilers and debuggers attribute its work.
+ *
+ * @param name The thread name. Platforms with a name length limit (15 characters on Linux) truncate it.
+ */
+void set_current_thread_name(const std::string& name);
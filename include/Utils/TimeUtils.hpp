@@ -11,3 +11,9 @@
  * @return The current timestamp.
  */
 std::string get_current_timestamp();
+
+/**
+ * @brief Makes local time conversions safe to fork() during, serializing them under a mutex held around fork().
+ * Called once a logger is built with LoggerOptions::fork_safe, later calls do nothing.
+ */
+void enable_fork_safe_local_time();
@@ -1,40 +1,406 @@
 #include "CallbackLoggerClass.hpp"
 
+#include <new>
+
+namespace {
+
+std::atomic<uint64_t> next_logger_id{1};
+
+} // namespace
+
 CallbackLogger::CallbackLogger(size_t thread_count)
+    : CallbackLogger(LoggerOptions{thread_count})
 {
-    if (thread_count == 0)
+}
+
+CallbackLogger::CallbackLogger(const LoggerOptions& options)
+    : m_scheduler_mode(options.scheduler_mode), m_sink_ordering(options.sink_ordering),
+      m_high_priority_min_severity(options.high_priority_min_severity), m_lane_starvation_limit(options.lane_starvation_limit),
+      m_min_workers(options.thread_count), m_max_workers(std::max(options.thread_count, options.max_thread_count)),
+      m_live_workers(options.thread_count), m_scale_up_queue_depth(options.scale_up_queue_depth),
+      m_scale_up_queue_latency(options.scale_up_queue_latency), m_idle_thread_timeout(options.idle_thread_timeout),
+      m_pool_resize_handler(options.pool_resize_handler), m_worker_cpu_set(options.worker_cpu_set),
+      m_worker_thread_name_prefix(options.worker_thread_name_prefix), m_file_writer_options(options.file_writer),
+      m_logger_id(next_logger_id.fetch_add(1, std::memory_order_relaxed))
+{
+    if (options.lane_starvation_limit == 0)
+    {
+        throw std::invalid_argument("Lane starvation limit must be at least 1");
+    }
+    if (options.max_thread_count != 0 && options.max_thread_count < options.thread_count)
+    {
+        throw std::invalid_argument("Maximal thread count cannot be lower than the thread count");
+    }
+    if (m_max_workers > m_min_workers && (options.thread_count == 0 || m_scheduler_mode != SchedulerMode::SharedQueue))
     {
-        m_single_threaded = true;
+        throw std::invalid_argument("Adaptive thread pool requires a shared queue scheduler with at least one thread");
     }
-    else
+    const size_t cpu_count = std::thread::hardware_concurrency();
+    for (const size_t cpu : m_worker_cpu_set)
     {
-        m_single_threaded = false;
-        for (size_t worker_count = 0; worker_count < thread_count; ++worker_count)
-            m_workers.emplace_back(&CallbackLogger::_worker_thread, this);
+        if (cpu_count != 0 && cpu >= cpu_count)
+        {
+            throw std::invalid_argument("Invalid CPU in worker CPU set: " + std::to_string(cpu));
+        }
+        if (!is_cpu_allowed(cpu))
+        {
+            throw std::invalid_argument("CPU of the worker CPU set is outside the allowed CPUs of the process: " + std::to_string(cpu));
+        }
     }
+
+    m_single_threaded = options.thread_count == 0;
+    if (m_scheduler_mode == SchedulerMode::WorkStealing)
+        m_worker_queues.resize(options.thread_count);
+    _start_workers(options.thread_count);
     m_stopping = false;
 
+    if (m_single_threaded)
+    {
+        std::lock_guard<std::mutex> lock(m_register_mutex);
+        _publish_callback_snapshot();
+    }
+    if (options.fork_safe)
+    {
+        // Registered first, so their prepare handlers run after the logger's, innermost locks last
+        enable_fork_safe_component_names();
+        enable_fork_safe_local_time();
+        m_fork_registration = std::make_unique<ForkHandlerRegistration>(ForkHandlers{
+            [this] { _prepare_fork(); },
+            [this] { _unlock_after_fork(false); },
+            [this] { _complete_fork_in_child(); }});
+    }
 }
 
 CallbackLogger::~CallbackLogger()
 {
-    shutdown();
+    // Unregistered first, so a fork never runs the handlers of a logger being destroyed
+    m_fork_registration.reset();
+    (void)_shutdown(std::chrono::steady_clock::time_point::max(), false);
+    // Workers a shutdown deadline left inside a callback still use the logger once it returns
+    (void)_join_workers(std::chrono::steady_clock::time_point::max());
+}
+
+void CallbackLogger::_start_workers(const size_t thread_count)
+{
+    if (m_scheduler_mode == SchedulerMode::WorkStealing)
+    {
+        for (size_t worker_index = 0; worker_index < thread_count; ++worker_index)
+            m_workers.emplace_back(&CallbackLogger::_work_stealing_worker_thread, this, worker_index);
+        std::unique_lock<std::mutex> lock(m_queue_mutex);
+        m_queue_condition.wait(lock, [this] { return m_ready_worker_queues == m_worker_queues.size(); });
+        return;
+    }
+    for (size_t worker_count = 0; worker_count < thread_count; ++worker_count)
+        m_workers.emplace_back(&CallbackLogger::_worker_thread, this);
+}
+
+void CallbackLogger::_prepare_fork()
+{
+    m_fork_locks.emplace_back(m_register_mutex);
+    m_fork_locks.emplace_back(m_queue_mutex);
+    for (const std::unique_ptr<WorkerQueue>& worker_queue : m_worker_queues)
+        m_fork_locks.emplace_back(worker_queue->mutex);
+    m_fork_locks.emplace_back(m_flush_mutex);
+    m_fork_locks.emplace_back(m_error_handler_mutex);
+    for (const std::pair<const std::string, FileSinkPtr>& sink : m_file_sinks)
+    {
+        m_fork_locks.emplace_back(sink.second->open_mutex);
+        sink.second->executor.lock_for_fork();
+    }
+    for (const std::pair<const uint32_t, FunctionCallbackFilterPtr>& callback : m_function_callbacks)
+        callback.second->executor.lock_for_fork();
+    m_fork_locks.emplace_back(m_component_counters_mutex);
+    m_sampler.lock_for_fork();
+}
+
+void CallbackLogger::_unlock_after_fork(const bool is_child)
+{
+    m_sampler.unlock_after_fork(is_child);
+    for (const std::pair<const uint32_t, FunctionCallbackFilterPtr>& callback : m_function_callbacks)
+        callback.second->executor.unlock_after_fork(is_child);
+    for (const std::pair<const std::string, FileSinkPtr>& sink : m_file_sinks)
+        sink.second->executor.unlock_after_fork(is_child);
+    while (!m_fork_locks.empty())
+        m_fork_locks.pop_back();
+}
+
+void CallbackLogger::_complete_fork_in_child()
+{
+    // What the child copied from the parent is leaked rather than destroyed: destroying a queued task or a file
+    // writer could write the parent's buffered text a second time or join a thread of the parent.
+    // The copied condition variables may count waiters of the parent's threads, destroying them would wait for those.
+    new (&m_queue_condition) std::condition_variable();
+    new (&m_flush_condition) std::condition_variable();
+
+    for (TaskLane& lane : m_task_lanes)
+    {
+        (void)new std::queue<QueuedTask>(std::move(lane.tasks));
+        lane.tasks = {};
+        lane.skipped_count = 0;
+    }
+    m_queued_task_count = 0;
+    for (std::unique_ptr<WorkerQueue>& worker_queue : m_worker_queues)
+        (void)worker_queue.release();
+    m_ready_worker_queues = 0;
+    m_pending_tasks = 0;
+    m_sleeping_workers = 0;
+    // The parent's workers do not exist here, their thread objects are reset without joining them
+    for (std::thread& worker : m_workers)
+        new (&worker) std::thread();
+    m_workers.clear();
+    m_retired_workers.clear();
+    m_exited_workers.clear();
+    m_running_task_count = 0;
+    m_idle_workers = 0;
+    m_live_workers = m_single_threaded ? 0 : m_min_workers;
+
+    for (PaddedCounter& undelivered_tasks : m_undelivered_tasks)
+        undelivered_tasks.value.store(0);
+    m_is_flush_advancing = false;
+    m_flush_waiter_count = 0;
+
+    for (const std::pair<const std::string, FileSinkPtr>& sink : m_file_sinks)
+    {
+        if (!sink.second->writer)
+            continue;
+        (void)new std::shared_ptr<FileWriter>(std::move(sink.second->writer));
+        try
+        {
+            sink.second->writer = std::make_shared<FileWriter>(sink.second->file_path, m_file_writer_options);
+        }
+        catch (const std::exception&)
+        {
+            // The sink falls back to opening the file for every entry
+            sink.second->writer = nullptr;
+        }
+    }
+    // Registrations retire snapshots under the register mutex, none was retiring during the fork
+    m_callback_epochs.reset_after_fork();
+
+    _unlock_after_fork(true);
+    if (!m_single_threaded && !m_stopping)
+        _start_workers(m_live_workers);
 }
 
 void CallbackLogger::shutdown()
 {
+    (void)shutdown(std::chrono::steady_clock::time_point::max());
+}
+
+ShutdownReport CallbackLogger::shutdown(const std::chrono::steady_clock::time_point deadline)
+{
+    return _shutdown(deadline, true);
+}
+
+ShutdownReport CallbackLogger::_shutdown(const std::chrono::steady_clock::time_point deadline, const bool is_logging_pending_repeats)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_queue_mutex);
+        if (m_is_shutting_down)
+        {
+            m_queue_condition.wait(lock, [this] { return m_is_shut_down; });
+            return m_shutdown_report;
+        }
+        m_is_shutting_down = true;
+    }
+    if (is_logging_pending_repeats)
+        _log_pending_repeats();
+    ShutdownReport report;
+    if (!m_single_threaded)
+        report.is_drained = _wait_for_delivered_tasks(deadline);
     {
         std::unique_lock<std::mutex> lock(m_queue_mutex);
+        // Workers still running a callback finish it, the tasks they take afterwards are dropped
+        if (!report.is_drained)
+            m_is_discarding = true;
         m_stopping = true;
         m_queue_condition.notify_all();
     }
-    for (std::thread& worker : m_workers)
-        if (worker.joinable()) worker.join();
+    report.stuck_workers = _join_workers(deadline);
+    if (!m_single_threaded)
+    {
+        // With the other workers gone, the tasks still counted as undelivered are the dropped ones and the one
+        // each stuck worker is running
+        const uint64_t undelivered_count = m_undelivered_tasks[0].value.load() + m_undelivered_tasks[1].value.load();
+        report.dropped_tasks = undelivered_count - std::min<uint64_t>(undelivered_count, report.stuck_workers);
+    }
+    _flush_file_writers();
+
+    FlightRecorder* flight_recorder = m_flight_recorder.load(std::memory_order_acquire);
+    if (flight_recorder != nullptr && m_flight_recorder_options.dump_on_shutdown)
+        (void)flight_recorder->dump();
+    {
+        std::lock_guard<std::mutex> lock(m_queue_mutex);
+        m_shutdown_report = report;
+        m_is_shut_down = true;
+        m_queue_condition.notify_all();
+    }
+    return report;
+}
+
+size_t CallbackLogger::_join_workers(const std::chrono::steady_clock::time_point deadline)
+{
+    std::vector<std::thread> exited_workers;
+    size_t stuck_worker_count = 0;
+    {
+        std::unique_lock<std::mutex> lock(m_queue_mutex);
+        const auto has_exited = [this](const std::thread& worker) {
+            const std::thread::id worker_id = worker.get_id();
+            return std::find(m_exited_workers.begin(), m_exited_workers.end(), worker_id) != m_exited_workers.end()
+                || std::find(m_retired_workers.begin(), m_retired_workers.end(), worker_id) != m_retired_workers.end();
+        };
+        while (true)
+        {
+            const size_t exited_count = static_cast<size_t>(std::count_if(m_workers.begin(), m_workers.end(), has_exited));
+            if (exited_count == m_workers.size())
+                break;
+            const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            if (now >= deadline && exited_count + m_running_task_count.load() >= m_workers.size())
+            {
+                stuck_worker_count = m_workers.size() - exited_count;
+                break;
+            }
+            if (deadline == std::chrono::steady_clock::time_point::max())
+                m_queue_condition.wait(lock);
+            else
+                m_queue_condition.wait_until(lock, std::max(deadline, now + STUCK_WORKER_POLL_INTERVAL));
+        }
+        const auto stuck_end = std::partition(m_workers.begin(), m_workers.end(),
+            [&has_exited](const std::thread& worker) { return !has_exited(worker); });
+        exited_workers.assign(std::make_move_iterator(stuck_end), std::make_move_iterator(m_workers.end()));
+        m_workers.erase(stuck_end, m_workers.end());
+    }
+    for (std::thread& worker : exited_workers)
+        worker.join();
+    return stuck_worker_count;
+}
+
+void CallbackLogger::_mark_worker_exited()
+{
+    m_exited_workers.push_back(std::this_thread::get_id());
+    m_queue_condition.notify_all();
+}
+
+bool CallbackLogger::flush(const std::chrono::milliseconds timeout)
+{
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    // A timeout too long to add to the current time waits without deadline
+    const std::chrono::steady_clock::time_point deadline =
+        (timeout >= std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::time_point::max() - now))
+            ? std::chrono::steady_clock::time_point::max() : now + timeout;
+    _log_pending_repeats();
+    if (!m_single_threaded && !_wait_for_delivered_tasks(deadline))
+        return false;
+    _flush_file_writers();
+    return true;
+}
+
+void CallbackLogger::_log_pending_repeats()
+{
+    m_call_site_rate_limiter.take_suppressed_counts([this](const RateLimitedCallSite& call_site, const uint64_t suppressed_count) {
+        _log_repeated_entries(call_site, suppressed_count);
+    });
+}
+
+size_t CallbackLogger::_reserve_undelivered_task()
+{
+    while (true)
+    {
+        const uint64_t generation = m_flush_generation.load(std::memory_order_seq_cst);
+        const size_t generation_slot = generation % m_undelivered_tasks.size();
+        m_undelivered_tasks[generation_slot].value.fetch_add(1, std::memory_order_seq_cst);
+        // Unchanged generation: a flush advancing it afterwards sees this task in the slot it waits for
+        if (m_flush_generation.load(std::memory_order_seq_cst) == generation)
+            return generation_slot;
+        _complete_undelivered_tasks(generation_slot, 1);
+    }
+}
+
+void CallbackLogger::_complete_undelivered_tasks(const size_t generation_slot, const uint64_t count)
+{
+    const uint64_t previous_count = m_undelivered_tasks[generation_slot].value.fetch_sub(count, std::memory_order_seq_cst);
+    if (previous_count == count && m_flush_waiter_count.load(std::memory_order_seq_cst) != 0)
+    {
+        std::lock_guard<std::mutex> lock(m_flush_mutex);
+        m_flush_condition.notify_all();
+    }
+}
+
+bool CallbackLogger::_wait_for_delivered_tasks(const std::chrono::steady_clock::time_point deadline)
+{
+    // Counted before checking the slots, so a task completing afterwards knows it has to notify
+    m_flush_waiter_count.fetch_add(1, std::memory_order_seq_cst);
+    bool is_delivered = false;
+    {
+        std::unique_lock<std::mutex> lock(m_flush_mutex);
+        if (_wait_for_flush_condition(lock, deadline, [this] { return !m_is_flush_advancing; }))
+        {
+            m_is_flush_advancing = true;
+            // Tasks left over by a flush that timed out share their slot with the next generation, they are waited
+            // for before the generation advances so a slot never mixes the tasks of a flush with later ones
+            const uint64_t generation = m_flush_generation.load(std::memory_order_seq_cst);
+            const auto is_slot_empty = [this](const size_t generation_slot) {
+                return [this, generation_slot] {
+                    return m_undelivered_tasks[generation_slot].value.load(std::memory_order_seq_cst) == 0;
+                };
+            };
+            if (_wait_for_flush_condition(lock, deadline, is_slot_empty((generation + 1) % m_undelivered_tasks.size())))
+            {
+                m_flush_generation.store(generation + 1, std::memory_order_seq_cst);
+                is_delivered = _wait_for_flush_condition(lock, deadline,
+                                                         is_slot_empty(generation % m_undelivered_tasks.size()));
+            }
+            m_is_flush_advancing = false;
+            m_flush_condition.notify_all();
+        }
+    }
+    m_flush_waiter_count.fetch_sub(1, std::memory_order_seq_cst);
+    return is_delivered;
+}
+
+template <typename Predicate>
+bool CallbackLogger::_wait_for_flush_condition(std::unique_lock<std::mutex>& lock,
+                                               const std::chrono::steady_clock::time_point deadline, Predicate predicate)
+{
+    if (deadline == std::chrono::steady_clock::time_point::max())
+    {
+        m_flush_condition.wait(lock, predicate);
+        return true;
+    }
+    return m_flush_condition.wait_until(lock, deadline, predicate);
+}
+
+void CallbackLogger::enable_flight_recorder(const FlightRecorderOptions& options)
+{
+    std::lock_guard<std::mutex> lock(m_register_mutex);
+    if (m_flight_recorder_owner)
+    {
+        throw std::runtime_error("Flight recorder is already enabled");
+    }
+    m_flight_recorder_owner = std::make_unique<FlightRecorder>(options.dump_path, options.records_per_thread);
+    if (options.install_crash_handler)
+        m_flight_recorder_owner->install_crash_handler();
+    m_flight_recorder_options = options;
+    m_flight_recorder.store(m_flight_recorder_owner.get(), std::memory_order_release);
+}
+
+bool CallbackLogger::dump_flight_recorder() const
+{
+    const FlightRecorder* flight_recorder = m_flight_recorder.load(std::memory_order_acquire);
+    return flight_recorder != nullptr && flight_recorder->dump();
 }
 
 uint32_t CallbackLogger::register_function_callback(
     const LogCallback& callback,
     const std::unordered_map<ComponentEnumEntry, Severity, ComponentEnumEntryHasher>& filter)
+{
+    return register_function_callback(callback, filter, MessageFilter{});
+}
+
+uint32_t CallbackLogger::register_function_callback(
+    const LogCallback& callback,
+    const std::unordered_map<ComponentEnumEntry, Severity, ComponentEnumEntryHasher>& filter,
+    const MessageFilter& message_filter)
 {
     if (!callback)
     {
@@ -47,10 +413,13 @@ uint32_t CallbackLogger::register_function_callback(
             throw std::invalid_argument("Invalid severity in filter map for function callback registration");
         }
     }
+    std::shared_ptr<const MessageMatcher> message_matcher = _compile_message_filter(message_filter);
     std::lock_guard<std::mutex> lock(m_register_mutex);
     uint32_t handle = m_next_callback_handle++;
-    m_function_callbacks[handle] = std::make_shared<FunctionCallbackFilter>(
-        FunctionCallbackFilter{callback, filter});
+    FunctionCallbackFilterPtr callback_filter(new FunctionCallbackFilter{callback, filter, handle});
+    callback_filter->message_matcher = std::move(message_matcher);
+    m_function_callbacks[handle] = callback_filter;
+    _publish_callback_snapshot();
     return handle;
 }
 
@@ -71,6 +440,14 @@ uint32_t CallbackLogger::register_function_callback(
 uint32_t CallbackLogger::register_function_callback(
     const LogCallback& callback,
     const Severity min_severity)
+{
+    return register_function_callback(callback, min_severity, MessageFilter{});
+}
+
+uint32_t CallbackLogger::register_function_callback(
+    const LogCallback& callback,
+    const Severity min_severity,
+    const MessageFilter& message_filter)
 {
     if (!callback)
     {
@@ -80,10 +457,13 @@ uint32_t CallbackLogger::register_function_callback(
     {
         throw std::invalid_argument("Invalid severity for function callback registration");
     }
+    std::shared_ptr<const MessageMatcher> message_matcher = _compile_message_filter(message_filter);
     std::lock_guard<std::mutex> lock(m_register_mutex);
     uint32_t handle = m_next_callback_handle++;
-    m_function_callbacks[handle] = std::make_shared<FunctionCallbackFilter>(
-        FunctionCallbackFilter{callback, min_severity});
+    FunctionCallbackFilterPtr callback_filter(new FunctionCallbackFilter{callback, min_severity, handle});
+    callback_filter->message_matcher = std::move(message_matcher);
+    m_function_callbacks[handle] = callback_filter;
+    _publish_callback_snapshot();
     return handle;
 }
 
@@ -100,6 +480,28 @@ uint32_t CallbackLogger::register_file_callback(
     const std::string& filename,
     const std::unordered_map<ComponentEnumEntry, Severity, ComponentEnumEntryHasher>& filter)
 {
+    return register_file_callback(filename, filter, MessageFilter{});
+}
+
+uint32_t CallbackLogger::register_file_callback(
+    const std::string& filename,
+    const std::unordered_map<ComponentEnumEntry, Severity, ComponentEnumEntryHasher>& filter,
+    const MessageFilter& message_filter,
+    const FileFormat format)
+{
+    return register_file_callback(filename, filter, message_filter, make_log_formatter(format));
+}
+
+uint32_t CallbackLogger::register_file_callback(
+    const std::string& filename,
+    const std::unordered_map<ComponentEnumEntry, Severity, ComponentEnumEntryHasher>& filter,
+    const MessageFilter& message_filter,
+    LogFormatterPtr formatter)
+{
+    if (!formatter)
+    {
+        throw std::invalid_argument("Formatter of file callback cannot be null");
+    }
     std::ofstream file_stream(filename, std::ios::app);
     if (!file_stream)
     {
@@ -114,10 +516,13 @@ uint32_t CallbackLogger::register_file_callback(
         }
     }
 
+    std::shared_ptr<const MessageMatcher> message_matcher = _compile_message_filter(message_filter);
     std::lock_guard<std::mutex> lock(m_register_mutex);
     uint32_t handle = m_next_callback_handle++;
-    m_file_callbacks[handle] = std::make_shared<FileCallBackFilter>(
-        FileCallBackFilter{filename, filter});
+    FileCallbackFilterPtr callback_filter(new FileCallBackFilter{filename, filter, handle});
+    callback_filter->message_matcher = std::move(message_matcher);
+    callback_filter->formatter = std::move(formatter);
+    _add_file_callback(callback_filter);
     return handle;
 }
 
@@ -135,14 +540,39 @@ uint32_t CallbackLogger::register_file_callback(
     const std::string& filename,
     const Severity min_severity)
 {
+    return register_file_callback(filename, min_severity, MessageFilter{});
+}
+
+uint32_t CallbackLogger::register_file_callback(
+    const std::string& filename,
+    const Severity min_severity,
+    const MessageFilter& message_filter,
+    const FileFormat format)
+{
+    return register_file_callback(filename, min_severity, message_filter, make_log_formatter(format));
+}
+
+uint32_t CallbackLogger::register_file_callback(
+    const std::string& filename,
+    const Severity min_severity,
+    const MessageFilter& message_filter,
+    LogFormatterPtr formatter)
+{
+    if (!formatter)
+    {
+        throw std::invalid_argument("Formatter of file callback cannot be null");
+    }
     if (min_severity < Severity::Debug || min_severity > Severity::Fatal)
     {
         throw std::invalid_argument("Invalid severity for file callback registration");
     }
+    std::shared_ptr<const MessageMatcher> message_matcher = _compile_message_filter(message_filter);
     std::lock_guard<std::mutex> lock(m_register_mutex);
     uint32_t handle = m_next_callback_handle++;
-    m_file_callbacks[handle] = std::make_shared<FileCallBackFilter>(
-        FileCallBackFilter{filename, min_severity});
+    FileCallbackFilterPtr callback_filter(new FileCallBackFilter{filename, min_severity, handle});
+    callback_filter->message_matcher = std::move(message_matcher);
+    callback_filter->formatter = std::move(formatter);
+    _add_file_callback(callback_filter);
     return handle;
 }
 
@@ -155,6 +585,110 @@ uint32_t CallbackLogger::register_file_callback(const std::string& filename, con
     return register_file_callback(filename, std::set<ComponentEnumEntry>{component});
 }
 
+uint32_t CallbackLogger::register_function_callback(const LogCallback& callback, const ComponentSubtreeFilter& subtree_filter)
+{
+    return register_function_callback(callback, subtree_filter, MessageFilter{});
+}
+
+uint32_t CallbackLogger::register_function_callback(const LogCallback& callback, const ComponentSubtreeFilter& subtree_filter,
+                                                    const MessageFilter& message_filter)
+{
+    if (!callback)
+    {
+        throw std::invalid_argument("Function callback cannot be null");
+    }
+    _validate_subtree_filter(subtree_filter, "function");
+    std::shared_ptr<const MessageMatcher> message_matcher = _compile_message_filter(message_filter);
+    std::lock_guard<std::mutex> lock(m_register_mutex);
+    uint32_t handle = m_next_callback_handle++;
+    FunctionCallbackFilterPtr callback_filter(new FunctionCallbackFilter{callback, {}, handle});
+    callback_filter->message_matcher = std::move(message_matcher);
+    callback_filter->subtree_roots = subtree_filter.roots;
+    _expand_subtree_filter(*callback_filter);
+    m_function_callbacks[handle] = callback_filter;
+    _publish_callback_snapshot();
+    return handle;
+}
+
+uint32_t CallbackLogger::register_file_callback(const std::string& filename, const ComponentSubtreeFilter& subtree_filter)
+{
+    return register_file_callback(filename, subtree_filter, MessageFilter{});
+}
+
+uint32_t CallbackLogger::register_file_callback(const std::string& filename, const ComponentSubtreeFilter& subtree_filter,
+                                                const MessageFilter& message_filter, const FileFormat format)
+{
+    return register_file_callback(filename, subtree_filter, message_filter, make_log_formatter(format));
+}
+
+uint32_t CallbackLogger::register_file_callback(const std::string& filename, const ComponentSubtreeFilter& subtree_filter,
+                                                const MessageFilter& message_filter, LogFormatterPtr formatter)
+{
+    if (filename.empty())
+    {
+        throw std::invalid_argument("Filename for file callback cannot be empty");
+    }
+    if (!formatter)
+    {
+        throw std::invalid_argument("Formatter of file callback cannot be null");
+    }
+    _validate_subtree_filter(subtree_filter, "file");
+    std::shared_ptr<const MessageMatcher> message_matcher = _compile_message_filter(message_filter);
+    std::lock_guard<std::mutex> lock(m_register_mutex);
+    uint32_t handle = m_next_callback_handle++;
+    FileCallbackFilterPtr callback_filter(new FileCallBackFilter{filename, {}, handle});
+    callback_filter->message_matcher = std::move(message_matcher);
+    callback_filter->formatter = std::move(formatter);
+    callback_filter->subtree_roots = subtree_filter.roots;
+    _expand_subtree_filter(*callback_filter);
+    _add_file_callback(callback_filter);
+    return handle;
+}
+
+void CallbackLogger::_validate_subtree_filter(const ComponentSubtreeFilter& subtree_filter, const char* callback_kind)
+{
+    if (subtree_filter.roots.empty())
+    {
+        throw std::invalid_argument("Subtree filter must have at least one root");
+    }
+    for (const std::pair<const ComponentEnumEntry, Severity>& root : subtree_filter.roots)
+    {
+        if (root.second < Severity::Debug || root.second > Severity::Fatal)
+        {
+            throw std::invalid_argument(std::string("Invalid severity in subtree filter for ") + callback_kind
+                                        + " callback registration");
+        }
+    }
+}
+
+void CallbackLogger::set_component_parent(const ComponentEnumEntry& component, const ComponentEnumEntry& parent)
+{
+    std::lock_guard<std::mutex> lock(m_register_mutex);
+    if (is_component_ancestor(m_component_parents, component, parent))
+    {
+        throw std::invalid_argument("Component parent would create a cycle: " + component.to_string() + " -> " + parent.to_string());
+    }
+    m_component_parents.insert_or_assign(component, parent);
+
+    for (const std::pair<const uint32_t, FunctionCallbackFilterPtr>& callback : m_function_callbacks)
+        if (!callback.second->subtree_roots.empty())
+            _expand_subtree_filter(*callback.second);
+    for (const std::pair<const uint32_t, FileCallbackFilterPtr>& callback : m_file_callbacks)
+        if (!callback.second->subtree_roots.empty())
+            _expand_subtree_filter(*callback.second);
+    _publish_callback_snapshot();
+}
+
+template <typename CallbackT>
+void CallbackLogger::_expand_subtree_filter(CallbackT& callback) const
+{
+    // Workers may be matching against the previous table, so it is replaced rather than modified
+    std::atomic_store(&callback.subtree_filter,
+        std::shared_ptr<const std::unordered_map<ComponentEnumEntry, Severity, ComponentEnumEntryHasher>>(
+            std::make_shared<std::unordered_map<ComponentEnumEntry, Severity, ComponentEnumEntryHasher>>(
+                expand_subtree_filter(callback.subtree_roots, m_component_parents))));
+}
+
 void CallbackLogger::unregister_function_callback(uint32_t handle)
 {
     std::lock_guard<std::mutex> lock(m_register_mutex);
@@ -163,20 +697,134 @@ void CallbackLogger::unregister_function_callback(uint32_t handle)
         throw std::runtime_error("Callback handle not found: " + std::to_string(handle));
     }
     m_function_callbacks.erase(handle);
+    _publish_callback_snapshot();
 }
 
 void CallbackLogger::unregister_file_callback(uint32_t handle)
 {
+    // Declared before the lock so the writer of the last callback of a file is flushed and closed after unlocking
+    FileSinkPtr removed_sink;
     std::lock_guard<std::mutex> lock(m_register_mutex);
-    if (m_file_callbacks.find(handle) == m_file_callbacks.end())
+    const auto callback_iterator = m_file_callbacks.find(handle);
+    if (callback_iterator == m_file_callbacks.end())
     {
         throw std::runtime_error("Callback handle not found: " + std::to_string(handle));
     }
-    m_file_callbacks.erase(handle);
+    removed_sink = _remove_file_callback(callback_iterator->second);
+    m_file_callbacks.erase(callback_iterator);
+    _publish_callback_snapshot();
+}
+
+void CallbackLogger::_add_file_callback(const FileCallbackFilterPtr& callback)
+{
+    const std::string sink_path = canonical_file_path(callback->file_path);
+    auto sink_iterator = m_file_sinks.find(sink_path);
+    if (sink_iterator == m_file_sinks.end())
+    {
+        FileSinkPtr sink = std::make_shared<FileSink>();
+        sink->file_path = callback->file_path;
+        sink->formatter = callback->formatter;
+        if (m_file_writer_options.backend != FileWriterBackend::OpenPerEntry)
+            sink->writer = std::make_shared<FileWriter>(callback->file_path, m_file_writer_options);
+        sink->callbacks = std::make_shared<const std::vector<FileCallbackFilterPtr>>();
+        sink_iterator = m_file_sinks.emplace(sink_path, std::move(sink)).first;
+    }
+    FileSink& sink = *sink_iterator->second;
+    if (!sink.formatter->has_same_layout(*callback->formatter))
+    {
+        throw std::invalid_argument("Log file is already written with another layout: " + callback->file_path);
+    }
+    std::vector<FileCallbackFilterPtr> callbacks(*sink.callbacks);
+    callbacks.push_back(callback);
+    sink.callbacks = std::make_shared<const std::vector<FileCallbackFilterPtr>>(std::move(callbacks));
+    m_file_callbacks[callback->handle] = callback;
+    _publish_callback_snapshot();
+}
+
+FileSinkPtr CallbackLogger::_remove_file_callback(const FileCallbackFilterPtr& callback)
+{
+    // Sinks are searched rather than looked up by path, whose canonical form may have changed since registration
+    for (auto sink_iterator = m_file_sinks.begin(); sink_iterator != m_file_sinks.end(); ++sink_iterator)
+    {
+        FileSink& sink = *sink_iterator->second;
+        std::vector<FileCallbackFilterPtr> callbacks(*sink.callbacks);
+        const auto callback_iterator = std::find(callbacks.begin(), callbacks.end(), callback);
+        if (callback_iterator == callbacks.end())
+            continue;
+        if (callbacks.size() == 1)
+        {
+            FileSinkPtr removed_sink = std::move(sink_iterator->second);
+            m_file_sinks.erase(sink_iterator);
+            return removed_sink;
+        }
+        callbacks.erase(callback_iterator);
+        sink.callbacks = std::make_shared<const std::vector<FileCallbackFilterPtr>>(std::move(callbacks));
+        return nullptr;
+    }
+    return nullptr;
 }
 
 void CallbackLogger::log(const Severity severity, const ComponentEnumEntry& component, const std::string& message,
                          const std::string& file, const uint32_t line)
+{
+    static const LogFields NO_FIELDS{};
+    log(severity, component, message, NO_FIELDS, file, line);
+}
+
+void CallbackLogger::log(const Severity severity, const ComponentEnumEntry& component, const std::string& message,
+                         const LogFields& fields, const std::string& file, const uint32_t line)
+{
+    _validate_log_arguments(severity, message, file, line);
+    if (fields.truncated_count() != 0)
+        m_truncated_fields.add(fields.truncated_count());
+
+    // The flight recorder keeps every entry, including the ones sampling and rate limiting drop
+    FlightRecorder* flight_recorder = m_flight_recorder.load(std::memory_order_acquire);
+    if (flight_recorder != nullptr)
+    {
+        flight_recorder->record(severity, component, message, file, line);
+        if (severity == Severity::Fatal && m_flight_recorder_options.dump_on_fatal)
+            (void)flight_recorder->dump();
+    }
+
+    if (m_sampler.is_enabled() && !m_sampler.should_keep(severity, component))
+    {
+        m_sampled_out_per_severity[static_cast<size_t>(severity)].add();
+        return;
+    }
+    if (m_call_site_rate_limiter.is_enabled())
+    {
+        const uint64_t call_site = _call_site_key(component, file, line);
+        const RateLimitDecision decision = m_call_site_rate_limiter.admit(call_site,
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+        if (!decision.is_admitted)
+        {
+            m_rate_limited.add();
+            if (decision.needs_call_site)
+                m_call_site_rate_limiter.describe_call_site(call_site, RateLimitedCallSite{severity, component, file, line});
+            return;
+        }
+        if (decision.suppressed_count > 0)
+            _log_repeated_entries(RateLimitedCallSite{severity, component, file, line}, decision.suppressed_count);
+    }
+    _log_entry(LogEntry{severity, component, message, file, line, get_current_timestamp(), fields});
+}
+
+void CallbackLogger::_log_repeated_entries(const RateLimitedCallSite& call_site, const uint64_t suppressed_count)
+{
+    _log_entry(LogEntry{call_site.severity, call_site.component,
+                        "Last message repeated " + std::to_string(suppressed_count) + " times",
+                        call_site.file, call_site.line, get_current_timestamp()});
+}
+
+void CallbackLogger::log_entry(const LogEntry& entry)
+{
+    _validate_log_arguments(entry.severity, entry.message, entry.file, entry.line);
+    _log_entry(LogEntry(entry));
+}
+
+void CallbackLogger::_validate_log_arguments(const Severity severity, const std::string& message, const std::string& file,
+                                             const uint32_t line)
 {
     if (message.empty())
     {
@@ -194,19 +842,25 @@ void CallbackLogger::log(const Severity severity, const ComponentEnumEntry& comp
     {
         throw std::runtime_error("Invalid severity level: " + std::to_string(static_cast<int>(severity)));
     }
+}
 
-    const LogEntry entry{severity, component, message, file, line, get_current_timestamp()};
+void CallbackLogger::_log_entry(LogEntry&& log_entry)
+{
     if (m_single_threaded)
     {
-        _single_threaded_log(entry);
+        _count_logged_entry(log_entry);
+        _single_threaded_log(log_entry);
     } else {
+        // One pooled entry is shared by every task instead of copying it per callback
+        const LogEntryPtr entry = std::allocate_shared<LogEntry>(LogEntryPoolAllocator<LogEntry>(), std::move(log_entry));
+        _count_logged_entry(*entry);
         _async_log(entry);
     }
 }
 
 bool CallbackLogger::_is_matching_callback_filter(
     const std::variant<std::unordered_map<ComponentEnumEntry, Severity, ComponentEnumEntryHasher>, Severity>& filter,
-    const Severity severity, const ComponentEnumEntry component) const
+    const Severity severity, const ComponentEnumEntry& component) const
 {
     if (std::holds_alternative<Severity>(filter))
     {
@@ -222,101 +876,721 @@ bool CallbackLogger::_is_matching_callback_filter(
     return false;
 }
 
-void CallbackLogger::_async_log(const LogEntry& entry)
+template <typename CallbackT>
+bool CallbackLogger::_is_matching_callback(const CallbackT& callback, const Severity severity,
+                                           const ComponentEnumEntry& component) const
 {
-    std::vector<FunctionCallbackFilterPtr> function_callbacks;
-    std::vector<FileCallbackFilterPtr> file_callbacks;
-    {
+    if (callback.subtree_roots.empty())
+        return _is_matching_callback_filter(callback.filter, severity, component);
+
+    const std::shared_ptr<const std::unordered_map<ComponentEnumEntry, Severity, ComponentEnumEntryHasher>> subtree_filter =
+        std::atomic_load(&callback.subtree_filter);
+    auto component_iterator = subtree_filter->find(component);
+    return component_iterator != subtree_filter->end() && severity >= component_iterator->second;
+}
+
+template <typename CallbackT>
+bool CallbackLogger::_is_matching_callback_view(const CallbackView<CallbackT>& view, const Severity severity,
+                                                const ComponentEnumEntry& component) const
+{
+    if (view.subtree_filter == nullptr)
+        return _is_matching_callback_filter(view.callback->filter, severity, component);
+    auto component_iterator = view.subtree_filter->find(component);
+    return component_iterator != view.subtree_filter->end() && severity >= component_iterator->second;
+}
+
+template <typename CallbackT>
+bool CallbackLogger::_is_matching_message(const CallbackT& callback, const std::string& message)
+{
+    return !callback.message_matcher || callback.message_matcher->matches(message);
+}
+
+std::shared_ptr<const MessageMatcher> CallbackLogger::_compile_message_filter(const MessageFilter& message_filter)
+{
+    if (message_filter.type == MessageFilterType::None)
+        return nullptr;
+    return std::make_shared<const MessageMatcher>(message_filter);
+}
+
+template <typename CallbackT, typename Invocation>
+void CallbackLogger::_run_callback(CallbackT& callback, const char* callback_kind, Invocation&& invocation)
+{
+    CallbackCounters& counters = callback.counters;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    try
+    {
+        invocation();
+        if (counters.consecutive_exceptions.load(std::memory_order_relaxed) != 0)
+            counters.consecutive_exceptions.store(0, std::memory_order_relaxed);
+    }
+    catch (const std::exception& e)
+    {
+        _handle_callback_exception(callback.handle, counters, callback_kind, e.what());
+    }
+    catch (...)
+    {
+        _handle_callback_exception(callback.handle, counters, callback_kind, "Unknown exception");
+    }
+    counters.record_invocation(std::chrono::steady_clock::now() - start);
+}
+
+void CallbackLogger::_handle_callback_exception(const uint32_t handle, CallbackCounters& counters,
+                                                const char* callback_kind, const char* message)
+{
+    counters.exceptions.add();
+    const uint32_t consecutive_exceptions = counters.consecutive_exceptions.fetch_add(1, std::memory_order_relaxed) + 1;
+    const uint32_t failure_threshold = m_callback_failure_threshold.load(std::memory_order_relaxed);
+    const bool is_disabled_now = (failure_threshold != 0) && (consecutive_exceptions >= failure_threshold)
+        && !counters.is_disabled.exchange(true, std::memory_order_relaxed);
+
+    // Report at most once per interval per callback, a callback failing on every entry must not flood the error sink
+    const int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    int64_t last_report_ns = counters.last_error_report_ns.load(std::memory_order_relaxed);
+    const bool is_interval_elapsed = (last_report_ns == 0)
+        || (now_ns - last_report_ns >= m_error_report_interval_ns.load(std::memory_order_relaxed));
+    const bool should_report = is_interval_elapsed
+        && counters.last_error_report_ns.compare_exchange_strong(last_report_ns, now_ns, std::memory_order_relaxed);
+    if (!should_report && !is_disabled_now)
+    {
+        counters.suppressed_error_reports.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const CallbackError error{handle, callback_kind, message, counters.exceptions.load(),
+                              counters.suppressed_error_reports.exchange(0, std::memory_order_relaxed),
+                              counters.is_disabled.load(std::memory_order_relaxed)};
+    // Called outside the lock, so a handler may log through this logger, and failing workers report concurrently
+    CallbackErrorHandler error_handler;
+    {
+        std::lock_guard<std::mutex> lock(m_error_handler_mutex);
+        error_handler = m_error_handler;
+    }
+    if (error_handler)
+    {
+        try
+        {
+            error_handler(error);
+        }
+        catch (...)
+        {
+            // The failure was already counted, a throwing handler only loses its own report
+        }
+        return;
+    }
+    std::cerr << "[!] Exception while handling " << error.callback_kind << " callback " << error.handle << ": "
+              << error.message << " (" << error.exception_count << " total, " << error.suppressed_count
+              << " suppressed" << (error.is_disabled ? ", callback disabled" : "") << ")\n";
+}
+
+void CallbackLogger::_async_log(const LogEntryPtr& entry)
+{
+    std::vector<FunctionCallbackFilterPtr> function_callbacks;
+    std::vector<std::pair<FileSinkPtr, FileSinkCallbacksPtr>> file_sinks;
+    {
         std::lock_guard<std::mutex> lock(m_register_mutex);
         for (const std::pair<uint32_t, FunctionCallbackFilterPtr>& callback_pair : m_function_callbacks)
             function_callbacks.push_back(callback_pair.second);
-        for (const std::pair<uint32_t, FileCallbackFilterPtr>& callback_pair : m_file_callbacks)
-            file_callbacks.push_back(callback_pair.second);
+        for (const std::pair<const std::string, FileSinkPtr>& sink_pair : m_file_sinks)
+            file_sinks.emplace_back(sink_pair.second, sink_pair.second->callbacks);
+    }
+
+    // Keep the matching callbacks, noting whether one of them takes the entry whatever its message
+    bool is_delivery_certain = false;
+    file_sinks.erase(std::remove_if(file_sinks.begin(), file_sinks.end(),
+        [&](const std::pair<FileSinkPtr, FileSinkCallbacksPtr>& file_sink) {
+            return !_is_matching_file_sink(*file_sink.second, entry->severity, entry->component, is_delivery_certain);
+        }), file_sinks.end());
+    function_callbacks.erase(std::remove_if(function_callbacks.begin(), function_callbacks.end(),
+        [&](const FunctionCallbackFilterPtr& callback) {
+            if (callback->counters.is_disabled.load(std::memory_order_relaxed)
+                || !_is_matching_callback(*callback, entry->severity, entry->component))
+                return true;
+            is_delivery_certain = is_delivery_certain || !callback->message_matcher;
+            return false;
+        }), function_callbacks.end());
+
+    const size_t matched_count = file_sinks.size() + function_callbacks.size();
+    if (matched_count == 0)
+    {
+        m_filtered_out.add();
+        return;
     }
+    // When every matching callback filters messages, the workers may still reject the entry everywhere: the tasks
+    // then share a count of the rejections left, and the last rejection counts the entry as filtered out
+    std::shared_ptr<std::atomic<size_t>> pending_rejections;
+    if (!is_delivery_certain)
+        pending_rejections = std::make_shared<std::atomic<size_t>>(matched_count);
 
-    // Enqueue a task for each callback
+    // Build a task for each matching callback, and a single one for the callbacks sharing a file
+    const size_t generation_slot = _reserve_undelivered_task();
+    LaneTasks tasks;
+    for (const std::pair<FileSinkPtr, FileSinkCallbacksPtr>& file_sink : file_sinks)
     {
+        const FileSinkPtr& sink = file_sink.first;
+        const FileSinkCallbacksPtr& callbacks = file_sink.second;
+        // A shared file is scheduled in the highest lane of its callbacks
+        CallbackPriority sink_priority = CallbackPriority::Low;
+        for (const FileCallbackFilterPtr& callback : *callbacks)
+            sink_priority = std::max(sink_priority, callback->priority.load(std::memory_order_relaxed));
+        _schedule_callback_task(sink, [this, entry, sink, callbacks, pending_rejections, generation_slot]() {
+            if (!_write_file_sink_entry(*sink, *callbacks, *entry))
+                _count_message_rejection(pending_rejections.get());
+            _complete_undelivered_tasks(generation_slot, 1);
+        }, _task_priority(sink_priority, entry->severity), tasks);
+    }
+
+    for (const FunctionCallbackFilterPtr& callback : function_callbacks)
+    {
+        _schedule_callback_task(callback, [this, callback, entry, pending_rejections, generation_slot]() {
+            if (_is_matching_message(*callback, entry->message))
+                _run_callback(*callback, "function", [&] { callback->callback_function(*entry); });
+            else
+                _count_message_rejection(pending_rejections.get());
+            _complete_undelivered_tasks(generation_slot, 1);
+        }, _task_priority(callback->priority.load(std::memory_order_relaxed), entry->severity), tasks);
+    }
+
+    // The reserved task stands for the first one, counted before any of them can run
+    if (matched_count > 1)
+        m_undelivered_tasks[generation_slot].value.fetch_add(matched_count - 1, std::memory_order_seq_cst);
+    m_tasks_enqueued.add(matched_count);
+    _enqueue_tasks(tasks);
+}
+
+void CallbackLogger::_count_message_rejection(std::atomic<size_t>* pending_rejections)
+{
+    m_message_filter_rejections.add();
+    if (pending_rejections != nullptr && pending_rejections->fetch_sub(1, std::memory_order_acq_rel) == 1)
+        m_filtered_out.add();
+}
+
+template <typename CallbackPtrT>
+void CallbackLogger::_schedule_callback_task(const CallbackPtrT& callback, Task task, const CallbackPriority priority,
+                                             LaneTasks& tasks)
+{
+    std::vector<Task>& lane_tasks = tasks[static_cast<size_t>(priority)];
+    if (m_sink_ordering != SinkOrdering::PerSink)
+    {
+        lane_tasks.push_back(std::move(task));
+        return;
+    }
+    // Only the submitter that finds the executor idle schedules a drain, so a sink never runs on two workers at once
+    if (callback->executor.submit(std::move(task)))
+        lane_tasks.push_back(_make_drain_task(std::shared_ptr<SerialExecutor>(callback, &callback->executor), priority));
+}
+
+Task CallbackLogger::_make_drain_task(const std::shared_ptr<SerialExecutor>& executor, const CallbackPriority priority)
+{
+    return [this, executor, priority]
+    {
+        if (executor->drain(SERIAL_EXECUTOR_DRAIN_BATCH_SIZE))
+        {
+            LaneTasks tasks;
+            tasks[static_cast<size_t>(priority)].push_back(_make_drain_task(executor, priority));
+            _enqueue_tasks(tasks);
+        }
+    };
+}
+
+CallbackPriority CallbackLogger::_task_priority(const CallbackPriority callback_priority, const Severity severity) const
+{
+    if (m_high_priority_min_severity.has_value() && severity >= *m_high_priority_min_severity)
+        return CallbackPriority::High;
+    return callback_priority;
+}
+
+void CallbackLogger::_enqueue_tasks(LaneTasks& tasks)
+{
+    size_t task_count = 0;
+    for (const std::vector<Task>& lane_tasks : tasks)
+        task_count += lane_tasks.size();
+    if (task_count == 0)
+        return;
+
+    if (m_scheduler_mode == SchedulerMode::WorkStealing)
+    {
+        // Hash producers to a home worker so each producer mostly touches a single queue
+        const size_t home_worker = std::hash<std::thread::id>()(std::this_thread::get_id()) % m_worker_queues.size();
+        WorkerQueue& worker_queue = *m_worker_queues[home_worker];
+        // Counted before the tasks are published, so the pop of a published task never brings the count below 0
+        m_peak_queue_depth.store_max(m_pending_tasks.fetch_add(task_count) + task_count);
+        {
+            std::lock_guard<std::mutex> lock(worker_queue.mutex);
+            for (std::vector<Task>& lane_tasks : tasks)
+                for (Task& task : lane_tasks)
+                    worker_queue.tasks.push_back(std::move(task));
+        }
+        if (m_sleeping_workers.load() == 0)
+            return;
         std::lock_guard<std::mutex> lock(m_queue_mutex);
+        if (task_count == 1)
+            m_queue_condition.notify_one();
+        else
+            m_queue_condition.notify_all();
+        return;
+    }
 
-        for (FileCallbackFilterPtr& callback : file_callbacks)
+    size_t previous_worker_count = 0;
+    size_t grown_worker_count = 0;
+    std::vector<std::thread> retired_workers;
+    {
+        std::lock_guard<std::mutex> lock(m_queue_mutex);
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        for (size_t lane = 0; lane < tasks.size(); ++lane)
+            for (Task& task : tasks[lane])
+                m_task_lanes[lane].tasks.push(QueuedTask{std::move(task), now});
+        m_queued_task_count += task_count;
+        m_peak_queue_depth.store_max(m_queued_task_count);
+        if (_should_grow_pool(now))
         {
-            if (_is_matching_callback_filter(callback->filter, entry.severity, entry.component))
-            {
-                m_task_queue.emplace([entry, callback]() mutable {
-                    file_log_callback(entry, callback->file_path);
-                });
-            }
+            previous_worker_count = m_live_workers;
+            _spawn_worker(retired_workers);
+            grown_worker_count = m_live_workers;
         }
+    }
+    m_queue_condition.notify_all();
+    // Retired workers already reported their retirement and left their loop, joining them only reclaims the threads
+    for (std::thread& retired_worker : retired_workers)
+        retired_worker.join();
+    if (grown_worker_count != 0)
+        _report_pool_resize(previous_worker_count, grown_worker_count);
+}
+
+bool CallbackLogger::_should_grow_pool(const std::chrono::steady_clock::time_point now) const
+{
+    if (m_live_workers >= m_max_workers || m_idle_workers != 0 || m_stopping || m_queued_task_count == 0)
+        return false;
+    return (m_queued_task_count >= m_scale_up_queue_depth * m_live_workers)
+        || (now - _oldest_queued_task_time() >= m_scale_up_queue_latency);
+}
 
-        for (const FunctionCallbackFilterPtr& callback : function_callbacks)
+std::chrono::steady_clock::time_point CallbackLogger::_oldest_queued_task_time() const
+{
+    std::chrono::steady_clock::time_point oldest = std::chrono::steady_clock::time_point::max();
+    for (const TaskLane& lane : m_task_lanes)
+        if (!lane.tasks.empty())
+            oldest = std::min(oldest, lane.tasks.front().enqueued_at);
+    return oldest;
+}
+
+Task CallbackLogger::_pop_shared_queue_task()
+{
+    // A waiting lane passed over too many times is served first, the lowest one if several are starving
+    size_t selected_lane = m_task_lanes.size();
+    for (size_t lane = 0; lane < m_task_lanes.size(); ++lane)
+    {
+        if (!m_task_lanes[lane].tasks.empty() && m_task_lanes[lane].skipped_count >= m_lane_starvation_limit)
         {
-            if (_is_matching_callback_filter(callback->filter, entry.severity, entry.component))
-            {
-                m_task_queue.emplace([callback, entry]()
+            selected_lane = lane;
+            break;
+        }
+    }
+    if (selected_lane == m_task_lanes.size())
+    {
+        selected_lane = m_task_lanes.size() - 1;
+        while (m_task_lanes[selected_lane].tasks.empty())
+            --selected_lane;
+    }
+    for (size_t lane = 0; lane < selected_lane; ++lane)
+        if (!m_task_lanes[lane].tasks.empty())
+            ++m_task_lanes[lane].skipped_count;
+
+    TaskLane& lane = m_task_lanes[selected_lane];
+    lane.skipped_count = 0;
+    QueuedTask& queued_task = lane.tasks.front();
+    ++lane.dequeued_count;
+    ++lane.wait_histogram[latency_bucket(std::chrono::steady_clock::now() - queued_task.enqueued_at)];
+    Task task = std::move(queued_task.task);
+    lane.tasks.pop();
+    --m_queued_task_count;
+    return task;
+}
+
+void CallbackLogger::_spawn_worker(std::vector<std::thread>& retired_workers)
 {
-                    callback->callback_function(entry);
-                });
+    for (const std::thread::id& retired_worker_id : m_retired_workers)
+    {
+        for (auto worker_iterator = m_workers.begin(); worker_iterator != m_workers.end(); ++worker_iterator)
+        {
+            if (worker_iterator->get_id() == retired_worker_id)
+            {
+                retired_workers.push_back(std::move(*worker_iterator));
+                m_workers.erase(worker_iterator);
+                break;
             }
         }
     }
-    m_queue_condition.notify_all();
+    m_retired_workers.clear();
+    m_workers.emplace_back(&CallbackLogger::_worker_thread, this);
+    ++m_live_workers;
+}
+
+void CallbackLogger::_report_pool_resize(const size_t previous_thread_count, const size_t thread_count)
+{
+    if (!m_pool_resize_handler)
+        return;
+    try
+    {
+        m_pool_resize_handler(previous_thread_count, thread_count);
+    }
+    catch (...)
+    {
+        // The pool was already resized, a throwing handler only loses the notification
+    }
 }
 
 void CallbackLogger::_single_threaded_log(const LogEntry& entry)
 {
-    for (const std::pair<const uint32_t, FileCallbackFilterPtr>& callback : m_file_callbacks)
+    // While pinned, a registration publishes a new snapshot and this one stays alive, even if a callback registers
+    const EpochDomain::Guard guard(m_callback_epochs);
+    const CallbackSnapshot& snapshot = *m_callback_snapshot.load(std::memory_order_seq_cst);
+
+    bool is_delivered = false;
+    for (const FileSinkView& sink : snapshot.file_sinks)
     {
-        if (_is_matching_callback_filter(callback.second->filter, entry.severity, entry.component))
+        // The first callback accepting the entry writes it for the whole file, as in _write_file_sink_entry
+        bool is_sink_matching = false;
+        bool is_sink_written = false;
+        for (const CallbackView<FileCallBackFilter>& callback : sink.callbacks)
         {
-            try
-            {
-                 file_log_callback(entry, callback.second->file_path);
-            }
-            catch (const std::exception& e)
-            {
-                std::cerr << "[!] Exception while handling file callback: " << e.what() << std::endl;
-            }
-            catch (...)
+            if (callback.callback->counters.is_disabled.load(std::memory_order_relaxed)
+                || !_is_matching_callback_view(callback, entry.severity, entry.component))
+                continue;
+            is_sink_matching = true;
+            if (_is_matching_message(*callback.callback, entry.message))
             {
-                std::cerr << "[!] Unknown exception while handling file callback." << std::endl;
+                is_sink_written = true;
+                _write_file_line(*sink.sink, *callback.callback, entry);
+                break;
             }
         }
+        if (is_sink_matching && !is_sink_written)
+            _count_message_rejection(nullptr);
+        is_delivered = is_delivered || is_sink_written;
     }
 
+    for (const CallbackView<FunctionCallbackFilter>& callback : snapshot.function_callbacks)
+    {
+        if (callback.callback->counters.is_disabled.load(std::memory_order_relaxed)
+            || !_is_matching_callback_view(callback, entry.severity, entry.component))
+            continue;
+        if (!_is_matching_message(*callback.callback, entry.message))
+        {
+            _count_message_rejection(nullptr);
+            continue;
+        }
+        is_delivered = true;
+        _run_callback(*callback.callback, "function", [&] { callback.callback->callback_function(entry); });
+    }
+
+    if (!is_delivered)
+        m_filtered_out.add();
+}
+
+void CallbackLogger::_publish_callback_snapshot()
+{
+    if (!m_single_threaded)
+        return;
+    std::unique_ptr<CallbackSnapshot> snapshot = std::make_unique<CallbackSnapshot>();
+    snapshot->file_sinks.reserve(m_file_sinks.size());
+    for (const std::pair<const std::string, FileSinkPtr>& sink : m_file_sinks)
+    {
+        FileSinkView sink_view{sink.second.get(), {}};
+        sink_view.callbacks.reserve(sink.second->callbacks->size());
+        for (const FileCallbackFilterPtr& callback : *sink.second->callbacks)
+            sink_view.callbacks.push_back(_make_callback_view(callback, *snapshot));
+        snapshot->file_sinks.push_back(std::move(sink_view));
+        snapshot->owners.push_back(sink.second);
+    }
+    snapshot->function_callbacks.reserve(m_function_callbacks.size());
     for (const std::pair<const uint32_t, FunctionCallbackFilterPtr>& callback : m_function_callbacks)
+        snapshot->function_callbacks.push_back(_make_callback_view(callback.second, *snapshot));
+
+    m_callback_snapshot.store(snapshot.get(), std::memory_order_seq_cst);
+    std::unique_ptr<CallbackSnapshot> previous_snapshot = std::move(m_callback_snapshot_owner);
+    m_callback_snapshot_owner = std::move(snapshot);
+    if (previous_snapshot)
+        m_callback_epochs.retire(std::move(previous_snapshot));
+}
+
+template <typename CallbackT>
+CallbackView<CallbackT> CallbackLogger::_make_callback_view(const std::shared_ptr<CallbackT>& callback,
+                                                             CallbackSnapshot& snapshot)
+{
+    const std::shared_ptr<const std::unordered_map<ComponentEnumEntry, Severity, ComponentEnumEntryHasher>> subtree_filter =
+        callback->subtree_roots.empty() ? nullptr : std::atomic_load(&callback->subtree_filter);
+    snapshot.owners.push_back(callback);
+    if (subtree_filter)
+        snapshot.owners.push_back(subtree_filter);
+    return CallbackView<CallbackT>{callback.get(), subtree_filter.get()};
+}
+
+bool CallbackLogger::_is_matching_file_sink(const std::vector<FileCallbackFilterPtr>& callbacks, const Severity severity,
+                                            const ComponentEnumEntry& component, bool& is_delivery_certain) const
+{
+    bool is_matching = false;
+    for (const FileCallbackFilterPtr& callback : callbacks)
     {
-        if (_is_matching_callback_filter(callback.second->filter, entry.severity, entry.component))
+        if (!callback->counters.is_disabled.load(std::memory_order_relaxed)
+            && _is_matching_callback(*callback, severity, component))
         {
-            try
-            {
-                callback.second->callback_function(entry);
-            }
-            catch (const std::exception& e)
-            {
-                std::cerr << "[!] Exception while handling function callback: " << e.what() << std::endl;
-            }
-            catch (...)
+            is_matching = true;
+            if (!callback->message_matcher)
             {
-                std::cerr << "[!] Unknown exception while handling function callback." << std::endl;
+                is_delivery_certain = true;
+                return true;
             }
         }
     }
+    return is_matching;
+}
+
+bool CallbackLogger::_write_file_sink_entry(FileSink& sink, const std::vector<FileCallbackFilterPtr>& callbacks,
+                                            const LogEntry& entry)
+{
+    // The first callback accepting the entry writes it for the whole file and is credited with the invocation
+    for (const FileCallbackFilterPtr& callback : callbacks)
+    {
+        if (!callback->counters.is_disabled.load(std::memory_order_relaxed)
+            && _is_matching_callback(*callback, entry.severity, entry.component)
+            && _is_matching_message(*callback, entry.message))
+        {
+            _write_file_line(sink, *callback, entry);
+            return true;
+        }
+    }
+    return false;
+}
+
+void CallbackLogger::_write_file_line(FileSink& sink, FileCallBackFilter& callback, const LogEntry& entry)
+{
+    _run_callback(callback, "file", [&] {
+        // Reused by every entry the thread writes, so rendering only allocates while lines grow longer
+        thread_local std::string line;
+        line.clear();
+        sink.formatter->format(entry, line);
+        if (sink.writer)
+        {
+            sink.writer->write(line, entry.severity);
+            return;
+        }
+        std::lock_guard<std::mutex> lock(sink.open_mutex);
+        append_to_file(sink.file_path, line);
+    });
+}
+
+void CallbackLogger::_flush_file_writers()
+{
+    std::vector<std::shared_ptr<FileWriter>> writers;
+    {
+        std::lock_guard<std::mutex> lock(m_register_mutex);
+        for (const std::pair<const std::string, FileSinkPtr>& sink : m_file_sinks)
+            if (sink.second->writer)
+                writers.push_back(sink.second->writer);
+    }
+    for (const std::shared_ptr<FileWriter>& writer : writers)
+    {
+        try
+        {
+            writer->flush();
+        }
+        catch (...)
+        {
+            // A failing file must not prevent the other files from being flushed
+        }
+    }
+}
+
+void CallbackLogger::_count_logged_entry(const LogEntry& entry)
+{
+    m_logged_per_severity[static_cast<size_t>(entry.severity)].add();
+
+    // Each thread caches the counters it already found, so counting a known component takes no lock
+    using ComponentCounters = std::unordered_map<ComponentEnumEntry, PaddedCounter*, ComponentEnumEntryHasher>;
+    thread_local std::unordered_map<uint64_t, ComponentCounters> thread_counters;
+    const auto logger_iterator = thread_counters.find(m_logger_id);
+    if (logger_iterator != thread_counters.end())
+    {
+        const auto counter_iterator = logger_iterator->second.find(entry.component);
+        if (counter_iterator != logger_iterator->second.end())
+        {
+            counter_iterator->second->add();
+            return;
+        }
+    }
+    else if (thread_counters.size() >= MAX_CACHED_COUNTER_LOGGERS)
+    {
+        // Bounds the caches of the loggers destroyed since, the live ones are found again under the lock
+        thread_counters.clear();
+    }
+
+    PaddedCounter& counter = _find_or_add_component_counter(entry.component);
+    thread_counters[m_logger_id].emplace(entry.component, &counter);
+    counter.add();
+}
+
+PaddedCounter& CallbackLogger::_find_or_add_component_counter(const ComponentEnumEntry& component)
+{
+    std::lock_guard<std::mutex> lock(m_component_counters_mutex);
+    std::unique_ptr<PaddedCounter>& counter = m_logged_per_component[component];
+    if (!counter)
+        counter = std::make_unique<PaddedCounter>();
+    return *counter;
+}
+
+void CallbackLogger::set_error_handler(const CallbackErrorHandler& handler)
+{
+    std::lock_guard<std::mutex> lock(m_error_handler_mutex);
+    m_error_handler = handler;
+}
+
+void CallbackLogger::set_error_report_interval(const std::chrono::milliseconds interval)
+{
+    if (interval.count() < 0)
+    {
+        throw std::invalid_argument("Error report interval cannot be negative");
+    }
+    m_error_report_interval_ns.store(std::chrono::duration_cast<std::chrono::nanoseconds>(interval).count(),
+                                     std::memory_order_relaxed);
+}
+
+void CallbackLogger::set_call_site_rate_limit(const double entries_per_second, const uint32_t burst)
+{
+    m_call_site_rate_limiter.configure(entries_per_second, burst);
+}
+
+void CallbackLogger::set_sampling_rate(const Severity severity, const double rate)
+{
+    m_sampler.set_rate(severity, rate);
+}
+
+void CallbackLogger::set_sampling_rate(const ComponentEnumEntry& component, const Severity severity, const double rate)
+{
+    m_sampler.set_rate(component, severity, rate);
+}
+
+void CallbackLogger::set_thread_trace_id(const uint64_t trace_id)
+{
+    LogSampler::set_thread_trace_id(trace_id);
+}
+
+uint64_t CallbackLogger::_call_site_key(const ComponentEnumEntry& component, const std::string& file, const uint32_t line)
+{
+    uint64_t key = std::hash<std::string>()(file);
+    key = (key ^ line) * 0x9E3779B97F4A7C15ULL;
+    key = (key ^ ComponentEnumEntryHasher()(component)) * 0x9E3779B97F4A7C15ULL;
+    key ^= key >> 32;
+    // 0 marks an empty slot of the rate limiter table
+    return (key != 0) ? key : 1;
+}
+
+void CallbackLogger::set_callback_priority(const uint32_t handle, const CallbackPriority priority)
+{
+    if (priority < CallbackPriority::Low || priority >= CallbackPriority::PRIORITY_COUNT)
+    {
+        throw std::invalid_argument("Invalid callback priority");
+    }
+    std::lock_guard<std::mutex> lock(m_register_mutex);
+    const auto function_iterator = m_function_callbacks.find(handle);
+    if (function_iterator != m_function_callbacks.end())
+    {
+        function_iterator->second->priority.store(priority, std::memory_order_relaxed);
+        return;
+    }
+    const auto file_iterator = m_file_callbacks.find(handle);
+    if (file_iterator == m_file_callbacks.end())
+    {
+        throw std::runtime_error("Callback handle not found: " + std::to_string(handle));
+    }
+    file_iterator->second->priority.store(priority, std::memory_order_relaxed);
+}
+
+void CallbackLogger::set_callback_failure_threshold(const uint32_t consecutive_failures)
+{
+    m_callback_failure_threshold.store(consecutive_failures, std::memory_order_relaxed);
+}
+
+LoggerStatistics CallbackLogger::stats() const
+{
+    LoggerStatistics statistics;
+    for (size_t severity = 0; severity < m_logged_per_severity.size(); ++severity)
+        statistics.logged_per_severity[severity] = m_logged_per_severity[severity].load();
+    {
+        std::lock_guard<std::mutex> lock(m_component_counters_mutex);
+        for (const auto& component_counter : m_logged_per_component)
+            statistics.logged_per_component.emplace(component_counter.first, component_counter.second->load());
+    }
+    statistics.filtered_out = m_filtered_out.load();
+    statistics.message_filter_rejections = m_message_filter_rejections.load();
+    statistics.rate_limited = m_rate_limited.load();
+    statistics.truncated_fields = m_truncated_fields.load();
+    for (size_t severity = 0; severity < m_sampled_out_per_severity.size(); ++severity)
+        statistics.sampled_out_per_severity[severity] = m_sampled_out_per_severity[severity].load();
+    statistics.tasks_enqueued = m_tasks_enqueued.load();
+    {
+        std::lock_guard<std::mutex> lock(m_queue_mutex);
+        statistics.queue_depth = (m_scheduler_mode == SchedulerMode::WorkStealing) ? m_pending_tasks.load() : m_queued_task_count;
+        statistics.worker_count = m_live_workers;
+        for (size_t lane = 0; lane < m_task_lanes.size(); ++lane)
+        {
+            statistics.lanes[lane].queue_depth = m_task_lanes[lane].tasks.size();
+            statistics.lanes[lane].tasks_dequeued = m_task_lanes[lane].dequeued_count;
+            statistics.lanes[lane].wait_histogram = m_task_lanes[lane].wait_histogram;
+        }
+    }
+    statistics.peak_queue_depth = m_peak_queue_depth.load();
+    statistics.worker_busy_time_ns = m_worker_busy_time_ns.load();
+    statistics.unpinned_workers = m_unpinned_workers.load();
+    {
+        std::lock_guard<std::mutex> lock(m_register_mutex);
+        for (const std::pair<const uint32_t, FunctionCallbackFilterPtr>& callback : m_function_callbacks)
+            statistics.function_callbacks.emplace(callback.first, callback.second->counters.snapshot());
+        for (const std::pair<const uint32_t, FileCallbackFilterPtr>& callback : m_file_callbacks)
+            statistics.file_callbacks.emplace(callback.first, callback.second->counters.snapshot());
+    }
+    return statistics;
 }
 
 void CallbackLogger::_worker_thread()
 {
+    _configure_worker_thread();
+    const bool is_adaptive = m_max_workers > m_min_workers;
     while (true)
     {
         Task task;
         {
             std::unique_lock<std::mutex> lock(m_queue_mutex);
-            m_queue_condition.wait(lock, [this] { return m_stopping || !m_task_queue.empty(); });
-            if (m_stopping && m_task_queue.empty())
+            const auto has_work = [this] { return m_stopping || m_queued_task_count != 0; };
+            ++m_idle_workers;
+            bool is_woken = true;
+            if (is_adaptive)
+                is_woken = m_queue_condition.wait_for(lock, m_idle_thread_timeout, has_work);
+            else
+                m_queue_condition.wait(lock, has_work);
+            --m_idle_workers;
+            if (!is_woken)
+            {
+                if (m_live_workers <= m_min_workers)
+                    continue;
+                const size_t previous_worker_count = m_live_workers--;
+                lock.unlock();
+                _report_pool_resize(previous_worker_count, previous_worker_count - 1);
+                // Published once the handler returned, so growing the pool never joins a worker still running it
+                lock.lock();
+                m_retired_workers.push_back(std::this_thread::get_id());
+                // A shutdown joining the workers waits for this one too
+                m_queue_condition.notify_all();
+                return;
+            }
+            if (m_stopping && m_queued_task_count == 0)
+            {
+                _mark_worker_exited();
                 return;
-            if (!m_task_queue.empty())
+            }
+            if (m_queued_task_count != 0)
             {
-                task = std::move(m_task_queue.front());
-                m_task_queue.pop();
+                task = _pop_shared_queue_task();
             }
             else
             {
@@ -324,19 +1598,108 @@ void CallbackLogger::_worker_thread()
             }
         }
         if (task)
+            _run_task(task);
+    }
+}
+
+void CallbackLogger::_work_stealing_worker_thread(const size_t worker_index)
+{
+    _configure_worker_thread();
+    {
+        // Allocate the queue from the pinned worker, so it is first touched on the worker's NUMA node
+        std::unique_ptr<WorkerQueue> own_queue = std::make_unique<WorkerQueue>();
+        std::unique_lock<std::mutex> lock(m_queue_mutex);
+        m_worker_queues[worker_index] = std::move(own_queue);
+        ++m_ready_worker_queues;
+        m_queue_condition.notify_all();
+        m_queue_condition.wait(lock, [this] { return m_ready_worker_queues == m_worker_queues.size(); });
+    }
+
+    while (true)
+    {
+        Task task;
+        if (_try_pop_or_steal_task(worker_index, task))
+        {
+            _run_task(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_queue_mutex);
+        // Announce sleeping before re-checking, so a producer either sees a sleeper or this worker sees its task
+        m_sleeping_workers.fetch_add(1);
+        m_queue_condition.wait(lock, [this] { return m_stopping || m_pending_tasks.load() != 0; });
+        m_sleeping_workers.fetch_sub(1);
+        if (m_stopping && m_pending_tasks.load() == 0)
         {
-            try
+            _mark_worker_exited();
+            return;
+        }
+    }
+}
+
+void CallbackLogger::_configure_worker_thread()
+{
+    set_current_thread_name(m_worker_thread_name_prefix + std::to_string(m_next_worker_number.fetch_add(1)));
+    // Checked by the constructor, so this only fails if the allowed CPUs of the process shrank since
+    if (!m_worker_cpu_set.empty() && !set_current_thread_affinity(m_worker_cpu_set))
+        m_unpinned_workers.add();
+}
+
+bool CallbackLogger::_try_pop_or_steal_task(const size_t worker_index, Task& task)
+{
+    // The owner pops the oldest task, thieves take the newest one from the other end
+    {
+        WorkerQueue& own_queue = *m_worker_queues[worker_index];
+        std::lock_guard<std::mutex> lock(own_queue.mutex);
+        if (!own_queue.tasks.empty())
+        {
+            task = std::move(own_queue.tasks.front());
+            own_queue.tasks.pop_front();
+            m_pending_tasks.fetch_sub(1);
+            return true;
+        }
+    }
+    // Busy queues are skipped first, then waited for: a task counted as pending may be behind one of their locks,
+    // and giving up on it would make the worker spin on its wait predicate
+    bool is_victim_busy = false;
+    for (const bool is_blocking : {false, true})
+    {
+        for (size_t offset = 1; offset < m_worker_queues.size(); ++offset)
+        {
+            WorkerQueue& victim_queue = *m_worker_queues[(worker_index + offset) % m_worker_queues.size()];
+            std::unique_lock<std::mutex> lock(victim_queue.mutex, std::defer_lock);
+            if (is_blocking)
             {
-                task();
+                lock.lock();
             }
-            catch (const std::exception& e)
+            else if (!lock.try_lock())
             {
-                std::cerr << "[!] Exception in worker thread: " << e.what() << std::endl;
+                is_victim_busy = true;
+                continue;
             }
-            catch (...)
+            if (!victim_queue.tasks.empty())
             {
-                std::cerr << "[!] Unknown exception in worker thread." << std::endl;
+                task = std::move(victim_queue.tasks.back());
+                victim_queue.tasks.pop_back();
+                m_pending_tasks.fetch_sub(1);
+                return true;
             }
         }
+        if (!is_victim_busy)
+            break;
     }
+    return false;
+}
+
+void CallbackLogger::_run_task(Task& task)
+{
+    if (m_is_discarding.load(std::memory_order_relaxed))
+        return;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    m_running_task_count.fetch_add(1);
+    // Callback exceptions are accounted in _run_callback, tasks themselves do not throw
+    task();
+    m_running_task_count.fetch_sub(1);
+    m_worker_busy_time_ns.add(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
 }
@@ -1,13 +1,72 @@
 #include "Models/ComponentEnumEntry.hpp"
 
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "Utils/ForkHandlers.hpp"
+
+namespace {
+
+/**
+ * @brief Names of every component seen by the process. Names are never removed, so views of them stay valid.
+ */
+class ComponentNameTable
+{
+public:
+    std::string_view find_or_add(const ComponentEnumEntry& component, std::string (ComponentEnumEntry::*build_name)() const)
+    {
+        {
+            std::shared_lock<std::shared_mutex> lock(m_mutex);
+            const auto name_iterator = m_names.find(component);
+            if (name_iterator != m_names.end())
+                return *name_iterator->second;
+        }
+        std::string name = (component.*build_name)();
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        const auto name_iterator = m_names.try_emplace(component, std::make_unique<const std::string>(std::move(name))).first;
+        return *name_iterator->second;
+    }
+
+private:
+    std::shared_mutex m_mutex;
+    std::unordered_map<ComponentEnumEntry, std::unique_ptr<const std::string>, ComponentEnumEntryHasher> m_names;
+};
+
+ComponentNameTable*& component_name_table_pointer()
+{
+    // Never destroyed, so threads still logging during static destruction keep valid names
+    static ComponentNameTable* table = new ComponentNameTable();
+    return table;
+}
+
+ComponentNameTable& component_name_table()
+{
+    return *component_name_table_pointer();
+}
+
+} // namespace
+
+void enable_fork_safe_component_names()
+{
+    // The child of a fork may inherit the table locked or half-updated by another thread of the parent, so it starts
+    // a new one. The parent's table is leaked rather than freed, keeping the names already handed out valid.
+    static const ForkHandlerRegistration fork_registration(ForkHandlers{
+        nullptr, nullptr, [] { component_name_table_pointer() = new ComponentNameTable(); }});
+}
+
 ComponentEnumEntry::ComponentEnumEntry()
-    : type(typeid(void)), enum_value(0) {}
+    : type(typeid(void)), enum_value(0), static_id(0) {}
 
 ComponentEnumEntry::ComponentEnumEntry(const std::variant<std::type_index, std::string>& type, uint32_t enum_value)
-    : type(type), enum_value(enum_value) {}
+    : type(type), enum_value(enum_value), static_id(0) {}
+
+ComponentEnumEntry::ComponentEnumEntry(const std::variant<std::type_index, std::string>& type, uint32_t enum_value, uint64_t static_id)
+    : type(type), enum_value(enum_value), static_id(static_id) {}
 
 ComponentEnumEntry::ComponentEnumEntry(const ComponentEnumEntry& other)
-    : type(other.type), enum_value(other.enum_value) {}
+    : type(other.type), enum_value(other.enum_value), static_id(other.static_id) {}
 
 ComponentEnumEntry& ComponentEnumEntry::operator=(const ComponentEnumEntry& other)
 {
@@ -15,6 +74,7 @@ ComponentEnumEntry& ComponentEnumEntry::operator=(const ComponentEnumEntry& othe
     {
         type = other.type;
         enum_value = other.enum_value;
+        static_id = other.static_id;
     }
     return *this;
 }
@@ -29,19 +89,22 @@ uint32_t ComponentEnumEntry::get_enum_value() const
     return enum_value;
 }
 
-bool ComponentEnumEntry::operator==(const ComponentEnumEntry& other) const
+uint64_t ComponentEnumEntry::get_static_id() const
 {
-    return (other.type == type) && (other.enum_value == enum_value);
+    return static_id;
 }
 
 bool ComponentEnumEntry::operator<(const ComponentEnumEntry& other) const
 {
+    // Consistent with operator==: entries with a static ID sort by it, after every entry without one
+    if (static_id != 0 || other.static_id != 0)
+        return static_id < other.static_id;
     return (type < other.type) || (type == other.type && enum_value < other.enum_value);
 }
 
 bool ComponentEnumEntry::operator>(const ComponentEnumEntry& other) const
 {
-    return (type > other.type) || (type == other.type && enum_value > other.enum_value);
+    return other < *this;
 }
 
 bool ComponentEnumEntry::operator<=(const ComponentEnumEntry& other) const
@@ -55,6 +118,22 @@ bool ComponentEnumEntry::operator>=(const ComponentEnumEntry& other) const
 }
 
 std::string ComponentEnumEntry::to_string() const
+{
+    return std::string(name());
+}
+
+std::string_view ComponentEnumEntry::name() const
+{
+    thread_local std::unordered_map<ComponentEnumEntry, std::string_view, ComponentEnumEntryHasher> thread_names;
+    const auto name_iterator = thread_names.find(*this);
+    if (name_iterator != thread_names.end())
+        return name_iterator->second;
+    const std::string_view name = component_name_table().find_or_add(*this, &ComponentEnumEntry::_build_name);
+    thread_names.emplace(*this, name);
+    return name;
+}
+
+std::string ComponentEnumEntry::_build_name() const
 {
     std::ostringstream oss;
     std::string type_string = std::visit([](const auto& t) -> std::string
@@ -82,9 +161,12 @@ std::string ComponentEnumEntry::to_string() const
 void ComponentEnumEntry::set_type(const std::string& type)
 {
     this->type = type;
+    this->static_id = 0;
 }
 
 void ComponentEnumEntry::set_enum_value(const uint32_t value)
 {
     this->enum_value = value;
+    if (static_id != 0)
+        static_id = (static_id & ~static_cast<uint64_t>(UINT32_MAX)) | value;
 }
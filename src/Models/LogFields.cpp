@@ -0,0 +1,173 @@
+#include "Models/LogFields.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+LogFields::LogFields(const std::initializer_list<LogField> fields)
+{
+    for (const LogField& field : fields)
+        (void)add(field);
+}
+
+LogFields::LogFields(const LogFields& other)
+{
+    _copy_from(other);
+}
+
+LogFields& LogFields::operator=(const LogFields& other)
+{
+    if (this != &other)
+        _copy_from(other);
+    return *this;
+}
+
+bool LogFields::add(const LogField& field)
+{
+    if (field.key.empty())
+    {
+        throw std::invalid_argument("Log field key cannot be empty");
+    }
+    if (find(field.key).has_value())
+    {
+        throw std::invalid_argument("Duplicate log field key: " + std::string(field.key));
+    }
+    const size_t text_left = TEXT_CAPACITY - (m_block ? m_block->text_size : 0);
+    if (m_count == MAX_FIELD_COUNT || field.key.size() > text_left)
+    {
+        m_truncated_count = static_cast<uint8_t>(std::min<size_t>(m_truncated_count + 1, UINT8_MAX));
+        return false;
+    }
+    std::string_view string_value = (field.type == LogFieldType::String) ? field.string_value : std::string_view();
+    const bool is_truncated = (field.key.size() + string_value.size() > text_left);
+    if (is_truncated)
+    {
+        size_t value_size = text_left - field.key.size();
+        // Cut before the lead byte of a UTF-8 character the limit splits
+        while (value_size > 0 && (static_cast<unsigned char>(string_value[value_size]) & 0xC0) == 0x80)
+            --value_size;
+        string_value = string_value.substr(0, value_size);
+        m_truncated_count = static_cast<uint8_t>(std::min<size_t>(m_truncated_count + 1, UINT8_MAX));
+    }
+    if (!m_block)
+        m_block = std::make_unique<FieldBlock>();
+
+    FieldSlot& slot = m_block->slots[m_count];
+    slot.value_bits = 0;
+    slot.type = field.type;
+    slot.key_size = static_cast<uint8_t>(field.key.size());
+    slot.key_offset = _append_text(field.key);
+    slot.string_offset = 0;
+    slot.string_size = 0;
+    if (field.type == LogFieldType::Int)
+    {
+        slot.value_bits = static_cast<uint64_t>(field.int_value);
+    }
+    else if (field.type == LogFieldType::Double)
+    {
+        std::memcpy(&slot.value_bits, &field.double_value, sizeof(double));
+    }
+    else
+    {
+        slot.string_size = static_cast<uint8_t>(string_value.size());
+        slot.string_offset = _append_text(string_value);
+    }
+    ++m_count;
+    return !is_truncated;
+}
+
+LogField LogFields::operator[](const size_t index) const
+{
+    const FieldSlot& slot = m_block->slots[index];
+    const std::string_view key = _text(slot.key_offset, slot.key_size);
+    if (slot.type == LogFieldType::Int)
+        return LogField(key, static_cast<int64_t>(slot.value_bits));
+    if (slot.type == LogFieldType::Double)
+    {
+        double value;
+        std::memcpy(&value, &slot.value_bits, sizeof(double));
+        return LogField(key, value);
+    }
+    return LogField(key, _text(slot.string_offset, slot.string_size));
+}
+
+std::optional<LogField> LogFields::find(const std::string_view key) const
+{
+    for (size_t index = 0; index < m_count; ++index)
+    {
+        if (_text(m_block->slots[index].key_offset, m_block->slots[index].key_size) == key)
+            return (*this)[index];
+    }
+    return std::nullopt;
+}
+
+void LogFields::append_to(std::string& text) const
+{
+    for (size_t index = 0; index < m_count; ++index)
+    {
+        const LogField field = (*this)[index];
+        text += ' ';
+        text.append(field.key.data(), field.key.size());
+        text += '=';
+        if (field.type == LogFieldType::Int)
+        {
+            char buffer[24];
+            const std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), field.int_value);
+            text.append(buffer, result.ptr);
+        }
+        else if (field.type == LogFieldType::Double)
+        {
+            // Shortest representation that reads back to the same double
+            char buffer[32];
+            const std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), field.double_value);
+            text.append(buffer, result.ptr);
+        }
+        else
+        {
+            text += '"';
+            for (const char character : field.string_value)
+            {
+                if (character == '\n')
+                {
+                    text += "\\n";
+                    continue;
+                }
+                if (character == '"' || character == '\\')
+                    text += '\\';
+                text += character;
+            }
+            text += '"';
+        }
+    }
+}
+
+uint8_t LogFields::_append_text(const std::string_view text)
+{
+    const uint8_t offset = m_block->text_size;
+    std::memcpy(m_block->text + offset, text.data(), text.size());
+    m_block->text_size = static_cast<uint8_t>(m_block->text_size + text.size());
+    return offset;
+}
+
+std::string_view LogFields::_text(const uint8_t offset, const uint8_t size) const
+{
+    return std::string_view(m_block->text + offset, size);
+}
+
+void LogFields::_copy_from(const LogFields& other)
+{
+    m_count = other.m_count;
+    m_truncated_count = other.m_truncated_count;
+    if (other.m_count == 0)
+    {
+        m_block.reset();
+        return;
+    }
+    if (!m_block)
+        m_block = std::make_unique<FieldBlock>();
+    // Only the used part of the block is copied
+    std::memcpy(m_block->slots, other.m_block->slots, m_count * sizeof(FieldSlot));
+    std::memcpy(m_block->text, other.m_block->text, other.m_block->text_size);
+    m_block->text_size = other.m_block->text_size;
+}
@@ -0,0 +1,152 @@
+#include "SharedMemoryTransport.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+struct RecordHeader
+{
+    int32_t severity;
+    uint32_t line;
+    uint32_t enum_value;
+    uint16_t type_length;
+    uint16_t file_length;
+    uint64_t static_id;
+    uint16_t timestamp_length;
+    uint16_t message_length;
+};
+
+std::string_view component_type_name(const ComponentEnumEntry& component)
+{
+    // The cached "Type#value" name, whose value is sent separately
+    const std::string_view name = component.name();
+    return name.substr(0, name.rfind('#'));
+}
+
+/**
+ * @brief Appends a string to a record, truncated to the space left and to the 16-bit length field.
+ */
+uint16_t append_field(char* record, size_t& offset, const size_t capacity, const std::string_view field)
+{
+    const size_t length = std::min<size_t>({field.size(), capacity - offset, UINT16_MAX});
+    std::memcpy(record + offset, field.data(), length);
+    offset += length;
+    return static_cast<uint16_t>(length);
+}
+
+bool read_field(const std::vector<char>& record, size_t& offset, const uint16_t length, std::string& field)
+{
+    if (offset + length > record.size())
+        return false;
+    field.assign(record.data() + offset, length);
+    offset += length;
+    return true;
+}
+
+}
+
+SharedMemorySink::SharedMemorySink(const std::string& name, const size_t slot_count)
+    : m_ring(std::make_shared<SharedMemoryRing>(name, slot_count)) {}
+
+void SharedMemorySink::operator()(const LogEntry& entry) const
+{
+    constexpr size_t capacity = SharedMemoryRing::max_record_size();
+    char record[capacity];
+    RecordHeader header{};
+    size_t offset = sizeof(RecordHeader);
+
+    header.severity = static_cast<int32_t>(entry.severity);
+    header.line = entry.line;
+    header.enum_value = entry.component.get_enum_value();
+    header.static_id = entry.component.get_static_id();
+    header.type_length = append_field(record, offset, capacity, component_type_name(entry.component));
+    header.file_length = append_field(record, offset, capacity, entry.file);
+    header.timestamp_length = append_field(record, offset, capacity, entry.timestamp);
+    header.message_length = append_field(record, offset, capacity, entry.message);
+    std::memcpy(record, &header, sizeof(RecordHeader));
+
+    (void)m_ring->try_push(record, offset);
+}
+
+uint64_t SharedMemorySink::dropped_count() const
+{
+    return m_ring->dropped_count();
+}
+
+SharedMemoryCollector::SharedMemoryCollector(CallbackLogger& logger, const std::string& name, const size_t slot_count)
+    : m_logger(logger), m_ring(name, slot_count) {}
+
+SharedMemoryCollector::~SharedMemoryCollector()
+{
+    stop();
+}
+
+size_t SharedMemoryCollector::poll(const size_t max_records)
+{
+    std::lock_guard<std::mutex> lock(m_poll_mutex);
+    std::vector<char> record;
+    size_t replayed_count = 0;
+    while (replayed_count < max_records && m_ring.try_pop(record))
+    {
+        RecordHeader header;
+        if (record.size() < sizeof(RecordHeader))
+            continue;
+        std::memcpy(&header, record.data(), sizeof(RecordHeader));
+
+        size_t offset = sizeof(RecordHeader);
+        std::string type_name;
+        LogEntry entry;
+        if (!read_field(record, offset, header.type_length, type_name)
+            || !read_field(record, offset, header.file_length, entry.file)
+            || !read_field(record, offset, header.timestamp_length, entry.timestamp)
+            || !read_field(record, offset, header.message_length, entry.message))
+            continue;
+        entry.severity = static_cast<Severity>(header.severity);
+        entry.line = header.line;
+        entry.component = ComponentEnumEntry{std::variant<std::type_index, std::string>{type_name}, header.enum_value, header.static_id};
+        if (header.static_id == 0)
+            m_non_static_component_count.fetch_add(1, std::memory_order_relaxed);
+
+        try
+        {
+            m_logger.log_entry(entry);
+            ++replayed_count;
+        }
+        catch (const std::exception&)
+        {
+            // A malformed record from one producer must not stop the collection of the others
+        }
+    }
+    return replayed_count;
+}
+
+uint64_t SharedMemoryCollector::non_static_component_count() const
+{
+    return m_non_static_component_count.load(std::memory_order_relaxed);
+}
+
+void SharedMemoryCollector::start(const std::chrono::microseconds idle_sleep)
+{
+    if (m_is_polling.exchange(true))
+        return;
+    m_polling_thread = std::thread([this, idle_sleep]()
+    {
+        set_current_thread_name("cblog-collector");
+        while (m_is_polling.load(std::memory_order_relaxed))
+        {
+            if (poll() == 0)
+                std::this_thread::sleep_for(idle_sleep);
+        }
+        poll();
+    });
+}
+
+void SharedMemoryCollector::stop()
+{
+    m_is_polling.store(false);
+    if (m_polling_thread.joinable())
+        m_polling_thread.join();
+}
@@ -0,0 +1,92 @@
+#include "Utils/CallSiteRateLimiter.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+CallSiteRateLimiter::CallSiteRateLimiter()
+    : m_slots(new CallSiteSlot[TABLE_SIZE]) {}
+
+void CallSiteRateLimiter::configure(const double entries_per_second, const uint32_t burst)
+{
+    if (!(entries_per_second >= 0))
+    {
+        throw std::invalid_argument("Rate limit must not be negative: " + std::to_string(entries_per_second));
+    }
+    if (entries_per_second > 0 && burst == 0)
+    {
+        throw std::invalid_argument("Rate limit burst must be at least 1");
+    }
+    const int64_t emission_interval_ns = (entries_per_second > 0)
+        ? std::max<int64_t>(1, static_cast<int64_t>(1e9 / entries_per_second)) : 0;
+    m_burst_tolerance_ns.store(emission_interval_ns * static_cast<int64_t>(burst), std::memory_order_relaxed);
+    m_emission_interval_ns.store(emission_interval_ns, std::memory_order_relaxed);
+}
+
+RateLimitDecision CallSiteRateLimiter::admit(const uint64_t call_site, const int64_t now_ns)
+{
+    const int64_t emission_interval_ns = m_emission_interval_ns.load(std::memory_order_relaxed);
+    if (emission_interval_ns <= 0)
+        return RateLimitDecision{true, 0, false};
+    CallSiteSlot* slot = _find_slot(call_site);
+    if (slot == nullptr)
+        return RateLimitDecision{true, 0, false};
+
+    const int64_t burst_tolerance_ns = m_burst_tolerance_ns.load(std::memory_order_relaxed);
+    int64_t theoretical_arrival_ns = slot->theoretical_arrival_ns.load(std::memory_order_relaxed);
+    while (true)
+    {
+        const int64_t next_arrival_ns = std::max(theoretical_arrival_ns, now_ns) + emission_interval_ns;
+        if (next_arrival_ns - now_ns > burst_tolerance_ns)
+        {
+            slot->suppressed_count.fetch_add(1, std::memory_order_relaxed);
+            return RateLimitDecision{false, 0, slot->description.load(std::memory_order_acquire) == nullptr};
+        }
+        if (slot->theoretical_arrival_ns.compare_exchange_weak(theoretical_arrival_ns, next_arrival_ns, std::memory_order_relaxed))
+            return RateLimitDecision{true, slot->suppressed_count.exchange(0, std::memory_order_relaxed), false};
+    }
+}
+
+void CallSiteRateLimiter::describe_call_site(const uint64_t call_site, const RateLimitedCallSite& description)
+{
+    CallSiteSlot* slot = _find_slot(call_site);
+    if (slot == nullptr || slot->description.load(std::memory_order_acquire) != nullptr)
+        return;
+    std::unique_ptr<RateLimitedCallSite> new_description = std::make_unique<RateLimitedCallSite>(description);
+    RateLimitedCallSite* expected = nullptr;
+    if (slot->description.compare_exchange_strong(expected, new_description.get(), std::memory_order_acq_rel))
+        (void)new_description.release();
+}
+
+void CallSiteRateLimiter::take_suppressed_counts(const std::function<void(const RateLimitedCallSite&, uint64_t)>& report)
+{
+    for (size_t slot_index = 0; slot_index < TABLE_SIZE; ++slot_index)
+    {
+        CallSiteSlot& slot = m_slots[slot_index];
+        const RateLimitedCallSite* description = slot.description.load(std::memory_order_acquire);
+        if (description == nullptr || slot.suppressed_count.load(std::memory_order_relaxed) == 0)
+            continue;
+        // Exchanged like an admitted entry does, so a concurrent admission and this report never both count them
+        const uint64_t suppressed_count = slot.suppressed_count.exchange(0, std::memory_order_relaxed);
+        if (suppressed_count != 0)
+            report(*description, suppressed_count);
+    }
+}
+
+CallSiteRateLimiter::CallSiteSlot* CallSiteRateLimiter::_find_slot(const uint64_t call_site)
+{
+    for (size_t probe = 0; probe < MAX_PROBES; ++probe)
+    {
+        CallSiteSlot& slot = m_slots[(call_site + probe) % TABLE_SIZE];
+        uint64_t slot_call_site = slot.call_site.load(std::memory_order_acquire);
+        if (slot_call_site == call_site)
+            return &slot;
+        if (slot_call_site == 0)
+        {
+            if (slot.call_site.compare_exchange_strong(slot_call_site, call_site, std::memory_order_acq_rel)
+                || slot_call_site == call_site)
+                return &slot;
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,48 @@
+#include "Utils/ComponentHierarchy.hpp"
+
+#include <vector>
+
+bool is_component_ancestor(const ComponentParentMap& parents, const ComponentEnumEntry& ancestor, const ComponentEnumEntry& component)
+{
+    const ComponentEnumEntry* current = &component;
+    while (true)
+    {
+        if (*current == ancestor)
+            return true;
+        auto parent_iterator = parents.find(*current);
+        if (parent_iterator == parents.end())
+            return false;
+        current = &parent_iterator->second;
+    }
+}
+
+std::unordered_map<ComponentEnumEntry, Severity, ComponentEnumEntryHasher> expand_subtree_filter(
+    const std::unordered_map<ComponentEnumEntry, Severity, ComponentEnumEntryHasher>& roots,
+    const ComponentParentMap& parents)
+{
+    std::unordered_map<ComponentEnumEntry, std::vector<ComponentEnumEntry>, ComponentEnumEntryHasher> children;
+    for (const std::pair<const ComponentEnumEntry, ComponentEnumEntry>& relation : parents)
+        children[relation.second].push_back(relation.first);
+
+    std::unordered_map<ComponentEnumEntry, Severity, ComponentEnumEntryHasher> expanded;
+    std::vector<ComponentEnumEntry> pending;
+    for (const std::pair<const ComponentEnumEntry, Severity>& root : roots)
+    {
+        pending.push_back(root.first);
+        while (!pending.empty())
+        {
+            const ComponentEnumEntry component = pending.back();
+            pending.pop_back();
+            expanded[component] = root.second;
+
+            auto children_iterator = children.find(component);
+            if (children_iterator == children.end())
+                continue;
+            // A nested root owns its own subtree
+            for (const ComponentEnumEntry& child : children_iterator->second)
+                if (roots.find(child) == roots.end())
+                    pending.push_back(child);
+        }
+    }
+    return expanded;
+}
@@ -0,0 +1,140 @@
+#include "Utils/EpochDomain.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace {
+
+std::atomic<uint64_t> next_domain_id{1};
+
+// Enough for the domains a thread pins in turn on the logging path, such as the two of a LogSampler
+constexpr size_t THREAD_RECORD_CACHE_SIZE = 4;
+
+struct ThreadRecordCacheEntry
+{
+    uint64_t domain_id{0};
+    void* record{nullptr};
+};
+
+struct ThreadRecordCache
+{
+    std::array<ThreadRecordCacheEntry, THREAD_RECORD_CACHE_SIZE> entries{};
+    size_t next_replaced{0};
+};
+thread_local ThreadRecordCache thread_record_cache;
+
+} // namespace
+
+EpochDomain::Guard::Guard(EpochDomain& domain)
+    : m_record(domain._thread_record())
+{
+    if (m_record.depth++ == 0)
+    {
+        // Sequentially consistent so a writer scanning after its replacement sees this pin, or this thread
+        // reads the replacement
+        m_record.epoch.store(domain.m_epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+    }
+}
+
+EpochDomain::Guard::~Guard()
+{
+    if (--m_record.depth == 0)
+        m_record.epoch.store(0, std::memory_order_release);
+}
+
+EpochDomain::EpochDomain()
+    : m_domain_id(next_domain_id.fetch_add(1, std::memory_order_relaxed))
+{
+}
+
+EpochDomain::~EpochDomain()
+{
+    ThreadRecord* record = m_records.load(std::memory_order_acquire);
+    while (record != nullptr)
+    {
+        ThreadRecord* next = record->next;
+        delete record;
+        record = next;
+    }
+}
+
+size_t EpochDomain::reclaim()
+{
+    uint64_t oldest_pinned_epoch = std::numeric_limits<uint64_t>::max();
+    for (ThreadRecord* record = m_records.load(std::memory_order_acquire); record != nullptr; record = record->next)
+    {
+        const uint64_t epoch = record->epoch.load(std::memory_order_seq_cst);
+        if (epoch != 0)
+            oldest_pinned_epoch = std::min(oldest_pinned_epoch, epoch);
+    }
+
+    // Freed outside the lock, destroying an object may retire or reclaim again
+    std::vector<RetiredObject> freed;
+    size_t pending_count = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_retired_mutex);
+        // A thread pinned at the retirement epoch or before may still read the object
+        const auto pending_end = std::partition(m_retired.begin(), m_retired.end(),
+            [oldest_pinned_epoch](const RetiredObject& retired) { return retired.epoch >= oldest_pinned_epoch; });
+        freed.assign(std::make_move_iterator(pending_end), std::make_move_iterator(m_retired.end()));
+        m_retired.erase(pending_end, m_retired.end());
+        pending_count = m_retired.size();
+    }
+    return pending_count;
+}
+
+void EpochDomain::reset_after_fork()
+{
+    const std::thread::id thread_id = std::this_thread::get_id();
+    for (ThreadRecord* record = m_records.load(std::memory_order_acquire); record != nullptr; record = record->next)
+    {
+        if (record->owner == thread_id)
+            continue;
+        record->epoch.store(0, std::memory_order_relaxed);
+        record->depth = 0;
+    }
+    (void)new std::vector<RetiredObject>(std::move(m_retired));
+    m_retired.clear();
+}
+
+EpochDomain::ThreadRecord& EpochDomain::_thread_record()
+{
+    for (const ThreadRecordCacheEntry& entry : thread_record_cache.entries)
+    {
+        if (entry.domain_id == m_domain_id)
+            return *static_cast<ThreadRecord*>(entry.record);
+    }
+
+    // Records are never removed, a thread reuses the record of an exited thread that had the same ID
+    const std::thread::id thread_id = std::this_thread::get_id();
+    ThreadRecord* record = m_records.load(std::memory_order_acquire);
+    while (record != nullptr && record->owner != thread_id)
+        record = record->next;
+
+    if (record == nullptr)
+    {
+        record = new ThreadRecord();
+        record->owner = thread_id;
+        record->next = m_records.load(std::memory_order_relaxed);
+        while (!m_records.compare_exchange_weak(record->next, record, std::memory_order_release, std::memory_order_relaxed)) {}
+    }
+
+    // Domain IDs are never reused, an entry of a destroyed domain is only replaced
+    ThreadRecordCacheEntry& entry = thread_record_cache.entries[thread_record_cache.next_replaced];
+    thread_record_cache.next_replaced = (thread_record_cache.next_replaced + 1) % THREAD_RECORD_CACHE_SIZE;
+    entry.domain_id = m_domain_id;
+    entry.record = record;
+    return *record;
+}
+
+void EpochDomain::_retire(std::shared_ptr<const void> object)
+{
+    // Threads pinning from now on read the replacement, only those pinned at this epoch or before may hold the object
+    const uint64_t epoch = m_epoch.fetch_add(1, std::memory_order_seq_cst);
+    {
+        std::lock_guard<std::mutex> lock(m_retired_mutex);
+        m_retired.push_back(RetiredObject{epoch, std::move(object)});
+    }
+    reclaim();
+}
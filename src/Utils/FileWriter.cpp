@@ -0,0 +1,529 @@
+#include "Utils/FileWriter.hpp"
+#include "Utils/ThreadUtils.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define CALLBACK_LOGGER_HAS_IO_URING
+#endif
+#endif
+
+#if defined(CALLBACK_LOGGER_HAS_IO_URING)
+#include <cerrno>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Submission and completion queues of an io_uring writing one file, driven through raw syscalls.
+ * Only the submission thread of the owning FileWriter uses it.
+ */
+class IoUringQueue
+{
+public:
+    // Appending writes in flight together may reach the file in any order, so only one is submitted at a time
+    static constexpr uint32_t WRITE_BUFFER_COUNT = 1;
+    // Every write buffer plus as many fsyncs, the completion queue is twice as large so it never overflows
+    static constexpr uint32_t RING_ENTRY_COUNT = 2 * WRITE_BUFFER_COUNT;
+
+    /**
+     * @brief Sets up a ring and opens the file for it.
+     *
+     * @param file_path The path to the file.
+     * @return The queue, or null if io_uring is unavailable or the file cannot be opened.
+     */
+    static std::unique_ptr<IoUringQueue> open(const std::string& file_path);
+
+    ~IoUringQueue();
+
+    bool has_free_buffer() const;
+
+    /**
+     * @brief Submits a write appending the text to the file. Requires a free buffer.
+     *
+     * @param text The text to write, swapped with an empty buffer whose capacity is reused.
+     * @param is_synced Whether to link an fsync to the write, which the kernel starts once the write completed.
+     */
+    void submit_write(std::string& text, bool is_synced);
+
+    /**
+     * @brief Submits an fsync that starts once every previous write has completed.
+     */
+    void submit_fsync();
+
+    /**
+     * @brief Handles the available completions and submits what is pending.
+     *
+     * @param is_waiting Whether to wait for at least one completion if operations are in flight.
+     */
+    void reap(bool is_waiting);
+
+    bool is_idle() const;
+
+    uint64_t completed_bytes() const { return m_completed_bytes; }
+
+    uint64_t failed_write_count() const { return m_failed_write_count; }
+
+private:
+#if defined(CALLBACK_LOGGER_HAS_IO_URING)
+    struct WriteBuffer
+    {
+        std::string data;
+        size_t written{0};
+    };
+
+    static constexpr uint64_t FSYNC_USER_DATA = ~0ULL;
+
+    IoUringQueue() = default;
+
+    void _reserve_operation();
+    void _push_sqe(const io_uring_sqe& sqe);
+    void _push_write(uint32_t buffer_index, bool is_linked);
+    void _push_fsync(bool is_drained);
+    void _enter(bool is_waiting);
+    void _handle_completion(const io_uring_cqe& cqe);
+
+    int m_file_fd{-1};
+    int m_ring_fd{-1};
+    void* m_sq_ring{nullptr};
+    size_t m_sq_ring_size{0};
+    void* m_cq_ring{nullptr};
+    size_t m_cq_ring_size{0};
+    io_uring_sqe* m_sqes{nullptr};
+    size_t m_sqes_size{0};
+    unsigned* m_sq_tail{nullptr};
+    unsigned* m_sq_mask{nullptr};
+    unsigned* m_sq_array{nullptr};
+    unsigned* m_cq_head{nullptr};
+    unsigned* m_cq_tail{nullptr};
+    unsigned* m_cq_mask{nullptr};
+    io_uring_cqe* m_cqes{nullptr};
+    // Pushed to the submission queue but not yet taken by the kernel
+    uint32_t m_unsubmitted{0};
+    // Taken by the kernel but not yet completed
+    uint32_t m_in_flight{0};
+    WriteBuffer m_buffers[WRITE_BUFFER_COUNT];
+    std::vector<uint32_t> m_free_buffers;
+#endif
+    // Bytes of the writes that completed, whether they succeeded or failed
+    uint64_t m_completed_bytes{0};
+    uint64_t m_failed_write_count{0};
+};
+
+#if defined(CALLBACK_LOGGER_HAS_IO_URING)
+
+std::unique_ptr<IoUringQueue> IoUringQueue::open(const std::string& file_path)
+{
+#if defined(IORING_FEAT_RW_CUR_POS) && defined(IORING_FEAT_NODROP)
+    std::unique_ptr<IoUringQueue> queue(new IoUringQueue());
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    queue->m_ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, RING_ENTRY_COUNT, &params));
+    if (queue->m_ring_fd < 0)
+        return nullptr;
+    // IORING_OP_WRITE came with the same kernel as IORING_FEAT_RW_CUR_POS
+    if ((params.features & IORING_FEAT_RW_CUR_POS) == 0 || (params.features & IORING_FEAT_NODROP) == 0)
+        return nullptr;
+
+    queue->m_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    queue->m_cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool is_single_mapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (is_single_mapping)
+        queue->m_sq_ring_size = queue->m_cq_ring_size = std::max(queue->m_sq_ring_size, queue->m_cq_ring_size);
+    void* sq_ring = mmap(nullptr, queue->m_sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         queue->m_ring_fd, IORING_OFF_SQ_RING);
+    if (sq_ring == MAP_FAILED)
+        return nullptr;
+    queue->m_sq_ring = sq_ring;
+    if (is_single_mapping)
+    {
+        queue->m_cq_ring = sq_ring;
+    }
+    else
+    {
+        void* cq_ring = mmap(nullptr, queue->m_cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                             queue->m_ring_fd, IORING_OFF_CQ_RING);
+        if (cq_ring == MAP_FAILED)
+            return nullptr;
+        queue->m_cq_ring = cq_ring;
+    }
+    queue->m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = mmap(nullptr, queue->m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      queue->m_ring_fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+        return nullptr;
+    queue->m_sqes = static_cast<io_uring_sqe*>(sqes);
+
+    char* sq_ring_bytes = static_cast<char*>(queue->m_sq_ring);
+    char* cq_ring_bytes = static_cast<char*>(queue->m_cq_ring);
+    queue->m_sq_tail = reinterpret_cast<unsigned*>(sq_ring_bytes + params.sq_off.tail);
+    queue->m_sq_mask = reinterpret_cast<unsigned*>(sq_ring_bytes + params.sq_off.ring_mask);
+    queue->m_sq_array = reinterpret_cast<unsigned*>(sq_ring_bytes + params.sq_off.array);
+    queue->m_cq_head = reinterpret_cast<unsigned*>(cq_ring_bytes + params.cq_off.head);
+    queue->m_cq_tail = reinterpret_cast<unsigned*>(cq_ring_bytes + params.cq_off.tail);
+    queue->m_cq_mask = reinterpret_cast<unsigned*>(cq_ring_bytes + params.cq_off.ring_mask);
+    queue->m_cqes = reinterpret_cast<io_uring_cqe*>(cq_ring_bytes + params.cq_off.cqes);
+
+    // Appending, so other processes and writers sharing the file never overwrite each other's text
+    queue->m_file_fd = ::open(file_path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (queue->m_file_fd < 0)
+        return nullptr;
+    for (uint32_t buffer_index = 0; buffer_index < WRITE_BUFFER_COUNT; ++buffer_index)
+        queue->m_free_buffers.push_back(WRITE_BUFFER_COUNT - 1 - buffer_index);
+    return queue;
+#else
+    (void)file_path;
+    return nullptr;
+#endif
+}
+
+IoUringQueue::~IoUringQueue()
+{
+    if (m_sqes != nullptr)
+        munmap(m_sqes, m_sqes_size);
+    if (m_cq_ring != nullptr && m_cq_ring != m_sq_ring)
+        munmap(m_cq_ring, m_cq_ring_size);
+    if (m_sq_ring != nullptr)
+        munmap(m_sq_ring, m_sq_ring_size);
+    if (m_ring_fd >= 0)
+        close(m_ring_fd);
+    if (m_file_fd >= 0)
+        close(m_file_fd);
+}
+
+bool IoUringQueue::has_free_buffer() const
+{
+    return !m_free_buffers.empty();
+}
+
+void IoUringQueue::submit_write(std::string& text, const bool is_synced)
+{
+    // Reserved together, a linked chain must reach the kernel in one submission
+    while (m_in_flight + m_unsubmitted + (is_synced ? 2 : 1) > RING_ENTRY_COUNT)
+        reap(true);
+    const uint32_t buffer_index = m_free_buffers.back();
+    m_free_buffers.pop_back();
+    WriteBuffer& buffer = m_buffers[buffer_index];
+    buffer.data.swap(text);
+    buffer.written = 0;
+    _push_write(buffer_index, is_synced);
+    if (is_synced)
+        _push_fsync(false);
+    _enter(false);
+}
+
+void IoUringQueue::submit_fsync()
+{
+    _reserve_operation();
+    _push_fsync(true);
+    _enter(false);
+}
+
+void IoUringQueue::reap(const bool is_waiting)
+{
+    if (m_unsubmitted != 0 || (is_waiting && m_in_flight != 0))
+        _enter(is_waiting && m_in_flight + m_unsubmitted != 0);
+
+    unsigned head = *m_cq_head;
+    const unsigned tail = __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE);
+    while (head != tail)
+    {
+        const io_uring_cqe cqe = m_cqes[head & *m_cq_mask];
+        ++head;
+        --m_in_flight;
+        _handle_completion(cqe);
+    }
+    __atomic_store_n(m_cq_head, head, __ATOMIC_RELEASE);
+
+    // Short writes are resubmitted by their completion
+    if (m_unsubmitted != 0)
+        _enter(false);
+}
+
+bool IoUringQueue::is_idle() const
+{
+    return m_in_flight + m_unsubmitted == 0;
+}
+
+void IoUringQueue::_reserve_operation()
+{
+    while (m_in_flight + m_unsubmitted >= RING_ENTRY_COUNT)
+        reap(true);
+}
+
+void IoUringQueue::_push_sqe(const io_uring_sqe& sqe)
+{
+    const unsigned tail = *m_sq_tail;
+    const unsigned index = tail & *m_sq_mask;
+    m_sqes[index] = sqe;
+    m_sq_array[index] = index;
+    // The kernel reads the entry once it sees the new tail
+    __atomic_store_n(m_sq_tail, tail + 1, __ATOMIC_RELEASE);
+    ++m_unsubmitted;
+}
+
+void IoUringQueue::_push_write(const uint32_t buffer_index, const bool is_linked)
+{
+    const WriteBuffer& buffer = m_buffers[buffer_index];
+    io_uring_sqe sqe;
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_WRITE;
+    sqe.fd = m_file_fd;
+    sqe.addr = reinterpret_cast<uint64_t>(buffer.data.data() + buffer.written);
+    sqe.len = static_cast<uint32_t>(buffer.data.size() - buffer.written);
+    // The file is opened with O_APPEND, the offset is only the current position requested by IORING_FEAT_RW_CUR_POS
+    sqe.off = ~0ULL;
+    sqe.flags = is_linked ? IOSQE_IO_LINK : 0;
+    sqe.user_data = buffer_index;
+    _push_sqe(sqe);
+}
+
+void IoUringQueue::_push_fsync(const bool is_drained)
+{
+    io_uring_sqe sqe;
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_FSYNC;
+    sqe.fd = m_file_fd;
+    // Drained so the fsync covers every write submitted before it, unless it is linked to the only write in flight
+    sqe.flags = is_drained ? IOSQE_IO_DRAIN : 0;
+    sqe.user_data = FSYNC_USER_DATA;
+    _push_sqe(sqe);
+}
+
+void IoUringQueue::_enter(const bool is_waiting)
+{
+    for (;;)
+    {
+        const long submitted = syscall(__NR_io_uring_enter, m_ring_fd, m_unsubmitted, is_waiting ? 1 : 0,
+                                       is_waiting ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+        if (submitted >= 0)
+        {
+            m_unsubmitted -= static_cast<uint32_t>(submitted);
+            m_in_flight += static_cast<uint32_t>(submitted);
+            return;
+        }
+        if (errno == EAGAIN || errno == EBUSY)
+            std::this_thread::yield();
+        else if (errno != EINTR)
+            throw std::runtime_error("io_uring submission failed: " + std::string(std::strerror(errno)));
+    }
+}
+
+void IoUringQueue::_handle_completion(const io_uring_cqe& cqe)
+{
+    if (cqe.user_data == FSYNC_USER_DATA)
+    {
+        // A short linked write cancels its fsync, which then follows the resubmitted remainder
+        if (cqe.res == -ECANCELED)
+            _push_fsync(true);
+        return;
+    }
+    const uint32_t buffer_index = static_cast<uint32_t>(cqe.user_data);
+    WriteBuffer& buffer = m_buffers[buffer_index];
+    if (cqe.res == -EINTR || cqe.res == -EAGAIN)
+    {
+        _push_write(buffer_index, false);
+        return;
+    }
+    if (cqe.res <= 0)
+    {
+        ++m_failed_write_count;
+    }
+    else
+    {
+        buffer.written += static_cast<size_t>(cqe.res);
+        if (buffer.written < buffer.data.size())
+        {
+            _push_write(buffer_index, false);
+            return;
+        }
+    }
+    m_completed_bytes += buffer.data.size();
+    buffer.data.clear();
+    m_free_buffers.push_back(buffer_index);
+}
+
+#else
+
+std::unique_ptr<IoUringQueue> IoUringQueue::open(const std::string&)
+{
+    return nullptr;
+}
+
+IoUringQueue::~IoUringQueue() = default;
+
+bool IoUringQueue::has_free_buffer() const { return false; }
+
+void IoUringQueue::submit_write(std::string&, bool) {}
+
+void IoUringQueue::submit_fsync() {}
+
+void IoUringQueue::reap(bool) {}
+
+bool IoUringQueue::is_idle() const { return true; }
+
+#endif
+
+FileWriter::FileWriter(const std::string& file_path, const FileWriterOptions& options)
+    : m_options(options)
+{
+    if (m_options.backend == FileWriterBackend::IoUring)
+        m_io_uring = IoUringQueue::open(file_path);
+    if (m_io_uring)
+    {
+        m_submission_thread = std::thread(&FileWriter::_submission_thread, this);
+        return;
+    }
+    m_stream.open(file_path, std::ios::app);
+    if (!m_stream.is_open())
+    {
+        throw std::runtime_error("Cannot open log file: " + file_path);
+    }
+}
+
+FileWriter::~FileWriter()
+{
+    if (!m_io_uring)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_is_stopping = true;
+    }
+    // The submission thread submits what is staged and waits for it before leaving
+    m_submission_condition.notify_one();
+    m_submission_thread.join();
+}
+
+void FileWriter::write(const std::string& text, const Severity severity)
+{
+    const bool is_sync_requested = _is_sync_requested(severity);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_io_uring)
+    {
+        // A stream cannot be synced to the disk, flushing hands it to the operating system at least
+        m_stream << text;
+        if (is_sync_requested)
+            m_stream.flush();
+        return;
+    }
+
+    m_drain_condition.wait(lock, [this] { return m_staging.size() < m_options.max_buffered_bytes || m_is_ring_failed; });
+    if (m_is_ring_failed)
+    {
+        ++m_failed_write_count;
+        return;
+    }
+    const bool was_empty = m_staging.empty() && !m_is_sync_pending;
+    m_staging += text;
+    m_staged_bytes += text.size();
+    m_is_sync_pending = m_is_sync_pending || is_sync_requested;
+    lock.unlock();
+    if (was_empty)
+        m_submission_condition.notify_one();
+}
+
+void FileWriter::flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_io_uring)
+    {
+        m_stream.flush();
+        return;
+    }
+    const uint64_t flushed_bytes = m_staged_bytes;
+    m_drain_condition.wait(lock, [this, flushed_bytes] { return m_completed_bytes >= flushed_bytes; });
+}
+
+bool FileWriter::is_using_io_uring() const
+{
+    return m_io_uring != nullptr;
+}
+
+uint64_t FileWriter::failed_write_count() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_failed_write_count;
+}
+
+void FileWriter::_submission_thread()
+{
+    set_current_thread_name("cblog-io");
+    try
+    {
+        _submit_until_stopped();
+    }
+    catch (const std::exception&)
+    {
+        // The ring is unusable, the text staged from now on is dropped and counted as failed
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_is_ring_failed = true;
+        m_failed_write_count = m_io_uring->failed_write_count() + 1;
+        m_completed_bytes = m_staged_bytes;
+        m_staging.clear();
+        m_drain_condition.notify_all();
+    }
+}
+
+void FileWriter::_submit_until_stopped()
+{
+    // Swapped with the staging buffer, then with a free write buffer, so their capacity is reused
+    std::string batch;
+    for (;;)
+    {
+        bool is_sync_requested = false;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (m_completed_bytes != m_io_uring->completed_bytes())
+            {
+                m_completed_bytes = m_io_uring->completed_bytes();
+                m_failed_write_count = m_io_uring->failed_write_count();
+                m_drain_condition.notify_all();
+            }
+            if (m_io_uring->is_idle())
+            {
+                m_submission_condition.wait(lock, [this] {
+                    return !m_staging.empty() || m_is_sync_pending || m_is_stopping;
+                });
+                if (m_staging.empty() && !m_is_sync_pending)
+                    return;
+            }
+            if (m_io_uring->has_free_buffer())
+            {
+                batch.swap(m_staging);
+                is_sync_requested = m_is_sync_pending;
+                m_is_sync_pending = false;
+                if (!batch.empty())
+                    m_drain_condition.notify_all();
+            }
+        }
+
+        const bool is_submitting = !batch.empty() || is_sync_requested;
+        if (!batch.empty())
+            m_io_uring->submit_write(batch, is_sync_requested);
+        else if (is_sync_requested)
+            m_io_uring->submit_fsync();
+        // Blocks in the kernel only when there was nothing to submit, until a write buffer is released
+        m_io_uring->reap(!is_submitting);
+    }
+}
+
+bool FileWriter::_is_sync_requested(const Severity severity) const
+{
+    switch (m_options.fsync_policy)
+    {
+    case FsyncPolicy::Always:
+        return true;
+    case FsyncPolicy::OnSeverity:
+        return severity >= m_options.fsync_min_severity;
+    default:
+        return false;
+    }
+}
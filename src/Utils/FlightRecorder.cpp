@@ -0,0 +1,328 @@
+#include "Utils/FlightRecorder.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr size_t MAX_CRASH_RECORDERS = 8;
+constexpr std::array<int, 2> CRASH_SIGNALS = {SIGSEGV, SIGABRT};
+constexpr std::array<const char*, 5> SEVERITY_NAMES = {"Debug", "Info", "Warning", "Error", "Fatal"};
+
+std::atomic<uint64_t> next_recorder_id{1};
+std::array<std::atomic<const FlightRecorder*>, MAX_CRASH_RECORDERS> crash_recorders{};
+std::atomic<bool> is_crash_handler_installed{false};
+
+#if defined(_WIN32)
+using SignalHandler = void (*)(int);
+std::array<SignalHandler, CRASH_SIGNALS.size()> previous_handlers{};
+#else
+std::array<struct sigaction, CRASH_SIGNALS.size()> previous_actions{};
+#endif
+
+// Enough for the recorders a thread records into in turn, such as one per logger
+constexpr size_t THREAD_RING_CACHE_SIZE = 4;
+
+struct ThreadRingCacheEntry
+{
+    uint64_t recorder_id{0};
+    void* ring{nullptr};
+};
+
+struct ThreadRingCache
+{
+    std::array<ThreadRingCacheEntry, THREAD_RING_CACHE_SIZE> entries{};
+    size_t next_replaced{0};
+};
+thread_local ThreadRingCache thread_ring_cache;
+
+/**
+ * @brief Copies a string into a fixed buffer, truncating it and always null-terminating it.
+ */
+void copy_truncated(char* destination, const size_t capacity, const char* source, const size_t length)
+{
+    const size_t copied = std::min(length, capacity - 1);
+    std::memcpy(destination, source, copied);
+    destination[copied] = '\0';
+}
+
+/**
+ * @brief Line buffer flushed with write(), usable from a signal handler.
+ */
+class SignalSafeWriter
+{
+public:
+    explicit SignalSafeWriter(const int descriptor) : m_descriptor(descriptor) {}
+
+    void append(const char* text)
+    {
+        while (*text != '\0')
+        {
+            if (m_size == sizeof(m_buffer))
+                flush();
+            m_buffer[m_size++] = *text++;
+        }
+    }
+
+    void append(uint64_t value)
+    {
+        char digits[24];
+        size_t count = 0;
+        do
+        {
+            digits[count++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+        char text[24];
+        for (size_t index = 0; index < count; ++index)
+            text[index] = digits[count - 1 - index];
+        text[count] = '\0';
+        append(text);
+    }
+
+    void flush()
+    {
+        size_t written = 0;
+        while (written < m_size)
+        {
+#if defined(_WIN32)
+            const int result = _write(m_descriptor, m_buffer + written, static_cast<unsigned int>(m_size - written));
+#else
+            const ssize_t result = ::write(m_descriptor, m_buffer + written, m_size - written);
+#endif
+            if (result <= 0)
+                break;
+            written += static_cast<size_t>(result);
+        }
+        m_size = 0;
+    }
+
+private:
+    int m_descriptor;
+    char m_buffer[4096];
+    size_t m_size{0};
+};
+
+void crash_signal_handler(const int signal_number)
+{
+    for (const std::atomic<const FlightRecorder*>& recorder : crash_recorders)
+    {
+        const FlightRecorder* registered_recorder = recorder.load(std::memory_order_acquire);
+        if (registered_recorder != nullptr)
+            (void)registered_recorder->dump();
+    }
+
+    // Hand the signal to the previous handler, or the default one, so the process still crashes
+    for (size_t index = 0; index < CRASH_SIGNALS.size(); ++index)
+    {
+        if (CRASH_SIGNALS[index] != signal_number)
+            continue;
+#if defined(_WIN32)
+        std::signal(signal_number, previous_handlers[index] != SIG_ERR ? previous_handlers[index] : SIG_DFL);
+#else
+        sigaction(signal_number, &previous_actions[index], nullptr);
+#endif
+    }
+    std::raise(signal_number);
+}
+
+}
+
+FlightRecorder::FlightRecorder(const std::string& dump_path, const size_t records_per_thread)
+    : m_dump_path(dump_path), m_records_per_thread(records_per_thread),
+      m_recorder_id(next_recorder_id.fetch_add(1, std::memory_order_relaxed))
+{
+    if (dump_path.empty())
+    {
+        throw std::invalid_argument("Flight recorder dump path cannot be empty");
+    }
+    if (records_per_thread == 0)
+    {
+        throw std::invalid_argument("Flight recorder must keep at least one record per thread");
+    }
+}
+
+FlightRecorder::~FlightRecorder()
+{
+    for (std::atomic<const FlightRecorder*>& recorder : crash_recorders)
+    {
+        const FlightRecorder* expected = this;
+        recorder.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel);
+    }
+
+    ThreadRing* ring = m_rings.load(std::memory_order_acquire);
+    while (ring != nullptr)
+    {
+        ThreadRing* next = ring->next;
+        delete ring;
+        ring = next;
+    }
+}
+
+void FlightRecorder::record(const Severity severity, const ComponentEnumEntry& component, const std::string& message,
+                            const std::string& file, const uint32_t line)
+{
+    ThreadRing& ring = _thread_ring();
+    const uint64_t index = ring.head.load(std::memory_order_relaxed);
+
+    FlightRecord record{};
+    record.index = index;
+    record.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    record.line = line;
+    record.severity = static_cast<int32_t>(severity);
+    // Cached per thread by ComponentEnumEntry, so recording a known component neither formats nor allocates
+    const std::string_view component_name = component.name();
+    copy_truncated(record.component, COMPONENT_SIZE, component_name.data(), component_name.size());
+    copy_truncated(record.file, FILE_SIZE, file.c_str(), file.size());
+    copy_truncated(record.message, MESSAGE_SIZE, message.c_str(), message.size());
+
+    std::array<uint64_t, RECORD_WORDS> words;
+    std::memcpy(words.data(), &record, sizeof(record));
+
+    FlightSlot& slot = ring.slots[index % m_records_per_thread];
+    const uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t word = 0; word < RECORD_WORDS; ++word)
+        slot.words[word].store(words[word], std::memory_order_relaxed);
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+    ring.head.store(index + 1, std::memory_order_release);
+}
+
+bool FlightRecorder::dump() const
+{
+#if defined(_WIN32)
+    const int descriptor = _open(m_dump_path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    const int descriptor = ::open(m_dump_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+    if (descriptor < 0)
+        return false;
+
+    SignalSafeWriter writer(descriptor);
+    for (const ThreadRing* ring = m_rings.load(std::memory_order_acquire); ring != nullptr; ring = ring->next)
+    {
+        writer.append("--- thread ");
+        writer.append(ring->thread_number);
+        writer.append(" ---\n");
+
+        const uint64_t head = ring->head.load(std::memory_order_acquire);
+        const uint64_t first = (head > m_records_per_thread) ? head - m_records_per_thread : 0;
+        for (uint64_t index = first; index < head; ++index)
+        {
+            FlightRecord record;
+            if (!_read_slot(ring->slots[index % m_records_per_thread], index, record))
+                continue;
+            const size_t severity = static_cast<size_t>(record.severity);
+            writer.append(static_cast<uint64_t>(record.timestamp_ns));
+            writer.append(" [");
+            writer.append(severity < SEVERITY_NAMES.size() ? SEVERITY_NAMES[severity] : "UnknownSeverity");
+            writer.append("] ");
+            writer.append(record.component);
+            writer.append(" (");
+            writer.append(record.file);
+            writer.append(":");
+            writer.append(static_cast<uint64_t>(record.line));
+            writer.append("): ");
+            writer.append(record.message);
+            writer.append("\n");
+        }
+    }
+    writer.flush();
+#if defined(_WIN32)
+    _close(descriptor);
+#else
+    ::close(descriptor);
+#endif
+    return true;
+}
+
+void FlightRecorder::install_crash_handler()
+{
+    bool is_registered = false;
+    for (std::atomic<const FlightRecorder*>& recorder : crash_recorders)
+    {
+        const FlightRecorder* expected = nullptr;
+        if (recorder.compare_exchange_strong(expected, this, std::memory_order_acq_rel) || expected == this)
+        {
+            is_registered = true;
+            break;
+        }
+    }
+    if (!is_registered)
+    {
+        throw std::runtime_error("Too many flight recorders registered for crash dumps");
+    }
+
+    if (is_crash_handler_installed.exchange(true))
+        return;
+    for (size_t index = 0; index < CRASH_SIGNALS.size(); ++index)
+    {
+#if defined(_WIN32)
+        previous_handlers[index] = std::signal(CRASH_SIGNALS[index], crash_signal_handler);
+#else
+        struct sigaction action{};
+        action.sa_handler = crash_signal_handler;
+        sigemptyset(&action.sa_mask);
+        sigaction(CRASH_SIGNALS[index], &action, &previous_actions[index]);
+#endif
+    }
+}
+
+FlightRecorder::ThreadRing& FlightRecorder::_thread_ring()
+{
+    for (const ThreadRingCacheEntry& entry : thread_ring_cache.entries)
+    {
+        if (entry.recorder_id == m_recorder_id)
+            return *static_cast<ThreadRing*>(entry.ring);
+    }
+
+    const std::thread::id thread_id = std::this_thread::get_id();
+    ThreadRing* ring = m_rings.load(std::memory_order_acquire);
+    while (ring != nullptr && ring->owner != thread_id)
+        ring = ring->next;
+
+    if (ring == nullptr)
+    {
+        ring = new ThreadRing();
+        ring->owner = thread_id;
+        ring->thread_number = m_ring_count.fetch_add(1, std::memory_order_relaxed);
+        ring->slots.reset(new FlightSlot[m_records_per_thread]);
+        ring->next = m_rings.load(std::memory_order_relaxed);
+        while (!m_rings.compare_exchange_weak(ring->next, ring, std::memory_order_release, std::memory_order_relaxed)) {}
+    }
+
+    ThreadRingCacheEntry& entry = thread_ring_cache.entries[thread_ring_cache.next_replaced];
+    thread_ring_cache.next_replaced = (thread_ring_cache.next_replaced + 1) % THREAD_RING_CACHE_SIZE;
+    entry.recorder_id = m_recorder_id;
+    entry.ring = ring;
+    return *ring;
+}
+
+bool FlightRecorder::_read_slot(const FlightSlot& slot, const uint64_t index, FlightRecord& record)
+{
+    const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence % 2 != 0)
+        return false;
+    std::array<uint64_t, RECORD_WORDS> words;
+    for (size_t word = 0; word < RECORD_WORDS; ++word)
+        words[word] = slot.words[word].load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+        return false;
+    std::memcpy(&record, words.data(), sizeof(record));
+    return record.index == index;
+}
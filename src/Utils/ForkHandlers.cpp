@@ -0,0 +1,74 @@
+#include "Utils/ForkHandlers.hpp"
+
+#include <map>
+#include <mutex>
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#endif
+
+namespace {
+
+struct ForkHandlerRegistry
+{
+    // Held from the prepare hook until the parent or child hook, so the handlers that ran are the ones completed
+    std::mutex mutex;
+    // By registration order
+    std::map<uint64_t, ForkHandlers> handlers;
+    uint64_t next_id{1};
+};
+
+ForkHandlerRegistry& fork_handler_registry()
+{
+    // Never destroyed, registrations of static objects may outlive it otherwise
+    static ForkHandlerRegistry* const registry = new ForkHandlerRegistry();
+    return *registry;
+}
+
+#if !defined(_WIN32)
+void prepare_fork()
+{
+    ForkHandlerRegistry& registry = fork_handler_registry();
+    registry.mutex.lock();
+    for (auto handler_iterator = registry.handlers.rbegin(); handler_iterator != registry.handlers.rend(); ++handler_iterator)
+        if (handler_iterator->second.prepare) handler_iterator->second.prepare();
+}
+
+void complete_fork_in_parent()
+{
+    ForkHandlerRegistry& registry = fork_handler_registry();
+    for (const std::pair<const uint64_t, ForkHandlers>& handler : registry.handlers)
+        if (handler.second.parent) handler.second.parent();
+    registry.mutex.unlock();
+}
+
+void complete_fork_in_child()
+{
+    // The child's copy of the mutex was locked by the forking thread, which is the thread running this hook
+    ForkHandlerRegistry& registry = fork_handler_registry();
+    for (const std::pair<const uint64_t, ForkHandlers>& handler : registry.handlers)
+        if (handler.second.child) handler.second.child();
+    registry.mutex.unlock();
+}
+#endif
+
+} // namespace
+
+ForkHandlerRegistration::ForkHandlerRegistration(ForkHandlers handlers)
+{
+#if !defined(_WIN32)
+    static std::once_flag install_flag;
+    std::call_once(install_flag, [] { pthread_atfork(prepare_fork, complete_fork_in_parent, complete_fork_in_child); });
+#endif
+    ForkHandlerRegistry& registry = fork_handler_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    m_id = registry.next_id++;
+    registry.handlers.emplace(m_id, std::move(handlers));
+}
+
+ForkHandlerRegistration::~ForkHandlerRegistration()
+{
+    ForkHandlerRegistry& registry = fork_handler_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.handlers.erase(m_id);
+}
@@ -0,0 +1,218 @@
+#include "Utils/JsonLinesFormat.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "Utils/SeverityUtils.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CALLBACK_LOGGER_JSON_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#if defined(CALLBACK_LOGGER_JSON_SSE2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CALLBACK_LOGGER_JSON_AVX2
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Record keys with their punctuation, so a record is assembled from constant pieces
+constexpr std::string_view TIMESTAMP_KEY = "{\"timestamp\":\"";
+constexpr std::string_view SEVERITY_KEY = "\",\"severity\":\"";
+constexpr std::string_view COMPONENT_KEY = "\",\"component\":\"";
+constexpr std::string_view FILE_KEY = "\",\"file\":\"";
+constexpr std::string_view LINE_KEY = "\",\"line\":";
+constexpr std::string_view MESSAGE_KEY = ",\"message\":\"";
+constexpr std::string_view FIELDS_KEY = ",\"fields\":{";
+
+using FindEscapeFunction = size_t (*)(const char* data, size_t position, size_t size);
+
+bool is_escaped_character(const char character)
+{
+    const unsigned char byte = static_cast<unsigned char>(character);
+    return byte < 0x20 || byte == '"' || byte == '\\';
+}
+
+size_t find_escape_scalar(const char* data, size_t position, const size_t size)
+{
+    while (position < size && !is_escaped_character(data[position]))
+        ++position;
+    return position;
+}
+
+#ifdef CALLBACK_LOGGER_JSON_SSE2
+size_t lowest_set_bit(const uint32_t mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return static_cast<size_t>(__builtin_ctz(mask));
+#endif
+}
+
+size_t find_escape_sse2(const char* data, size_t position, const size_t size)
+{
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control_max = _mm_set1_epi8(0x1F);
+    for (; position + 16 <= size; position += 16)
+    {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position));
+        // Unsigned byte <= 0x1F exactly when max(byte, 0x1F) == 0x1F
+        const __m128i is_control = _mm_cmpeq_epi8(_mm_max_epu8(chunk, control_max), control_max);
+        const __m128i is_escaped = _mm_or_si128(is_control,
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)));
+        const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(is_escaped));
+        if (mask != 0)
+            return position + lowest_set_bit(mask);
+    }
+    return find_escape_scalar(data, position, size);
+}
+#endif
+
+#ifdef CALLBACK_LOGGER_JSON_AVX2
+__attribute__((target("avx2")))
+size_t find_escape_avx2(const char* data, size_t position, const size_t size)
+{
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i control_max = _mm256_set1_epi8(0x1F);
+    for (; position + 32 <= size; position += 32)
+    {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + position));
+        const __m256i is_control = _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, control_max), control_max);
+        const __m256i is_escaped = _mm256_or_si256(is_control,
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash)));
+        const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(is_escaped));
+        if (mask != 0)
+            return position + lowest_set_bit(mask);
+    }
+    // The compiler does not clear the upper halves before tail calling legacy SSE code, which would stall on every call
+    _mm256_zeroupper();
+    return find_escape_sse2(data, position, size);
+}
+#endif
+
+FindEscapeFunction select_find_escape()
+{
+#ifdef CALLBACK_LOGGER_JSON_AVX2
+    if (__builtin_cpu_supports("avx2"))
+        return find_escape_avx2;
+#endif
+#ifdef CALLBACK_LOGGER_JSON_SSE2
+    return find_escape_sse2;
+#else
+    return find_escape_scalar;
+#endif
+}
+
+void append_escape_sequence(std::string& text, const char character)
+{
+    switch (character)
+    {
+        case '"': text += "\\\""; return;
+        case '\\': text += "\\\\"; return;
+        case '\n': text += "\\n"; return;
+        case '\r': text += "\\r"; return;
+        case '\t': text += "\\t"; return;
+        case '\b': text += "\\b"; return;
+        case '\f': text += "\\f"; return;
+        default: break;
+    }
+    constexpr const char* HEX_DIGITS = "0123456789abcdef";
+    const unsigned char byte = static_cast<unsigned char>(character);
+    const char sequence[6] = {'\\', 'u', '0', '0', HEX_DIGITS[byte >> 4], HEX_DIGITS[byte & 0xF]};
+    text.append(sequence, sizeof(sequence));
+}
+
+void append_json_number(std::string& text, const LogField& field)
+{
+    char buffer[32];
+    std::to_chars_result result{};
+    if (field.type == LogFieldType::Int)
+    {
+        result = std::to_chars(buffer, buffer + sizeof(buffer), field.int_value);
+    }
+    else if (std::isfinite(field.double_value))
+    {
+        result = std::to_chars(buffer, buffer + sizeof(buffer), field.double_value);
+    }
+    else
+    {
+        // JSON has no representation for NaN and infinities
+        text += "null";
+        return;
+    }
+    text.append(buffer, result.ptr);
+}
+
+} // namespace
+
+void append_json_escaped(std::string& text, const std::string_view value)
+{
+    static const FindEscapeFunction find_escape = select_find_escape();
+    const char* data = value.data();
+    const size_t size = value.size();
+    size_t run_start = 0;
+    while (run_start < size)
+    {
+        const size_t escape_position = find_escape(data, run_start, size);
+        text.append(data + run_start, escape_position - run_start);
+        if (escape_position == size)
+            break;
+        append_escape_sequence(text, data[escape_position]);
+        run_start = escape_position + 1;
+    }
+}
+
+void append_json_log_line(const LogEntry& entry, std::string& line)
+{
+    line += TIMESTAMP_KEY;
+    append_json_escaped(line, entry.timestamp);
+    line += SEVERITY_KEY;
+    line += severity_name(entry.severity);
+    line += COMPONENT_KEY;
+    append_json_escaped(line, entry.component.name());
+    line += FILE_KEY;
+    append_json_escaped(line, entry.file);
+    line += LINE_KEY;
+    char line_buffer[16];
+    line.append(line_buffer, std::to_chars(line_buffer, line_buffer + sizeof(line_buffer), entry.line).ptr);
+    line += MESSAGE_KEY;
+    append_json_escaped(line, entry.message);
+    line += '"';
+    if (!entry.fields.empty())
+    {
+        line += FIELDS_KEY;
+        for (size_t index = 0; index < entry.fields.size(); ++index)
+        {
+            const LogField field = entry.fields[index];
+            if (index != 0)
+                line += ',';
+            line += '"';
+            append_json_escaped(line, field.key);
+            line += "\":";
+            if (field.type == LogFieldType::String)
+            {
+                line += '"';
+                append_json_escaped(line, field.string_value);
+                line += '"';
+            }
+            else
+            {
+                append_json_number(line, field);
+            }
+        }
+        line += '}';
+    }
+    line += "}\n";
+}
@@ -0,0 +1,110 @@
+#include "Utils/LogEntryPool.hpp"
+
+#include <new>
+
+namespace {
+
+thread_local LogEntryPool* current_thread_pool = nullptr;
+thread_local bool is_thread_pool_destroyed = false;
+
+}
+
+/**
+ * @brief Owns the calling thread's pool reference and drops it when the thread exits.
+ */
+struct LogEntryPoolOwner
+{
+    LogEntryPool* pool = new LogEntryPool();
+
+    LogEntryPoolOwner() { current_thread_pool = pool; }
+
+    ~LogEntryPoolOwner()
+    {
+        current_thread_pool = nullptr;
+        is_thread_pool_destroyed = true;
+        pool->_release();
+    }
+};
+
+LogEntryPool::~LogEntryPool()
+{
+    for (void* slab : m_slabs)
+        ::operator delete(slab);
+}
+
+LogEntryPool* LogEntryPool::_thread_pool()
+{
+    if (is_thread_pool_destroyed)
+        return nullptr;
+    thread_local LogEntryPoolOwner owner;
+    return owner.pool;
+}
+
+void* LogEntryPool::allocate(const size_t size)
+{
+    LogEntryPool* pool = (size <= BLOCK_SIZE - sizeof(BlockHeader)) ? _thread_pool() : nullptr;
+    BlockHeader* header;
+    if (pool == nullptr)
+    {
+        header = static_cast<BlockHeader*>(::operator new(sizeof(BlockHeader) + size));
+        header->origin = nullptr;
+    }
+    else
+    {
+        header = reinterpret_cast<BlockHeader*>(pool->_pop_block());
+        header->origin = pool;
+        pool->m_references.fetch_add(1, std::memory_order_relaxed);
+    }
+    return header + 1;
+}
+
+void LogEntryPool::deallocate(void* pointer) noexcept
+{
+    BlockHeader* header = static_cast<BlockHeader*>(pointer) - 1;
+    LogEntryPool* origin = header->origin;
+    if (origin == nullptr)
+    {
+        ::operator delete(header);
+        return;
+    }
+
+    FreeBlock* block = reinterpret_cast<FreeBlock*>(header);
+    if (origin == current_thread_pool)
+    {
+        block->next = origin->m_local_free;
+        origin->m_local_free = block;
+    }
+    else
+    {
+        // Only the owner ever takes from the returned list, and it takes the whole list at once, so pushing is ABA-free
+        block->next = origin->m_returned_free.load(std::memory_order_relaxed);
+        while (!origin->m_returned_free.compare_exchange_weak(block->next, block, std::memory_order_release, std::memory_order_relaxed)) {}
+    }
+    origin->_release();
+}
+
+LogEntryPool::FreeBlock* LogEntryPool::_pop_block()
+{
+    if (m_local_free == nullptr)
+        m_local_free = m_returned_free.exchange(nullptr, std::memory_order_acquire);
+    if (m_local_free == nullptr)
+    {
+        char* slab = static_cast<char*>(::operator new(BLOCK_SIZE * BLOCKS_PER_SLAB));
+        m_slabs.push_back(slab);
+        for (size_t block_index = 0; block_index < BLOCKS_PER_SLAB; ++block_index)
+        {
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(slab + block_index * BLOCK_SIZE);
+            block->next = m_local_free;
+            m_local_free = block;
+        }
+    }
+    FreeBlock* block = m_local_free;
+    m_local_free = block->next;
+    return block;
+}
+
+void LogEntryPool::_release() noexcept
+{
+    if (m_references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        delete this;
+}
@@ -0,0 +1,122 @@
+#include "Utils/LogFormatter.hpp"
+
+#include <charconv>
+#include <stdexcept>
+
+#include "Utils/JsonLinesFormat.hpp"
+#include "Utils/SeverityUtils.hpp"
+
+PatternFormatter::PatternFormatter(const std::string& pattern)
+    : m_pattern(pattern)
+{
+    if (pattern.empty())
+    {
+        throw std::invalid_argument("Log format pattern cannot be empty");
+    }
+    std::string literal;
+    for (size_t position = 0; position < pattern.size(); ++position)
+    {
+        if (pattern[position] != '%')
+        {
+            literal += pattern[position];
+            continue;
+        }
+        if (position + 1 == pattern.size())
+        {
+            throw std::invalid_argument("Log format pattern ends with an incomplete directive: " + pattern);
+        }
+        const char directive = pattern[++position];
+        if (directive == '%')
+        {
+            literal += '%';
+            continue;
+        }
+
+        StepType type;
+        switch (directive)
+        {
+            case 'T': type = StepType::Timestamp; break;
+            case 'S': type = StepType::Severity; break;
+            case 'C': type = StepType::Component; break;
+            case 'F': type = StepType::File; break;
+            case 'L': type = StepType::Line; break;
+            case 'M': type = StepType::Message; break;
+            case 'A': type = StepType::Fields; break;
+            case 'P': type = StepType::SeverityMarker; break;
+            default:
+                throw std::invalid_argument(std::string("Unknown log format directive %") + directive + " in pattern: " + pattern);
+        }
+        // Consecutive literal characters are merged into one step
+        if (!literal.empty())
+        {
+            m_steps.push_back(FormatStep{StepType::Literal, std::move(literal)});
+            literal.clear();
+        }
+        m_steps.push_back(FormatStep{type, {}});
+    }
+    literal += '\n';
+    m_steps.push_back(FormatStep{StepType::Literal, std::move(literal)});
+}
+
+void PatternFormatter::format(const LogEntry& entry, std::string& line) const
+{
+    for (const FormatStep& step : m_steps)
+    {
+        switch (step.type)
+        {
+            case StepType::Literal:
+                line += step.literal;
+                break;
+            case StepType::Timestamp:
+                line += entry.timestamp;
+                break;
+            case StepType::Severity:
+                line += severity_name(entry.severity);
+                break;
+            case StepType::Component:
+                line += entry.component.name();
+                break;
+            case StepType::File:
+                line += entry.file;
+                break;
+            case StepType::Line:
+            {
+                char buffer[16];
+                line.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), entry.line).ptr);
+                break;
+            }
+            case StepType::Message:
+                line += entry.message;
+                break;
+            case StepType::Fields:
+                entry.fields.append_to(line);
+                break;
+            case StepType::SeverityMarker:
+                line += (entry.severity >= Severity::Warning) ? "[!]" : "[*]";
+                break;
+        }
+    }
+}
+
+bool PatternFormatter::has_same_layout(const LogFormatter& other) const
+{
+    const PatternFormatter* other_pattern = dynamic_cast<const PatternFormatter*>(&other);
+    return other_pattern != nullptr && other_pattern->m_pattern == m_pattern;
+}
+
+void JsonLinesFormatter::format(const LogEntry& entry, std::string& line) const
+{
+    append_json_log_line(entry, line);
+}
+
+bool JsonLinesFormatter::has_same_layout(const LogFormatter& other) const
+{
+    return dynamic_cast<const JsonLinesFormatter*>(&other) != nullptr;
+}
+
+LogFormatterPtr make_log_formatter(const FileFormat format)
+{
+    static const LogFormatterPtr TEXT_FORMATTER = std::make_shared<const PatternFormatter>(PatternFormatter::DEFAULT_PATTERN);
+    static const LogFormatterPtr JSON_LINES_FORMATTER = std::make_shared<const JsonLinesFormatter>();
+    return (format == FileFormat::JsonLines) ? JSON_LINES_FORMATTER : TEXT_FORMATTER;
+}
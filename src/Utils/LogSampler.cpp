@@ -0,0 +1,125 @@
+#include "Utils/LogSampler.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace {
+
+thread_local uint64_t thread_trace_id = 0;
+
+uint64_t split_mix(uint64_t value)
+{
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+void validate_sampling_arguments(const Severity severity, const double rate)
+{
+    if (severity < Severity::Debug || severity > Severity::Fatal)
+    {
+        throw std::invalid_argument("Invalid severity for sampling rate: " + std::to_string(static_cast<int>(severity)));
+    }
+    if (!(rate >= 0.0 && rate <= 1.0))
+    {
+        throw std::invalid_argument("Sampling rate must be between 0 and 1: " + std::to_string(rate));
+    }
+}
+
+}
+
+void LogSampler::set_rate(const Severity severity, const double rate)
+{
+    validate_sampling_arguments(severity, rate);
+    m_thresholds[static_cast<size_t>(severity)].store(_rate_to_threshold(rate), std::memory_order_relaxed);
+    if (rate < 1.0)
+        m_is_enabled.store(true, std::memory_order_relaxed);
+}
+
+void LogSampler::set_rate(const ComponentEnumEntry& component, const Severity severity, const double rate)
+{
+    validate_sampling_arguments(severity, rate);
+    const size_t severity_index = static_cast<size_t>(severity);
+    {
+        std::lock_guard<std::mutex> lock(m_component_thresholds_mutex);
+        const ComponentThresholdMap* previous_thresholds = m_component_thresholds.load(std::memory_order_relaxed);
+        std::unique_ptr<ComponentThresholdMap> thresholds = previous_thresholds
+            ? std::make_unique<ComponentThresholdMap>(*previous_thresholds) : std::make_unique<ComponentThresholdMap>();
+        ComponentThresholds& component_thresholds = (*thresholds)[component];
+        component_thresholds.overridden_severities |= 1u << severity_index;
+        component_thresholds.thresholds[severity_index] = _rate_to_threshold(rate);
+        m_component_thresholds.store(thresholds.release(), std::memory_order_release);
+        if (previous_thresholds)
+            m_component_threshold_epochs.retire(std::unique_ptr<const ComponentThresholdMap>(previous_thresholds));
+    }
+    (void)m_component_threshold_epochs.reclaim();
+    m_is_enabled.store(true, std::memory_order_relaxed);
+}
+
+bool LogSampler::should_keep(const Severity severity, const ComponentEnumEntry& component) const
+{
+    const size_t severity_index = static_cast<size_t>(severity);
+    uint64_t threshold = m_thresholds[severity_index].load(std::memory_order_relaxed);
+    if (m_component_thresholds.load(std::memory_order_relaxed) != nullptr)
+    {
+        EpochDomain::Guard guard(m_component_threshold_epochs);
+        const ComponentThresholdMap* component_thresholds = m_component_thresholds.load(std::memory_order_acquire);
+        const auto thresholds_iterator = component_thresholds->find(component);
+        if (thresholds_iterator != component_thresholds->end()
+            && (thresholds_iterator->second.overridden_severities & (1u << severity_index)) != 0)
+            threshold = thresholds_iterator->second.thresholds[severity_index];
+    }
+    if (threshold == KEEP_ALL)
+        return true;
+    return _next_sample() < threshold;
+}
+
+void LogSampler::set_thread_trace_id(const uint64_t trace_id)
+{
+    thread_trace_id = trace_id;
+}
+
+LogSampler::~LogSampler()
+{
+    delete m_component_thresholds.load(std::memory_order_relaxed);
+}
+
+void LogSampler::lock_for_fork()
+{
+    m_component_thresholds_mutex.lock();
+}
+
+void LogSampler::unlock_after_fork(const bool is_child)
+{
+    // Rates only change under the mutex, so no writer was retiring a snapshot during the fork
+    if (is_child)
+        m_component_threshold_epochs.reset_after_fork();
+    m_component_thresholds_mutex.unlock();
+}
+
+uint64_t LogSampler::_rate_to_threshold(const double rate)
+{
+    if (rate >= 1.0)
+        return KEEP_ALL;
+    return static_cast<uint64_t>(std::ldexp(rate, 64));
+}
+
+uint64_t LogSampler::_next_sample()
+{
+    if (thread_trace_id != 0)
+        return split_mix(thread_trace_id);
+
+    thread_local uint64_t state = split_mix(std::hash<std::thread::id>()(std::this_thread::get_id())
+        ^ static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count())) | 1;
+    // xorshift64*
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1DULL;
+}
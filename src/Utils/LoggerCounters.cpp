@@ -0,0 +1,30 @@
+#include "Utils/LoggerCounters.hpp"
+
+size_t latency_bucket(const std::chrono::nanoseconds elapsed)
+{
+    uint64_t microseconds = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    size_t bucket = 0;
+    while (microseconds > 0 && bucket < LATENCY_HISTOGRAM_BUCKET_COUNT - 1)
+    {
+        microseconds >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+void CallbackCounters::record_invocation(const std::chrono::nanoseconds elapsed)
+{
+    invocations.add();
+    latency_histogram[latency_bucket(elapsed)].fetch_add(1, std::memory_order_relaxed);
+}
+
+CallbackStatistics CallbackCounters::snapshot() const
+{
+    CallbackStatistics statistics;
+    statistics.invocations = invocations.load();
+    statistics.exceptions = exceptions.load();
+    statistics.is_disabled = is_disabled.load(std::memory_order_relaxed);
+    for (size_t bucket = 0; bucket < LATENCY_HISTOGRAM_BUCKET_COUNT; ++bucket)
+        statistics.latency_histogram[bucket] = latency_histogram[bucket].load(std::memory_order_relaxed);
+    return statistics;
+}
@@ -1,13 +1,39 @@
 #include "Utils/LoggerInternalCallbacks.hpp"
 
-void file_log_callback(const LogEntry& entry, const std::string& file_path)
+#include <filesystem>
+
+#include "Utils/LogFormatter.hpp"
+
+std::string format_file_log_line(const LogEntry& entry)
+{
+    static const LogFormatterPtr TEXT_FORMATTER = make_log_formatter(FileFormat::Text);
+    std::string line;
+    TEXT_FORMATTER->format(entry, line);
+    return line;
+}
+
+std::string canonical_file_path(const std::string& file_path)
+{
+    std::error_code error;
+    // Made absolute first, weakly_canonical leaves a relative path untouched when none of it exists yet
+    const std::filesystem::path absolute_path = std::filesystem::absolute(file_path, error);
+    if (error)
+        return file_path;
+    const std::filesystem::path canonical_path = std::filesystem::weakly_canonical(absolute_path, error);
+    if (error)
+        return file_path;
+    return canonical_path.string();
+}
+
+void append_to_file(const std::string& file_path, const std::string& text)
 {
     std::ofstream file_stream(file_path, std::ios::app);
     if (!file_stream.is_open()) return;
-    constexpr const char* ERROR_PREFIX = "[!] ";
-    constexpr const char* INFO_PREFIX = "[*] ";
-    file_stream << ((entry.severity >= Severity::Warning) ? ERROR_PREFIX : INFO_PREFIX)
-        << "[" << entry.timestamp << "] [" << to_string(entry.severity) << "] "
-        << entry.component.to_string() << " (" << entry.file << ":" << entry.line << "): "
-        << entry.message << std::endl;
+    file_stream.write(text.data(), static_cast<std::streamsize>(text.size()));
+    file_stream.flush();
+}
+
+void file_log_callback(const LogEntry& entry, const std::string& file_path)
+{
+    append_to_file(file_path, format_file_log_line(entry));
 }
@@ -0,0 +1,118 @@
+#include "Utils/MessageMatcher.hpp"
+
+#include <algorithm>
+#include <queue>
+#include <stdexcept>
+
+MessageMatcher::MessageMatcher(const MessageFilter& filter)
+    : m_type(filter.type)
+{
+    if (m_type == MessageFilterType::None)
+        return;
+    if (filter.patterns.empty())
+    {
+        throw std::invalid_argument("Message filter must have at least one pattern");
+    }
+    if (std::any_of(filter.patterns.begin(), filter.patterns.end(), [](const std::string& pattern) { return pattern.empty(); }))
+    {
+        throw std::invalid_argument("Message filter patterns cannot be empty");
+    }
+
+    switch (m_type)
+    {
+    case MessageFilterType::Substring:
+        m_substring = filter.patterns.front();
+        m_substring_searcher.emplace(m_substring.cbegin(), m_substring.cend());
+        break;
+    case MessageFilterType::AnyOf:
+        _build_automaton(filter.patterns);
+        break;
+    case MessageFilterType::Regex:
+        try
+        {
+            m_regex = std::regex(filter.patterns.front(), std::regex::ECMAScript | std::regex::optimize);
+        }
+        catch (const std::regex_error& error)
+        {
+            throw std::invalid_argument("Invalid message filter regex: " + filter.patterns.front() + " (" + error.what() + ")");
+        }
+        break;
+    default:
+        throw std::invalid_argument("Invalid message filter type: " + std::to_string(static_cast<int>(m_type)));
+    }
+}
+
+bool MessageMatcher::matches(const std::string& message) const
+{
+    switch (m_type)
+    {
+    case MessageFilterType::Substring:
+        return std::search(message.cbegin(), message.cend(), *m_substring_searcher) != message.cend();
+    case MessageFilterType::AnyOf:
+        return _matches_any(message);
+    case MessageFilterType::Regex:
+        return std::regex_search(message, m_regex);
+    default:
+        return true;
+    }
+}
+
+void MessageMatcher::_build_automaton(const std::vector<std::string>& patterns)
+{
+    // State 0 is the root, a zero transition from any other state means "not in the trie" until failure links are folded
+    m_automaton.emplace_back();
+    for (const std::string& pattern : patterns)
+    {
+        uint32_t state = 0;
+        for (const char character : pattern)
+        {
+            const uint8_t symbol = static_cast<uint8_t>(character);
+            if (m_automaton[state].transitions[symbol] == 0)
+            {
+                m_automaton[state].transitions[symbol] = static_cast<uint32_t>(m_automaton.size());
+                m_automaton.emplace_back();
+            }
+            state = m_automaton[state].transitions[symbol];
+        }
+        m_automaton[state].is_match = true;
+    }
+
+    // Breadth-first, each missing transition takes the transition of the failure state, which is already complete
+    std::vector<uint32_t> failure(m_automaton.size(), 0);
+    std::queue<uint32_t> pending;
+    for (size_t symbol = 0; symbol < ALPHABET_SIZE; ++symbol)
+        if (m_automaton[0].transitions[symbol] != 0)
+            pending.push(m_automaton[0].transitions[symbol]);
+
+    while (!pending.empty())
+    {
+        const uint32_t state = pending.front();
+        pending.pop();
+        m_automaton[state].is_match = m_automaton[state].is_match || m_automaton[failure[state]].is_match;
+        for (size_t symbol = 0; symbol < ALPHABET_SIZE; ++symbol)
+        {
+            const uint32_t next = m_automaton[state].transitions[symbol];
+            if (next != 0)
+            {
+                failure[next] = m_automaton[failure[state]].transitions[symbol];
+                pending.push(next);
+            }
+            else
+            {
+                m_automaton[state].transitions[symbol] = m_automaton[failure[state]].transitions[symbol];
+            }
+        }
+    }
+}
+
+bool MessageMatcher::_matches_any(const std::string& message) const
+{
+    uint32_t state = 0;
+    for (const char character : message)
+    {
+        state = m_automaton[state].transitions[static_cast<uint8_t>(character)];
+        if (m_automaton[state].is_match)
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,54 @@
+#include "Utils/SerialExecutor.hpp"
+
+bool SerialExecutor::submit(std::function<void()> task)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pending.push_back(std::move(task));
+    if (m_is_scheduled)
+        return false;
+    m_is_scheduled = true;
+    return true;
+}
+
+bool SerialExecutor::drain(const size_t max_tasks)
+{
+    for (size_t task_count = 0; task_count < max_tasks; ++task_count)
+    {
+        std::function<void()> task;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_pending.empty())
+            {
+                m_is_scheduled = false;
+                return false;
+            }
+            task = std::move(m_pending.front());
+            m_pending.pop_front();
+        }
+        task();
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_pending.empty())
+    {
+        m_is_scheduled = false;
+        return false;
+    }
+    return true;
+}
+
+void SerialExecutor::lock_for_fork()
+{
+    m_mutex.lock();
+}
+
+void SerialExecutor::unlock_after_fork(const bool is_child)
+{
+    if (is_child)
+    {
+        // Leaked rather than destroyed, the tasks may own file writers whose destructor joins a thread of the parent
+        (void)new std::deque<std::function<void()>>(std::move(m_pending));
+        m_pending.clear();
+        m_is_scheduled = false;
+    }
+    m_mutex.unlock();
+}
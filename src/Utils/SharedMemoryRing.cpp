@@ -0,0 +1,276 @@
+#include "Utils/SharedMemoryRing.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr uint64_t RING_MAGIC = 0x43424C4F47524E47ULL;   // "CBLOGRNG"
+constexpr uint32_t RING_UNINITIALIZED = 0;
+constexpr uint32_t RING_INITIALIZING = 1;
+constexpr uint32_t RING_READY = 2;
+
+std::string segment_name(const std::string& name)
+{
+#if defined(_WIN32)
+    return "Local\\" + name;
+#else
+    return "/" + name;
+#endif
+}
+
+}
+
+struct alignas(64) SharedMemoryRing::RingHeader
+{
+    std::atomic<uint32_t> state;
+    uint64_t magic;
+    uint64_t slot_count;
+    alignas(64) std::atomic<uint64_t> enqueue_position;
+    alignas(64) std::atomic<uint64_t> dequeue_position;
+    alignas(64) std::atomic<uint64_t> dropped_count;
+};
+
+struct SharedMemoryRing::RingSlot
+{
+    std::atomic<uint64_t> sequence;
+    uint64_t size;
+    char data[SLOT_SIZE - 2 * sizeof(uint64_t)];
+};
+
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "Shared memory atomics must be plain words");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared memory atomics must be lock-free to work across processes");
+
+SharedMemoryRing::SharedMemoryRing(const std::string& name, const size_t slot_count)
+    : m_slot_count(slot_count), m_mapping_size(sizeof(RingHeader) + slot_count * sizeof(RingSlot))
+{
+    if (name.empty() || name.find('/') != std::string::npos || name.find('\\') != std::string::npos)
+    {
+        throw std::invalid_argument("Invalid shared memory ring name: " + name);
+    }
+    if (slot_count == 0 || (slot_count & (slot_count - 1)) != 0)
+    {
+        throw std::invalid_argument("Shared memory ring slot count must be a power of two: " + std::to_string(slot_count));
+    }
+
+#if defined(_WIN32)
+    const unsigned long long mapping_size = m_mapping_size;
+    m_mapping_handle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+        static_cast<DWORD>(mapping_size >> 32), static_cast<DWORD>(mapping_size & 0xFFFFFFFFULL), segment_name(name).c_str());
+    if (m_mapping_handle == nullptr)
+    {
+        throw std::runtime_error("Cannot create shared memory ring: " + name);
+    }
+    m_mapping = MapViewOfFile(m_mapping_handle, FILE_MAP_ALL_ACCESS, 0, 0, m_mapping_size);
+    if (m_mapping == nullptr)
+    {
+        CloseHandle(m_mapping_handle);
+        throw std::runtime_error("Cannot map shared memory ring: " + name);
+    }
+#else
+    // The exclusive creator sizes the segment, the other processes wait for the size and check it before mapping
+    const std::string shared_name = segment_name(name);
+    int descriptor = shm_open(shared_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    const bool is_creator = (descriptor >= 0);
+    if (!is_creator && errno == EEXIST)
+        descriptor = shm_open(shared_name.c_str(), O_RDWR, 0600);
+    if (descriptor < 0)
+    {
+        throw std::runtime_error("Cannot open shared memory ring: " + name);
+    }
+    if (is_creator)
+    {
+        // A new segment is zero-filled, which is the uninitialized state
+        if (ftruncate(descriptor, static_cast<off_t>(m_mapping_size)) != 0)
+        {
+            close(descriptor);
+            shm_unlink(shared_name.c_str());
+            throw std::runtime_error("Cannot size shared memory ring: " + name);
+        }
+    }
+    else
+    {
+        struct stat segment_status{};
+        const auto sizing_deadline = std::chrono::steady_clock::now() + STALLED_SLOT_TIMEOUT;
+        while (fstat(descriptor, &segment_status) == 0 && segment_status.st_size == 0
+               && std::chrono::steady_clock::now() < sizing_deadline)
+            std::this_thread::yield();
+        if (static_cast<size_t>(segment_status.st_size) != m_mapping_size)
+        {
+            close(descriptor);
+            throw std::runtime_error("Shared memory ring was created with another layout: " + name);
+        }
+    }
+    m_mapping = mmap(nullptr, m_mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+    if (m_mapping == MAP_FAILED)
+    {
+        m_mapping = nullptr;
+        throw std::runtime_error("Cannot map shared memory ring: " + name);
+    }
+#endif
+
+    m_header = static_cast<RingHeader*>(m_mapping);
+    try
+    {
+        _initialize();
+    }
+    catch (...)
+    {
+        _unmap();
+        throw;
+    }
+}
+
+SharedMemoryRing::~SharedMemoryRing()
+{
+    _unmap();
+}
+
+void SharedMemoryRing::_unmap()
+{
+#if defined(_WIN32)
+    if (m_mapping != nullptr)
+        UnmapViewOfFile(m_mapping);
+    if (m_mapping_handle != nullptr)
+        CloseHandle(m_mapping_handle);
+    m_mapping_handle = nullptr;
+#else
+    if (m_mapping != nullptr)
+        munmap(m_mapping, m_mapping_size);
+#endif
+    m_mapping = nullptr;
+}
+
+bool SharedMemoryRing::try_push(const void* data, const size_t size)
+{
+    if (size > max_record_size())
+        return false;
+
+    uint64_t position = m_header->enqueue_position.load(std::memory_order_relaxed);
+    RingSlot* slot = nullptr;
+    while (true)
+    {
+        slot = &_slot(position);
+        const uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+        const int64_t difference = static_cast<int64_t>(sequence) - static_cast<int64_t>(position);
+        if (difference == 0)
+        {
+            if (m_header->enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (difference < 0)
+        {
+            m_header->dropped_count.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else
+        {
+            position = m_header->enqueue_position.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->size = size;
+    std::memcpy(slot->data, data, size);
+    // Fails only if the consumer gave up on this producer and skipped the slot, which it counted as dropped
+    uint64_t reserved_sequence = position;
+    return slot->sequence.compare_exchange_strong(reserved_sequence, position + 1, std::memory_order_release,
+                                                  std::memory_order_relaxed);
+}
+
+bool SharedMemoryRing::try_pop(std::vector<char>& record)
+{
+    while (true)
+    {
+        const uint64_t position = m_header->dequeue_position.load(std::memory_order_relaxed);
+        RingSlot& slot = _slot(position);
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence == position + 1)
+        {
+            record.assign(slot.data, slot.data + std::min<uint64_t>(slot.size, max_record_size()));
+            slot.sequence.store(position + m_slot_count, std::memory_order_release);
+            m_header->dequeue_position.store(position + 1, std::memory_order_relaxed);
+            return true;
+        }
+        // Only a slot reserved by a producer and not published yet can stall, an empty ring has no reservation
+        if (sequence != position || m_header->enqueue_position.load(std::memory_order_relaxed) <= position
+            || !_is_stalled(position))
+            return false;
+        if (slot.sequence.compare_exchange_strong(sequence, position + m_slot_count, std::memory_order_acq_rel))
+        {
+            m_header->dequeue_position.store(position + 1, std::memory_order_relaxed);
+            m_header->dropped_count.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+bool SharedMemoryRing::_is_stalled(const uint64_t position)
+{
+    const auto now = std::chrono::steady_clock::now();
+    if (m_stalled_position != position)
+    {
+        m_stalled_position = position;
+        m_stalled_since = now;
+        return false;
+    }
+    return now - m_stalled_since >= STALLED_SLOT_TIMEOUT;
+}
+
+uint64_t SharedMemoryRing::dropped_count() const
+{
+    return m_header->dropped_count.load(std::memory_order_relaxed);
+}
+
+void SharedMemoryRing::remove(const std::string& name)
+{
+#if !defined(_WIN32)
+    shm_unlink(segment_name(name).c_str());
+#else
+    // A Windows file mapping disappears with its last handle
+    (void)name;
+#endif
+}
+
+void SharedMemoryRing::_initialize()
+{
+    uint32_t state = RING_UNINITIALIZED;
+    if (m_header->state.compare_exchange_strong(state, RING_INITIALIZING, std::memory_order_acquire))
+    {
+        m_header->magic = RING_MAGIC;
+        m_header->slot_count = m_slot_count;
+        m_header->enqueue_position.store(0, std::memory_order_relaxed);
+        m_header->dequeue_position.store(0, std::memory_order_relaxed);
+        m_header->dropped_count.store(0, std::memory_order_relaxed);
+        for (size_t index = 0; index < m_slot_count; ++index)
+            _slot(index).sequence.store(index, std::memory_order_relaxed);
+        m_header->state.store(RING_READY, std::memory_order_release);
+        return;
+    }
+
+    while (m_header->state.load(std::memory_order_acquire) != RING_READY)
+        std::this_thread::yield();
+    if (m_header->magic != RING_MAGIC || m_header->slot_count != m_slot_count)
+    {
+        throw std::runtime_error("Shared memory ring was created with another layout");
+    }
+}
+
+SharedMemoryRing::RingSlot& SharedMemoryRing::_slot(const uint64_t position) const
+{
+    RingSlot* slots = reinterpret_cast<RingSlot*>(reinterpret_cast<char*>(m_mapping) + sizeof(RingHeader));
+    return slots[position & (m_slot_count - 1)];
+}
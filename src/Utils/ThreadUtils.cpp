@@ -0,0 +1,74 @@
+#include "Utils/ThreadUtils.hpp"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#endif
+
+bool set_current_thread_affinity(const std::vector<size_t>& cpu_set)
+{
+#if defined(_WIN32)
+    DWORD_PTR affinity_mask = 0;
+    for (const size_t cpu : cpu_set)
+    {
+        if (cpu >= sizeof(DWORD_PTR) * 8) return false;
+        affinity_mask |= static_cast<DWORD_PTR>(1) << cpu;
+    }
+    return SetThreadAffinityMask(GetCurrentThread(), affinity_mask) != 0;
+#elif defined(__linux__)
+    cpu_set_t native_cpu_set;
+    CPU_ZERO(&native_cpu_set);
+    for (const size_t cpu : cpu_set)
+    {
+        if (cpu >= CPU_SETSIZE) return false;
+        CPU_SET(cpu, &native_cpu_set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(native_cpu_set), &native_cpu_set) == 0;
+#else
+    (void)cpu_set;
+    return false;
+#endif
+}
+
+bool is_cpu_allowed(const size_t cpu)
+{
+#if defined(_WIN32)
+    DWORD_PTR process_mask = 0;
+    DWORD_PTR system_mask = 0;
+    if (cpu >= sizeof(DWORD_PTR) * 8 || !GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask))
+        return cpu < sizeof(DWORD_PTR) * 8;
+    return (process_mask & (static_cast<DWORD_PTR>(1) << cpu)) != 0;
+#elif defined(__linux__)
+    cpu_set_t native_cpu_set;
+    CPU_ZERO(&native_cpu_set);
+    if (cpu >= CPU_SETSIZE)
+        return false;
+    if (sched_getaffinity(0, sizeof(native_cpu_set), &native_cpu_set) != 0)
+        return true;
+    return CPU_ISSET(cpu, &native_cpu_set);
+#else
+    (void)cpu;
+    return true;
+#endif
+}
+
+void set_current_thread_name(const std::string& name)
+{
+#if defined(_WIN32)
+    const std::wstring wide_name(name.begin(), name.end());
+    (void)SetThreadDescription(GetCurrentThread(), wide_name.c_str());
+#elif defined(__linux__)
+    constexpr size_t max_name_length = 15;
+    (void)pthread_setname_np(pthread_self(), name.substr(0, max_name_length).c_str());
+#elif defined(__APPLE__)
+    (void)pthread_setname_np(name.c_str());
+#else
+    (void)name;
+#endif
+}
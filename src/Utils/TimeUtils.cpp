@@ -1,5 +1,29 @@
 #include "Utils/TimeUtils.hpp"
 
+#include <atomic>
+#include <mutex>
+
+#include "Utils/ForkHandlers.hpp"
+
+namespace {
+
+// The C library converts local times under a lock of its own, which the child of a fork inherits locked if another
+// thread was converting. Once fork safety is enabled, conversions are serialized by this mutex instead, held around
+// fork() so it never is.
+std::mutex local_time_mutex;
+std::atomic<bool> is_local_time_fork_safe{false};
+
+} // namespace
+
+void enable_fork_safe_local_time()
+{
+    static const ForkHandlerRegistration registration(ForkHandlers{
+        [] { local_time_mutex.lock(); },
+        [] { local_time_mutex.unlock(); },
+        [] { local_time_mutex.unlock(); }});
+    is_local_time_fork_safe.store(true, std::memory_order_release);
+}
+
 std::string get_current_timestamp()
 {
     constexpr size_t ms_width = 3;
@@ -8,10 +32,24 @@ std::string get_current_timestamp()
     const std::chrono::time_point now = std::chrono::system_clock::now();
     const std::time_t time_t_now = std::chrono::system_clock::to_time_t(now);
     const std::chrono::duration ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % to_milliseconds;
-    struct tm timeinfo;
+
+    // Converted once per second and thread, so the mutex of fork safety is rarely contended
+    thread_local std::time_t converted_time = -1;
+    thread_local struct tm timeinfo;
+    if (time_t_now != converted_time)
+    {
+        std::unique_lock<std::mutex> lock(local_time_mutex, std::defer_lock);
+        if (is_local_time_fork_safe.load(std::memory_order_acquire))
+            lock.lock();
+#if defined(_WIN32)
+        (void)localtime_s(&timeinfo, &time_t_now);
+#else
+        (void)localtime_r(&time_t_now, &timeinfo);
+#endif
+        converted_time = time_t_now;
+    }
 
     std::ostringstream string_stream;
-    (void)localtime_s(&timeinfo, &time_t_now);
     string_stream << std::put_time(&timeinfo, "%Y-%m-%d %H:%M:%S")
         << "." << std::setfill('0') << std::setw(ms_width) << ms.count();
     return string_stream.str();
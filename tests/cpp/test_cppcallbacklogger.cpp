@@ -1,6 +1,7 @@
 
 #include <thread>
 #include <atomic>
+#include <mutex>
 #include <set>
 #include <unordered_map>
 #include <chrono>
@@ -8,11 +9,21 @@
 #include <vector>
 #include <string>
 #include <cstdio>
+#include <limits>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 #include "gtest/gtest.h"
 #include "CallbackLogger.hpp"
 
 enum class TestComponent { A, B, C, D, E };
+enum class StaticTestComponent { Network, Storage };
+CALLBACK_LOGGER_STATIC_COMPONENT(StaticTestComponent, 7);
 
 namespace {
 
@@ -770,4 +781,2305 @@ TEST(CppCallbackLogger, RegisterFileCallback_InvalidSeverityInMap_Throws)
         logger.register_file_callback("file.txt", filter),
         std::invalid_argument
     );
-}
\ No newline at end of file
+}
+TEST(CppCallbackLogger, Stats_WithSingleThreadedLogger_CountsEntriesAndInvocations)
+{
+    constexpr uint32_t logger_worker_count = 0;
+    // Arrange
+    CallbackLogger logger(logger_worker_count);
+    const uint32_t callback_handle = logger.register_function_callback([](const LogEntry&) {}, Severity::Warning);
+
+    // Act
+    logger.log(Severity::Info, make_entry(TestComponent::A), "filtered", "f.cpp", 1);
+    logger.log(Severity::Error, make_entry(TestComponent::A), "delivered", "f.cpp", 2);
+    logger.log(Severity::Error, make_entry(TestComponent::B), "delivered", "f.cpp", 3);
+    const LoggerStatistics statistics = logger.stats();
+
+    // Assert
+    ASSERT_EQ(statistics.logged_per_severity[static_cast<size_t>(Severity::Info)], 1);
+    ASSERT_EQ(statistics.logged_per_severity[static_cast<size_t>(Severity::Error)], 2);
+    ASSERT_EQ(statistics.logged_per_component.at(make_entry(TestComponent::A)), 2);
+    ASSERT_EQ(statistics.logged_per_component.at(make_entry(TestComponent::B)), 1);
+    ASSERT_EQ(statistics.filtered_out, 1);
+    ASSERT_EQ(statistics.function_callbacks.at(callback_handle).invocations, 2);
+    ASSERT_EQ(statistics.function_callbacks.at(callback_handle).exceptions, 0);
+}
+
+TEST(CppCallbackLogger, Stats_SuccessiveLoggersOnSameThread_CountComponentsSeparately)
+{
+    constexpr uint32_t logger_worker_count = 0;
+    constexpr uint32_t logger_count = 20;
+    // Arrange
+    auto first_logger = std::make_unique<CallbackLogger>(logger_worker_count);
+    first_logger->log(Severity::Info, make_entry(TestComponent::A), "msg", "f.cpp", 1);
+    first_logger.reset();
+
+    // Act
+    for (uint32_t i = 0; i < logger_count; ++i)
+    {
+        CallbackLogger logger(logger_worker_count);
+        logger.log(Severity::Info, make_entry(TestComponent::A), "msg", "f.cpp", 1);
+        logger.log(Severity::Info, make_entry(TestComponent::A), "msg", "f.cpp", 2);
+
+        // Assert
+        ASSERT_EQ(logger.stats().logged_per_component.at(make_entry(TestComponent::A)), 2);
+    }
+}
+
+TEST(CppCallbackLogger, Stats_WithThrowingCallback_CountsExceptions)
+{
+    constexpr uint32_t logger_worker_count = 0;
+    constexpr uint32_t log_count = 3;
+    // Arrange
+    CallbackLogger logger(logger_worker_count);
+    const uint32_t callback_handle = logger.register_function_callback(
+        [](const LogEntry&) { throw std::runtime_error("callback failure"); }, Severity::Debug);
+
+    // Act
+    for (uint32_t i = 0; i < log_count; ++i)
+        logger.log(Severity::Info, make_entry(TestComponent::A), "msg", "f.cpp", i + 1);
+    const CallbackStatistics statistics = logger.stats().function_callbacks.at(callback_handle);
+
+    // Assert
+    ASSERT_EQ(statistics.invocations, log_count);
+    ASSERT_EQ(statistics.exceptions, log_count);
+    uint64_t histogram_total = 0;
+    for (uint64_t bucket_count : statistics.latency_histogram)
+        histogram_total += bucket_count;
+    ASSERT_EQ(histogram_total, log_count);
+}
+
+TEST(CppCallbackLogger, Stats_WithWorkerThreads_CountsEnqueuedTasks)
+{
+    constexpr uint32_t logger_worker_count = 2;
+    constexpr uint32_t log_count = 100;
+    // Arrange
+    CallbackLogger logger(logger_worker_count);
+    std::atomic<uint32_t> received_count{0};
+    logger.register_function_callback([&](const LogEntry&) { received_count.fetch_add(1, std::memory_order_relaxed); }, Severity::Info);
+    logger.register_function_callback([&](const LogEntry&) { received_count.fetch_add(1, std::memory_order_relaxed); }, Severity::Info);
+
+    // Act
+    for (uint32_t i = 0; i < log_count; ++i)
+        logger.log(Severity::Info, make_entry(TestComponent::A), "msg", "f.cpp", i + 1);
+    // Busy time is accounted once a task returns, shortly after its callback counted the entry
+    const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    LoggerStatistics statistics = logger.stats();
+    while ((received_count.load() < 2 * log_count || statistics.queue_depth != 0 || statistics.worker_busy_time_ns == 0)
+           && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        statistics = logger.stats();
+    }
+
+    // Assert
+    ASSERT_EQ(received_count.load(), 2 * log_count);
+    ASSERT_EQ(statistics.tasks_enqueued, 2 * log_count);
+    ASSERT_EQ(statistics.queue_depth, 0);
+    ASSERT_GE(statistics.peak_queue_depth, 1);
+    ASSERT_GT(statistics.worker_busy_time_ns, 0);
+}
+
+TEST(CppCallbackLogger, SetErrorHandler_WithThrowingCallback_ReportsRateLimited)
+{
+    constexpr uint32_t logger_worker_count = 0;
+    constexpr uint32_t log_count = 5;
+    // Arrange
+    CallbackLogger logger(logger_worker_count);
+    std::vector<CallbackError> reported_errors;
+    logger.set_error_handler([&](const CallbackError& error) { reported_errors.push_back(error); });
+    logger.set_error_report_interval(std::chrono::hours(1));
+    const uint32_t callback_handle = logger.register_function_callback(
+        [](const LogEntry&) { throw std::runtime_error("callback failure"); }, Severity::Debug);
+
+    // Act
+    for (uint32_t i = 0; i < log_count; ++i)
+        logger.log(Severity::Info, make_entry(TestComponent::A), "msg", "f.cpp", i + 1);
+
+    // Assert
+    ASSERT_EQ(reported_errors.size(), 1);
+    ASSERT_EQ(reported_errors[0].handle, callback_handle);
+    ASSERT_EQ(reported_errors[0].message, "callback failure");
+    ASSERT_EQ(logger.stats().function_callbacks.at(callback_handle).exceptions, log_count);
+}
+
+TEST(CppCallbackLogger, SetErrorHandler_HandlerLogsThroughSingleThreadedLogger_DeliversItsEntry)
+{
+    constexpr uint32_t logger_worker_count = 0;
+    // Arrange
+    CallbackLogger logger(logger_worker_count);
+    std::vector<std::string> received_messages;
+    logger.set_error_report_interval(std::chrono::milliseconds(0));
+    logger.set_error_handler([&](const CallbackError& error) {
+        logger.log(Severity::Warning, make_entry(TestComponent::B), "handled " + error.message, "f.cpp", 1);
+    });
+    logger.register_function_callback([](const LogEntry&) { throw std::runtime_error("failure"); },
+                                      make_entry(TestComponent::A));
+    logger.register_function_callback([&](const LogEntry& entry) {
+        if (entry.message == "handled failure") throw std::runtime_error("second failure");
+        received_messages.push_back(entry.message);
+    }, make_entry(TestComponent::B));
+
+    // Act
+    logger.log(Severity::Info, make_entry(TestComponent::A), "msg", "f.cpp", 1);
+
+    // Assert
+    ASSERT_EQ(received_messages, std::vector<std::string>{"handled second failure"});
+}
+
+TEST(CppCallbackLogger, SetCallbackFailureThreshold_WithAlwaysThrowingCallback_DisablesCallback)
+{
+    constexpr uint32_t logger_worker_count = 0;
+    constexpr uint32_t failure_threshold = 3;
+    constexpr uint32_t log_count = 10;
+    // Arrange
+    CallbackLogger logger(logger_worker_count);
+    std::vector<CallbackError> reported_errors;
+    uint32_t invocation_count = 0;
+    logger.set_error_handler([&](const CallbackError& error) { reported_errors.push_back(error); });
+    logger.set_callback_failure_threshold(failure_threshold);
+    const uint32_t callback_handle = logger.register_function_callback(
+        [&](const LogEntry&) { ++invocation_count; throw std::runtime_error("callback failure"); }, Severity::Debug);
+
+    // Act
+    for (uint32_t i = 0; i < log_count; ++i)
+        logger.log(Severity::Info, make_entry(TestComponent::A), "msg", "f.cpp", i + 1);
+
+    // Assert
+    ASSERT_EQ(invocation_count, failure_threshold);
+    ASSERT_TRUE(logger.stats().function_callbacks.at(callback_handle).is_disabled);
+    ASSERT_FALSE(reported_errors.empty());
+    ASSERT_TRUE(reported_errors.back().is_disabled);
+}
+
+TEST(CppCallbackLogger, SetCallbackFailureThreshold_WithIntermittentFailures_KeepsCallbackEnabled)
+{
+    constexpr uint32_t logger_worker_count = 0;
+    constexpr uint32_t failure_threshold = 2;
+    constexpr uint32_t log_count = 10;
+    // Arrange
+    CallbackLogger logger(logger_worker_count);
+    uint32_t invocation_count = 0;
+    logger.set_error_handler([](const CallbackError&) {});
+    logger.set_callback_failure_threshold(failure_threshold);
+    logger.register_function_callback(
+        [&](const LogEntry&) { if (++invocation_count % 2 == 0) throw std::runtime_error("callback failure"); }, Severity::Debug);
+
+    // Act
+    for (uint32_t i = 0; i < log_count; ++i)
+        logger.log(Severity::Info, make_entry(TestComponent::A), "msg", "f.cpp", i + 1);
+
+    // Assert
+    ASSERT_EQ(invocation_count, log_count);
+}
+
+TEST(CppCallbackLogger, WorkStealingScheduler_WithManyProducers_ReceivesAll)
+{
+    constexpr size_t logger_worker_count = 4;
+    constexpr uint32_t producer_count = 4;
+    constexpr uint32_t log_per_producer = 2000;
+    // Arrange
+    CallbackLogger logger(LoggerOptions{logger_worker_count, SchedulerMode::WorkStealing});
+    std::atomic<uint32_t> received_count{0};
+    logger.register_function_callback([&](const LogEntry&) { received_count.fetch_add(1, std::memory_order_relaxed); }, Severity::Debug);
+
+    // Act
+    std::vector<std::thread> producers;
+    for (uint32_t producer = 0; producer < producer_count; ++producer)
+    {
+        producers.emplace_back([&]
+        {
+            for (uint32_t i = 0; i < log_per_producer; ++i)
+                logger.log(Severity::Info, make_entry(TestComponent::A), "msg", "f.cpp", i + 1);
+        });
+    }
+    for (std::thread& producer : producers)
+        producer.join();
+    logger.shutdown();
+
+    // Assert
+    ASSERT_EQ(received_count.load(), producer_count * log_per_producer);
+    ASSERT_EQ(logger.stats().queue_depth, 0);
+}
+
+TEST(CppCallbackLogger, WorkStealingScheduler_WhileProducing_QueueDepthStaysBelowLoggedCount)
+{
+    constexpr size_t logger_worker_count = 4;
+    constexpr uint32_t producer_count = 4;
+    constexpr uint32_t log_per_producer = 5000;
+    // Arrange
+    CallbackLogger logger(LoggerOptions{logger_worker_count, SchedulerMode::WorkStealing});
+    logger.register_function_callback([](const LogEntry&) {}, Severity::Debug);
+    std::atomic<bool> is_producing{true};
+    size_t max_queue_depth = 0;
+    std::thread sampler([&] {
+        while (is_producing.load())
+            max_queue_depth = std::max(max_queue_depth, logger.stats().queue_depth);
+    });
+
+    // Act
+    std::vector<std::thread> producers;
+    for (uint32_t producer = 0; producer < producer_count; ++producer)
+    {
+        producers.emplace_back([&]
+        {
+            for (uint32_t i = 0; i < log_per_producer; ++i)
+                logger.log(Severity::Info, make_entry(TestComponent::A), "msg", "f.cpp", i + 1);
+        });
+    }
+    for (std::thread& producer : producers)
+        producer.join();
+    is_producing = false;
+    sampler.join();
+
+    // Assert
+    ASSERT_LE(max_queue_depth, producer_count * log_per_producer);
+}
+
+TEST(CppCallbackLogger, WorkStealingScheduler_WithSingleProducer_IdleWorkersSteal)
+{
+    constexpr size_t logger_worker_count = 4;
+    constexpr uint32_t log_count = 40;
+    // Arrange
+    CallbackLogger logger(LoggerOptions{logger_worker_count, SchedulerMode::WorkStealing});
+    std::mutex thread_ids_mutex;
+    std::set<std::thread::id> worker_thread_ids;
+    logger.register_function_callback([&](const LogEntry&)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        std::lock_guard<std::mutex> lock(thread_ids_mutex);
+        worker_thread_ids.insert(std::this_thread::get_id());
+    }, Severity::Debug);
+
+    // Act
+    for (uint32_t i = 0; i < log_count; ++i)
+        logger.log(Severity::Info, make_entry(TestComponent::A), "msg", "f.cpp", i + 1);
+    logger.shutdown();
+
+    // Assert
+    ASSERT_GT(worker_thread_ids.size(), 1);
+}
+
+TEST(CppCallbackLogger, PerSinkOrdering_WithManyWorkers_DeliversInOrderWithoutConcurrency)
+{
+    constexpr size_t logger_worker_count = 4;
+    constexpr uint32_t log_count = 2000;
+    // Arrange
+    CallbackLogger logger(LoggerOptions{logger_worker_count, SchedulerMode::SharedQueue, SinkOrdering::PerSink});
+    std::vector<uint32_t> received_lines;
+    std::atomic<uint32_t> in_flight_count{0};
+    std::atomic<bool> is_concurrent{false};
+    logger.register_function_callback([&](const LogEntry& entry)
+    {
+        if (in_flight_count.fetch_add(1) != 0)
+            is_concurrent = true;
+        received_lines.push_back(entry.line);
+        in_flight_count.fetch_sub(1);
+    }, Severity::Debug);
+
+    // Act
+    for (uint32_t i = 0; i < log_count; ++i)
+        logger.log(Severity::Info, make_entry(TestComponent::A), "msg", "f.cpp", i + 1);
+    logger.shutdown();
+
+    // Assert
+    ASSERT_FALSE(is_concurrent.load());
+    ASSERT_EQ(received_lines.size(), log_count);
+    for (uint32_t i = 0; i < log_count; ++i)
+        ASSERT_EQ(received_lines[i], i + 1);
+}
+
+TEST(CppCallbackLogger, PerSinkOrdering_WithWorkStealingAndFileCallback_WritesLinesInOrder)
+{
+    constexpr size_t logger_worker_count = 4;
+    constexpr uint32_t log_count = 200;
+    // Arrange
+    const std::string file_name = temp_log_file();
+    {
+        CallbackLogger logger(LoggerOptions{logger_worker_count, SchedulerMode::WorkStealing, SinkOrdering::PerSink});
+        logger.register_file_callback(file_name, Severity::Debug);
+
+        // Act
+        for (uint32_t i = 0; i < log_count; ++i)
+            logger.log(Severity::Info, make_entry(TestComponent::A), "entry<" + std::to_string(i) + ">", "f.cpp", i + 1);
+        logger.shutdown();
+    }
+
+    // Assert
+    std::ifstream file_stream(file_name);
+    std::string line;
+    uint32_t expected_index = 0;
+    while (std::getline(file_stream, line))
+    {
+        ASSERT_NE(line.find("entry<" + std::to_string(expected_index) + ">"), std::string::npos);
+        ++expected_index;
+    }
+    file_stream.close();
+    std::remove(file_name.c_str());
+    ASSERT_EQ(expected_index, log_count);
+}
+
+TEST(CppCallbackLogger, AdaptivePool_WithSlowCallback_GrowsAndShrinksBackToMinimum)
+{
+    constexpr size_t min_worker_count = 1;
+    constexpr size_t max_worker_count = 4;
+    constexpr uint32_t log_count = 40;
+    // Arrange
+    std::mutex resize_mutex;
+    std::vector<std::pair<size_t, size_t>> resizes;
+    LoggerOptions options;
+    options.thread_count = min_worker_count;
+    options.max_thread_count = max_worker_count;
+    options.scale_up_queue_depth = 2;
+    options.idle_thread_timeout = std::chrono::milliseconds(50);
+    options.pool_resize_handler = [&](size_t previous_thread_count, size_t thread_count)
+    {
+        std::lock_guard<std::mutex> lock(resize_mutex);
+        resizes.emplace_back(previous_thread_count, thread_count);
+    };
+    CallbackLogger logger(options);
+    std::atomic<uint32_t> received_count{0};
+    logger.register_function_callback([&](const LogEntry&)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        received_count.fetch_add(1, std::memory_order_relaxed);
+    }, Severity::Debug);
+
+    // Act
+    for (uint32_t i = 0; i < log_count; ++i)
+        logger.log(Severity::Info, make_entry(TestComponent::A), "msg", "f.cpp", i + 1);
+    const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while ((received_count.load() < log_count || logger.stats().worker_count != min_worker_count)
+           && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    // Assert
+    ASSERT_EQ(received_count.load(), log_count);
+    ASSERT_EQ(logger.stats().worker_count, min_worker_count);
+    std::lock_guard<std::mutex> lock(resize_mutex);
+    ASSERT_FALSE(resizes.empty());
+    size_t peak_worker_count = 0;
+    for (const std::pair<size_t, size_t>& resize : resizes)
+        peak_worker_count = std::max(peak_worker_count, resize.second);
+    ASSERT_GT(peak_worker_count, min_worker_count);
+    ASSERT_LE(peak_worker_count, max_worker_count);
+    ASSERT_EQ(resizes.back().second, min_worker_count);
+}
+
+TEST(CppCallbackLogger, AdaptivePool_ResizeHandlerLogsThroughLogger_GrowsAgainAfterShrinking)
+{
+    constexpr size_t min_worker_count = 1;
+    constexpr size_t max_worker_count = 4;
+    constexpr uint32_t burst_count = 3;
+    constexpr uint32_t log_per_burst = 40;
+    // Arrange
+    std::atomic<CallbackLogger*> handler_logger{nullptr};
+    std::atomic<uint32_t> resize_count{0};
+    LoggerOptions options;
+    options.thread_count = min_worker_count;
+    options.max_thread_count = max_worker_count;
+    options.scale_up_queue_depth = 2;
+    options.idle_thread_timeout = std::chrono::milliseconds(20);
+    options.pool_resize_handler = [&](size_t, size_t)
+    {
+        resize_count.fetch_add(1);
+        CallbackLogger* logger = handler_logger.load();
+        if (logger != nullptr)
+            logger->log(Severity::Debug, make_entry(TestComponent::B), "resized", "f.cpp", 1);
+    };
+    CallbackLogger logger(options);
+    handler_logger = &logger;
+    std::atomic<uint32_t> received_count{0};
+    logger.register_function_callback([&](const LogEntry&)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        received_count.fetch_add(1, std::memory_order_relaxed);
+    }, make_entry(TestComponent::A));
+
+    // Act
+    for (uint32_t burst = 0; burst < burst_count; ++burst)
+    {
+        for (uint32_t i = 0; i < log_per_burst; ++i)
+            logger.log(Severity::Info, make_entry(TestComponent::A), "msg", "f.cpp", i + 1);
+        const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while ((received_count.load() < (burst + 1) * log_per_burst || logger.stats().worker_count != min_worker_count)
+               && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    handler_logger = nullptr;
+
+    // Assert
+    ASSERT_EQ(received_count.load(), burst_count * log_per_burst);
+    ASSERT_EQ(logger.stats().worker_count, min_worker_count);
+    ASSERT_GE(resize_count.load(), 2 * burst_count);
+}
+
+TEST(CppCallbackLogger, AdaptivePool_WithWorkStealingScheduler_Throws)
+{
+    // Arrange
+    LoggerOptions options;
+    options.thread_count = 1;
+    options.max_thread_count = 4;
+    options.scheduler_mode = SchedulerMode::WorkStealing;
+
+    // Act & Assert
+    EXPECT_THROW(CallbackLogger logger(options), std::invalid_argument);
+}
+
+TEST(CppCallbackLogger, WorkerCpuSet_WithSingleCpu_RunsCallbacksOnThatCpu)
+{
+    constexpr size_t pinned_cpu = 0;
+    constexpr uint32_t log_count = 20;
+    // Arrange
+    LoggerOptions options;
+    options.thread_count = 2;
+    options.scheduler_mode = SchedulerMode::WorkStealing;
+    options.worker_cpu_set = {pinned_cpu};
+    CallbackLogger logger(options);
+    std::mutex names_mutex;
+    std::set<std::string> worker_names;
+    std::atomic<bool> is_off_cpu{false};
+    logger.register_function_callback([&](const LogEntry&)
+    {
+#if defined(__linux__)
+        if (sched_getcpu() != static_cast<int>(pinned_cpu))
+            is_off_cpu = true;
+        char thread_name[16] = {};
+        pthread_getname_np(pthread_self(), thread_name, sizeof(thread_name));
+        std::lock_guard<std::mutex> lock(names_mutex);
+        worker_names.insert(thread_name);
+#endif
+    }, Severity::Debug);
+
+    // Act
+    for (uint32_t i = 0; i < log_count; ++i)
+        logger.log(Severity::Info, make_entry(TestComponent::A), "msg", "f.cpp", i + 1);
+    logger.shutdown();
+
+    // Assert
+    ASSERT_FALSE(is_off_cpu.load());
+    ASSERT_EQ(logger.stats().unpinned_workers, 0u);
+#if defined(__linux__)
+    for (const std::string& worker_name : worker_names)
+        ASSERT_EQ(worker_name.rfind("cblog-worker-", 0), 0);
+#endif
+}
+
+TEST(CppCallbackLogger, WorkerCpuSet_WithInvalidCpu_Throws)
+{
+    // Arrange
+    LoggerOptions options;
+    options.worker_cpu_set = {std::numeric_limits<size_t>::max()};
+
+    // Act & Assert
+    EXPECT_THROW(CallbackLogger logger(options), std::invalid_argument);
+}
+
+#if defined(__linux__)
+TEST(CppCallbackLogger, WorkerCpuSet_WithCpuOutsideAllowedSet_Throws)
+{
+    if (std::thread::hardware_concurrency() < 2)
+        GTEST_SKIP() << "Needs a second CPU to forbid";
+    // Arrange
+    cpu_set_t original_cpu_set;
+    ASSERT_EQ(sched_getaffinity(0, sizeof(original_cpu_set), &original_cpu_set), 0);
+    cpu_set_t restricted_cpu_set;
+    CPU_ZERO(&restricted_cpu_set);
+    CPU_SET(0, &restricted_cpu_set);
+    ASSERT_EQ(pthread_setaffinity_np(pthread_self(), sizeof(restricted_cpu_set), &restricted_cpu_set), 0);
+    LoggerOptions options;
+    options.thread_count = 1;
+    options.worker_cpu_set = {1};
+
+    // Act
+    bool is_thrown = false;
+    try
+    {
+        CallbackLogger logger(options);
+    }
+    catch (const std::invalid_argument&)
+    {
+        is_thrown = true;
+    }
+    (void)pthread_setaffinity_np(pthread_self(), sizeof(original_cpu_set), &original_cpu_set);
+
+    // Assert
+    ASSERT_TRUE(is_thrown);
+}
+#endif
+
+TEST(CppCallbackLogger, LogEntryPool_WithEntriesOutlivingProducerThread_ReturnsBlocksToOriginPool)
+{
+    constexpr uint32_t entry_count = 200;
+    // Arrange
+    std::vector<LogEntryPtr> entries;
+    std::thread producer([&]
+    {
+        for (uint32_t i = 0; i < entry_count; ++i)
+        {
+            entries.push_back(std::allocate_shared<LogEntry>(LogEntryPoolAllocator<LogEntry>(),
+                LogEntry{Severity::Info, make_entry(TestComponent::A), "msg" + std::to_string(i), "f.cpp", i + 1, "timestamp"}));
+        }
+    });
+    producer.join();
+
+    // Act
+    std::thread consumer([&]
+    {
+        for (uint32_t i = 0; i < entry_count; ++i)
+            ASSERT_EQ(entries[i]->message, "msg" + std::to_string(i));
+        entries.clear();
+    });
+    consumer.join();
+
+    // Assert
+    ASSERT_TRUE(entries.empty());
+}
+
+TEST(CppCallbackLogger, LogEntryPool_WithManyProducersAndCallbacks_DeliversIntactEntries)
+{
+    constexpr size_t logger_worker_count = 4;
+    constexpr uint32_t producer_count = 4;
+    constexpr uint32_t log_per_producer = 1000;
+    // Arrange
+    CallbackLogger logger(logger_worker_count);
+    std::atomic<uint32_t> intact_count{0};
+    const std::function<void(const LogEntry&)> function_callback = [&](const LogEntry& entry)
+    {
+        if (entry.message == "msg" + std::to_string(entry.line))
+            intact_count.fetch_add(1, std::memory_order_relaxed);
+    };
+    logger.register_function_callback(function_callback, Severity::Debug);
+    logger.register_function_callback(function_callback, Severity::Debug);
+
+    // Act
+    std::vector<std::thread> producers;
+    for (uint32_t producer = 0; producer < producer_count; ++producer)
+    {
+        producers.emplace_back([&]
+        {
+            for (uint32_t i = 1; i <= log_per_producer; ++i)
+                logger.log(Severity::Info, make_entry(TestComponent::A), "msg" + std::to_string(i), "f.cpp", i);
+        });
+    }
+    for (std::thread& producer : producers)
+        producer.join();
+    logger.shutdown();
+
+    // Assert
+    ASSERT_EQ(intact_count.load(), 2 * producer_count * log_per_producer);
+}
+
+TEST(CppCallbackLogger, SeverityMacros_WithDefaultMinimalSeverity_LogAllSeverities)
+{
+    constexpr uint32_t logger_worker_count = 0;
+    // Arrange
+    CallbackLogger logger(logger_worker_count);
+    std::vector<Severity> received_severities;
+    logger.register_function_callback([&](const LogEntry& entry) { received_severities.push_back(entry.severity); }, Severity::Debug);
+
+    // Act
+    LOG_DEBUG(logger, TestComponent::A, "debug");
+    LOG_INFO(logger, TestComponent::A, "info");
+    LOG_WARNING(logger, TestComponent::A, "warning");
+    LOG_ERROR(logger, TestComponent::A, "error");
+    LOG_FATAL(logger, TestComponent::A, "fatal");
+
+    // Assert
+    ASSERT_EQ(received_severities, (std::vector<Severity>{Severity::Debug, Severity::Info, Severity::Warning, Severity::Error, Severity::Fatal}));
+}
+
+TEST(CppCallbackLogger, StaticComponent_DeclaredEnum_HasConstexprId)
+{
+    // Arrange
+    constexpr uint64_t expected_id = (static_cast<uint64_t>(7) << 32) | 1;
+
+    // Act
+    constexpr uint64_t component_id = static_component_id(StaticTestComponent::Storage);
+    ComponentEnumEntry entry = make_component_entry(StaticTestComponent::Storage);
+
+    // Assert
+    static_assert(component_id == expected_id, "Static component ID must be a compile-time constant");
+    ASSERT_EQ(entry.get_static_id(), expected_id);
+    ASSERT_EQ(make_entry(TestComponent::A).get_static_id(), 0);
+    ASSERT_EQ(entry, make_component_entry(StaticTestComponent::Storage));
+    ASSERT_FALSE(entry == make_component_entry(StaticTestComponent::Network));
+}
+
+TEST(CppCallbackLogger, StaticComponent_StringTypedEntryWithSameId_EqualAndOrderedTogether)
+{
+    // Arrange
+    const ComponentEnumEntry typed_entry = make_component_entry(StaticTestComponent::Storage);
+    const ComponentEnumEntry string_entry{std::variant<std::type_index, std::string>{std::string("StaticTestComponent")},
+                                          typed_entry.get_enum_value(), typed_entry.get_static_id()};
+
+    // Act
+    const std::set<ComponentEnumEntry> entries{typed_entry, string_entry, make_entry(TestComponent::A)};
+
+    // Assert
+    ASSERT_EQ(typed_entry, string_entry);
+    ASSERT_FALSE(typed_entry < string_entry);
+    ASSERT_FALSE(string_entry < typed_entry);
+    ASSERT_TRUE(typed_entry <= string_entry && typed_entry >= string_entry);
+    ASSERT_EQ(entries.size(), 2u);
+}
+
+TEST(CppCallbackLogger, StaticComponent_LogWithTemplateComponent_MatchesComponentFilter)
+{
+    constexpr uint32_t logger_worker_count = 0;
+    // Arrange
+    CallbackLogger logger(logger_worker_count);
+    std::vector<std::string> received_messages;
+    logger.register_function_callback([&](const LogEntry& entry) { received_messages.push_back(entry.message); },
+        std::set<StaticTestComponent>{StaticTestComponent::Network});
+
+    // Act
+    logger.log<StaticTestComponent::Network>(Severity::Info, "network", __FILE__, __LINE__);
+    logger.log<StaticTestComponent::Storage>(Severity::Info, "storage", __FILE__, __LINE__);
+    logger.log<TestComponent::A>(Severity::Info, "dynamic", __FILE__, __LINE__);
+
+    // Assert
+    ASSERT_EQ(received_messages, std::vector<std::string>{"network"});
+}
+
+TEST(CppCallbackLogger, ComponentSubtreeFilter_WithNestedRoots_MatchesNearestRootSeverity)
+{
+    constexpr uint32_t logger_worker_count = 0;
+    // Arrange
+    CallbackLogger logger(logger_worker_count);
+    std::vector<std::string> received_messages;
+    logger.set_component_parent(TestComponent::B, TestComponent::A);
+    logger.set_component_parent(TestComponent::C, TestComponent::B);
+    logger.set_component_parent(TestComponent::D, TestComponent::C);
+    logger.register_function_callback([&](const LogEntry& entry) { received_messages.push_back(entry.message); },
+        ComponentSubtreeFilter({{make_entry(TestComponent::A), Severity::Debug}, {make_entry(TestComponent::C), Severity::Error}}));
+
+    // Act
+    logger.log(Severity::Debug, TestComponent::B, "b debug", "f.cpp", 1);
+    logger.log(Severity::Info, TestComponent::D, "d info", "f.cpp", 2);
+    logger.log(Severity::Error, TestComponent::D, "d error", "f.cpp", 3);
+    logger.log(Severity::Fatal, TestComponent::E, "e fatal", "f.cpp", 4);
+
+    // Assert
+    ASSERT_EQ(received_messages, (std::vector<std::string>{"b debug", "d error"}));
+}
+
+TEST(CppCallbackLogger, ComponentSubtreeFilter_ParentSetAfterRegistration_MatchesNewChild)
+{
+    constexpr uint32_t logger_worker_count = 2;
+    // Arrange
+    CallbackLogger logger(logger_worker_count);
+    std::atomic<int> received_count{0};
+    logger.register_function_callback([&](const LogEntry&) { ++received_count; }, ComponentSubtreeFilter(TestComponent::A, Severity::Info));
+
+    // Act
+    logger.log(Severity::Info, TestComponent::B, "before", "f.cpp", 1);
+    logger.set_component_parent(TestComponent::B, TestComponent::A);
+    logger.log(Severity::Info, TestComponent::B, "after", "f.cpp", 2);
+    logger.shutdown();
+
+    // Assert
+    ASSERT_EQ(received_count.load(), 1);
+}
+
+TEST(CppCallbackLogger, SetComponentParent_CreatingCycle_Throws)
+{
+    constexpr uint32_t logger_worker_count = 0;
+    // Arrange
+    CallbackLogger logger(logger_worker_count);
+    logger.set_component_parent(TestComponent::B, TestComponent::A);
+
+    // Act & Assert
+    ASSERT_THROW(logger.set_component_parent(TestComponent::A, TestComponent::B), std::invalid_argument);
+    ASSERT_THROW(logger.set_component_parent(TestComponent::A, TestComponent::A), std::invalid_argument);
+}
+
+TEST(CppCallbackLogger, ComponentSubtreeFilter_FileCallbackWithMessageFilterAndFormatter_WritesMatchingLines)
+{
+    // Arrange
+    const std::string file_name = temp_log_file();
+    std::remove(file_name.c_str());
+    {
+        CallbackLogger logger(2);
+        logger.set_component_parent(TestComponent::B, TestComponent::A);
+        logger.register_file_callback(file_name, ComponentSubtreeFilter(TestComponent::A, Severity::Info),
+                                      MessageFilter::contains("disk"), std::make_shared<const PatternFormatter>("%S %M"));
+
+        // Act
+        logger.log(Severity::Error, TestComponent::B, "disk full", "f.cpp", 1);
+        logger.log(Severity::Error, TestComponent::B, "cpu hot", "f.cpp", 2);
+        logger.log(Severity::Error, TestComponent::C, "disk slow", "f.cpp", 3);
+        logger.shutdown();
+    }
+
+    // Assert
+    std::ifstream file_stream(file_name);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(file_stream, line);)
+        lines.push_back(line);
+    file_stream.close();
+    std::remove(file_name.c_str());
+    ASSERT_EQ(lines, std::vector<std::string>{"Error disk full"});
+}
+
+TEST(CppCallbackLogger, ComponentSubtreeFilter_FileCallbackWithEmptyFilename_Throws)
+{
+    constexpr uint32_t logger_worker_count = 0;
+    // Arrange
+    CallbackLogger logger(logger_worker_count);
+
+    // Act & Assert
+    ASSERT_THROW(logger.register_file_callback("", ComponentSubtreeFilter(TestComponent::A)), std::invalid_argument);
+}
+
+TEST(CppCallbackLogger, MessageFilter_SubstringAndRegex_ReceivesOnlyMatchingMessages)
+{
+    constexpr uint32_t logger_worker_count = 0;
+    // Arrange
+    CallbackLogger logger(logger_worker_count);
+    std::vector<std::string> substring_messages;
+    std::vector<std::string> regex_messages;
+    logger.register_function_callback([&](const LogEntry& entry) { substring_messages.push_back(entry.message); },
+        Severity::Debug, MessageFilter::contains("timeout"));
+    logger.register_function_callback([&](const LogEntry& entry) { regex_messages.push_back(entry.message); },
+        Severity::Debug, MessageFilter::matches_regex("code=[0-9]+$"));
+
+    // Act
+    logger.log(Severity::Info, TestComponent::A, "connection timeout code=504", "f.cpp", 1);
+    logger.log(Severity::Info, TestComponent::A, "connection time out", "f.cpp", 2);
+    logger.log(Severity::Info, TestComponent::A, "request done code=200", "f.cpp", 3);
+
+    // Assert
+    ASSERT_EQ(substring_messages, std::vector<std::string>{"connection timeout code=504"});
+    ASSERT_EQ(regex_messages, (std::vector<std::string>{"connection timeout code=504", "request done code=200"}));
+}
+
+TEST(CppCallbackLogger, MessageFilter_AnyOfOverlappingPatterns_MatchesOnWorkers)
+{
+    constexpr uint32_t logger_worker_count = 2;
+    // Arrange
+    CallbackLogger logger(logger_worker_count);
+    std::mutex received_mutex;
+    std::set<std::string> received_messages;
+    logger.register_function_callback([&](const LogEntry& entry)
+        {
+            std::lock_guard<std::mutex> lock(received_mutex);
+            received_messages.insert(entry.message);
+        }, std::unordered_map<ComponentEnumEntry, Severity, ComponentEnumEntryHasher>{{make_entry(TestComponent::A), Severity::Info}},
+        MessageFilter::contains_any({"he", "she", "hers", "disk full"}));
+
+    // Act
+    logger.log(Severity::Info, TestComponent::A, "ushers", "f.cpp", 1);
+    logger.log(Severity::Info, TestComponent::A, "sh", "f.cpp", 2);
+    logger.log(Severity::Info, TestComponent::A, "/var: disk full", "f.cpp", 3);
+    logger.log(Severity::Info, TestComponent::A, "disk ful", "f.cpp", 4);
+    logger.log(Severity::Info, TestComponent::B, "she", "f.cpp", 5);
+    logger.shutdown();
+
+    // Assert
+    ASSERT_EQ(received_messages, (std::set<std::string>{"ushers", "/var: disk full"}));
+}
+
+TEST(CppCallbackLogger, MessageFilter_RejectedOnWorkers_CountedAsFilteredOut)
+{
+    constexpr uint32_t logger_worker_count = 2;
+    // Arrange
+    const std::string file_name = temp_log_file();
+    std::remove(file_name.c_str());
+    CallbackLogger logger(logger_worker_count);
+    logger.register_function_callback([](const LogEntry&) {}, Severity::Info, MessageFilter::contains("disk"));
+    logger.register_file_callback(file_name, Severity::Info, MessageFilter::contains("full"));
+    logger.register_function_callback([](const LogEntry&) {}, make_entry(TestComponent::B));
+
+    // Act
+    logger.log(Severity::Info, TestComponent::A, "disk full", "f.cpp", 1);
+    logger.log(Severity::Info, TestComponent::A, "disk slow", "f.cpp", 2);
+    logger.log(Severity::Info, TestComponent::A, "cpu hot", "f.cpp", 3);
+    logger.log(Severity::Info, TestComponent::B, "cpu cold", "f.cpp", 4);
+    logger.shutdown();
+    const LoggerStatistics statistics = logger.stats();
+    std::remove(file_name.c_str());
+
+    // Assert
+    ASSERT_EQ(statistics.tasks_enqueued, 9);
+    ASSERT_EQ(statistics.message_filter_rejections, 5);
+    ASSERT_EQ(statistics.filtered_out, 1);
+}
+
+TEST(CppCallbackLogger, MessageFilter_InvalidPatterns_Throws)
+{
+    constexpr uint32_t logger_worker_count = 0;
+    // Arrange
+    CallbackLogger logger(logger_worker_count);
+    auto callback = [](const LogEntry&) {};
+
+    // Act & Assert
+    ASSERT_THROW(logger.register_function_callback(callback, Severity::Debug, MessageFilter::matches_regex("(unclosed")), std::invalid_argument);
+    ASSERT_THROW(logger.register_function_callback(callback, Severity::Debug, MessageFilter::contains_any({})), std::invalid_argument);
+    ASSERT_THROW(logger.register_function_callback(callback, Severity::Debug, MessageFilter::contains("")), std::invalid_argument);
+}
+
+TEST(CppCallbackLogger, CallSiteRateLimit_HotCallSite_DropsExcessAndReportsRepeats)
+{
+    constexpr uint32_t logger_worker_count = 0;
+    constexpr uint32_t burst = 2;
+    constexpr uint32_t log_count = 10;
+    // Arrange
+    CallbackLogger logger(logger_worker_count);
+    std::vector<std::string> received_messages;
+    logger.register_function_callback([&](const LogEntry& entry) { received_messages.push_back(entry.message); }, Severity::Debug);
+    logger.set_call_site_rate_limit(10.0, burst);
+
+    // Act
+    for (uint32_t i = 0; i < log_count; ++i)
+        logger.log(Severity::Error, TestComponent::A, "hot", "f.cpp", 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    logger.log(Severity::Error, TestComponent::A, "hot", "f.cpp", 1);
+
+    // Assert
+    ASSERT_EQ(received_messages, (std::vector<std::string>{"hot", "hot", "Last message repeated 8 times", "hot"}));
+    ASSERT_EQ(logger.stats().rate_limited, log_count - burst);
+}
+
+TEST(CppCallbackLogger, CallSiteRateLimit_CallSiteGoesQuiet_FlushReportsRepeats)
+{
+    constexpr uint32_t logger_worker_count = 2;
+    constexpr uint32_t burst = 2;
+    constexpr uint32_t log_count = 10;
+    // Arrange
+    CallbackLogger logger(logger_worker_count);
+    std::mutex received_mutex;
+    std::vector<LogEntry> received_entries;
+    logger.register_function_callback([&](const LogEntry& entry) {
+        std::lock_guard<std::mutex> lock(received_mutex);
+        received_entries.push_back(entry);
+    }, Severity::Debug);
+    logger.set_call_site_rate_limit(1.0, burst);
+
+    // Act
+    for (uint32_t i = 0; i < log_count; ++i)
+        logger.log(Severity::Warning, TestComponent::B, "hot", "quiet.cpp", 7);
+    const bool is_flushed = logger.flush(std::chrono::seconds(5));
+
+    // Assert
+    ASSERT_TRUE(is_flushed);
+    std::lock_guard<std::mutex> lock(received_mutex);
+    ASSERT_EQ(received_entries.size(), burst + 1);
+    const LogEntry& repeat_entry = received_entries.back();
+    ASSERT_EQ(repeat_entry.message, "Last message repeated 8 times");
+    ASSERT_EQ(repeat_entry.severity, Severity::Warning);
+    ASSERT_EQ(repeat_entry.file, "quiet.cpp");
+    ASSERT_EQ(repeat_entry.line, 7u);
+}
+
+TEST(CppCallbackLogger, CallSiteRateLimit_DifferentCallSites_LimitedIndependently)
+{
+    constexpr uint32_t logger_worker_count = 0;
+    // Arrange
+    CallbackLogger logger(logger_worker_count);
+    std::vector<std::string> received_messages;
+    logger.register_function_callback([&](const LogEntry& entry) { received_messages.push_back(entry.message); }, Severity::Debug);
+    logger.set_call_site_rate_limit(0.001, 1);
+
+    // Act
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        logger.log(Severity::Info, TestComponent::A, "line 1", "f.cpp", 1);
+        logger.log(Severity::Info, TestComponent::A, "line 2", "f.cpp", 2);
+        logger.log(Severity::Info, TestComponent::B, "line 1 other component", "f.cpp", 1);
+    }
+
+    // Assert
+    ASSERT_EQ(received_messages, (std::vector<std::string>{"line 1", "line 2", "line 1 other component"}));
+}
+
+TEST(CppCallbackLogger, CallSiteRateLimit_Disabled_DeliversEveryEntry)
+{
+    constexpr uint32_t logger_worker_count = 0;
+    constexpr uint32_t log_count = 100;
+    // Arrange
+    CallbackLogger logger(logger_worker_count);
+    uint32_t received_count = 0;
+    logger.register_function_callback([&](const LogEntry&) { ++received_count; }, Severity::Debug);
+    logger.set_call_site_rate_limit(1.0, 1);
+    logger.set_call_site_rate_limit(0.0, 1);
+
+    // Act
+    for (uint32_t i = 0; i < log_count; ++i)
+        logger.log(Severity::Info, TestComponent::A, "msg", "f.cpp", 1);
+
+    // Assert
+    ASSERT_EQ(received_count, log_count);
+    ASSERT_THROW(logger.set_call_site_rate_limit(-1.0, 1), std::invalid_argument);
+}
+
+TEST(CppCallbackLogger, SamplingRate_PerSeverityAndComponent_KeepsExpectedFraction)
+{
+    constexpr uint32_t logger_worker_count = 0;
+    constexpr uint32_t log_count = 10000;
+    // Arrange
+    CallbackLogger logger(logger_worker_count);
+    std::array<uint32_t, static_cast<size_t>(Severity::SEVERITY_COUNT)> received_per_severity{};
+    uint32_t received_component_b = 0;
+    logger.register_function_callback([&](const LogEntry& entry)
+        {
+            if (entry.component == make_entry(TestComponent::B))
+                ++received_component_b;
+            else
+                ++received_per_severity[static_cast<size_t>(entry.severity)];
+        }, Severity::Debug);
+    logger.set_sampling_rate(Severity::Debug, 0.1);
+    logger.set_sampling_rate(TestComponent::B, Severity::Debug, 0.0);
+
+    // Act
+    for (uint32_t i = 0; i < log_count; ++i)
+    {
+        logger.log(Severity::Debug, TestComponent::A, "debug", "f.cpp", 1);
+        logger.log(Severity::Error, TestComponent::A, "error", "f.cpp", 2);
+        logger.log(Severity::Debug, TestComponent::B, "debug b", "f.cpp", 3);
+    }
+    LoggerStatistics statistics = logger.stats();
+
+    // Assert
+    ASSERT_GT(received_per_severity[static_cast<size_t>(Severity::Debug)], log_count / 20);
+    ASSERT_LT(received_per_severity[static_cast<size_t>(Severity::Debug)], log_count / 5);
+    ASSERT_EQ(received_per_severity[static_cast<size_t>(Severity::Error)], log_count);
+    ASSERT_EQ(received_component_b, 0);
+    ASSERT_EQ(statistics.sampled_out_per_severity[static_cast<size_t>(Severity::Debug)],
+              2 * log_count - received_per_severity[static_cast<size_t>(Severity::Debug)]);
+    ASSERT_EQ(statistics.sampled_out_per_severity[static_cast<size_t>(Severity::Error)], 0);
+}
+
+TEST(CppCallbackLogger, SamplingRate_ComponentOverride_OtherSeveritiesFollowLaterSeverityRates)
+{
+    constexpr uint32_t logger_worker_count = 0;
+    constexpr uint32_t log_count = 100;
+    // Arrange
+    CallbackLogger logger(logger_worker_count);
+    uint32_t received_debug = 0;
+    uint32_t received_info = 0;
+    logger.register_function_callback([&](const LogEntry& entry)
+        {
+            if (entry.severity == Severity::Debug)
+                ++received_debug;
+            else
+                ++received_info;
+        }, Severity::Debug);
+    logger.set_sampling_rate(TestComponent::A, Severity::Debug, 1.0);
+    logger.set_sampling_rate(Severity::Debug, 0.0);
+    logger.set_sampling_rate(Severity::Info, 0.0);
+
+    // Act
+    for (uint32_t i = 0; i < log_count; ++i)
+    {
+        logger.log(Severity::Debug, TestComponent::A, "debug", "f.cpp", 1);
+        logger.log(Severity::Info, TestComponent::A, "info", "f.cpp", 2);
+    }
+
+    // Assert
+    ASSERT_EQ(received_debug, log_count);
+    ASSERT_EQ(received_info, 0u);
+}
+
+TEST(CppCallbackLogger, SamplingRate_WithThreadTraceId_KeepsOrDropsWholeTrace)
+{
+    constexpr uint32_t logger_worker_count = 0;
+    constexpr uint32_t trace_count = 64;
+    constexpr uint32_t entries_per_trace = 8;
+    // Arrange
+    CallbackLogger logger(logger_worker_count);
+    std::unordered_map<uint32_t, uint32_t> received_per_trace;
+    uint32_t current_trace = 0;
+    logger.register_function_callback([&](const LogEntry&) { ++received_per_trace[current_trace]; }, Severity::Debug);
+    logger.set_sampling_rate(Severity::Info, 0.5);
+
+    // Act
+    for (current_trace = 1; current_trace <= trace_count; ++current_trace)
+    {
+        CallbackLogger::set_thread_trace_id(current_trace);
+        for (uint32_t i = 0; i < entries_per_trace; ++i)
+            logger.log(Severity::Info, TestComponent::A, "traced", "f.cpp", 1);
+    }
+    CallbackLogger::set_thread_trace_id(0);
+
+    // Assert
+    ASSERT_GT(received_per_trace.size(), 0);
+    ASSERT_LT(received_per_trace.size(), trace_count);
+    for (const auto& trace : received_per_trace)
+        ASSERT_EQ(trace.second, entries_per_trace);
+}
+
+TEST(CppCallbackLogger, SamplingRate_OutOfRange_Throws)
+{
+    constexpr uint32_t logger_worker_count = 0;
+    // Arrange
+    CallbackLogger logger(logger_worker_count);
+
+    // Act & Assert
+    ASSERT_THROW(logger.set_sampling_rate(Severity::Debug, 1.5), std::invalid_argument);
+    ASSERT_THROW(logger.set_sampling_rate(Severity::Debug, -0.1), std::invalid_argument);
+    ASSERT_THROW(logger.set_sampling_rate(Severity::SEVERITY_COUNT, 0.5), std::invalid_argument);
+}
+
+TEST(CppCallbackLogger, FlightRecorder_FatalEntry_DumpsEntriesFilteredOutOfCallbacks)
+{
+    constexpr uint32_t logger_worker_count = 0;
+    // Arrange
+    const std::string file_name = temp_log_file();
+    CallbackLogger logger(logger_worker_count);
+    logger.register_function_callback([](const LogEntry&) {}, Severity::Error);
+    FlightRecorderOptions options;
+    options.dump_path = file_name;
+    options.dump_on_shutdown = false;
+    logger.enable_flight_recorder(options);
+
+    // Act
+    logger.log(Severity::Debug, TestComponent::B, "debug detail", "f.cpp", 1);
+    logger.log(Severity::Fatal, TestComponent::A, "fatal failure", "f.cpp", 2);
+
+    // Assert
+    std::ifstream file_stream(file_name);
+    const std::string content((std::istreambuf_iterator<char>(file_stream)), std::istreambuf_iterator<char>());
+    file_stream.close();
+    std::remove(file_name.c_str());
+    ASSERT_NE(content.find("[Debug] TestComponent#1 (f.cpp:1): debug detail"), std::string::npos);
+    ASSERT_NE(content.find("[Fatal] TestComponent#0 (f.cpp:2): fatal failure"), std::string::npos);
+}
+
+TEST(CppCallbackLogger, FlightRecorder_PerThreadRings_KeepMostRecentEntriesOfEachThread)
+{
+    constexpr uint32_t logger_worker_count = 2;
+    constexpr size_t records_per_thread = 4;
+    constexpr uint32_t log_count = 10;
+    // Arrange
+    const std::string file_name = temp_log_file();
+    {
+        CallbackLogger logger(logger_worker_count);
+        FlightRecorderOptions options;
+        options.dump_path = file_name;
+        options.records_per_thread = records_per_thread;
+        logger.enable_flight_recorder(options);
+
+        // Act
+        std::vector<std::thread> threads;
+        for (uint32_t thread_index = 0; thread_index < 2; ++thread_index)
+        {
+            threads.emplace_back([&logger, thread_index]()
+            {
+                for (uint32_t i = 0; i < log_count; ++i)
+                    logger.log(Severity::Debug, TestComponent::A, "t" + std::to_string(thread_index) + "<" + std::to_string(i) + ">", "f.cpp", 1);
+            });
+        }
+        for (std::thread& thread : threads)
+            thread.join();
+        logger.shutdown();
+    }
+
+    // Assert
+    std::ifstream file_stream(file_name);
+    const std::string content((std::istreambuf_iterator<char>(file_stream)), std::istreambuf_iterator<char>());
+    file_stream.close();
+    std::remove(file_name.c_str());
+    for (uint32_t thread_index = 0; thread_index < 2; ++thread_index)
+    {
+        for (uint32_t i = 0; i < log_count; ++i)
+        {
+            const bool is_recent = i >= log_count - records_per_thread;
+            const std::string message = "t" + std::to_string(thread_index) + "<" + std::to_string(i) + ">";
+            ASSERT_EQ(content.find(message) != std::string::npos, is_recent) << message;
+        }
+    }
+}
+
+TEST(CppCallbackLogger, FlightRecorder_CrashHandler_DumpsOnAbort)
+{
+    // Arrange
+    const std::string file_name = temp_log_file();
+
+    // Act
+    ASSERT_DEATH(
+        {
+            CallbackLogger logger(0);
+            FlightRecorderOptions options;
+            options.dump_path = file_name;
+            options.install_crash_handler = true;
+            logger.enable_flight_recorder(options);
+            logger.log(Severity::Info, TestComponent::A, "last words", "f.cpp", 1);
+            std::abort();
+        }, "");
+
+    // Assert
+    std::ifstream file_stream(file_name);
+    const std::string content((std::istreambuf_iterator<char>(file_stream)), std::istreambuf_iterator<char>());
+    file_stream.close();
+    std::remove(file_name.c_str());
+    ASSERT_NE(content.find("last words"), std::string::npos);
+}
+
+TEST(CppCallbackLogger, SharedMemoryTransport_SinkToCollector_ReplaysEntriesThroughCollectorFilters)
+{
+    constexpr uint32_t logger_worker_count = 0;
+    constexpr size_t slot_count = 16;
+    // Arrange
+    const std::string ring_name = "cblog-test-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    CallbackLogger producer_logger(logger_worker_count);
+    CallbackLogger collector_logger(logger_worker_count);
+    std::vector<LogEntry> received_entries;
+    collector_logger.register_function_callback([&](const LogEntry& entry) { received_entries.push_back(entry); },
+        std::set<StaticTestComponent>{StaticTestComponent::Storage});
+    SharedMemoryCollector collector(collector_logger, ring_name, slot_count);
+    producer_logger.register_function_callback(SharedMemorySink(ring_name, slot_count), Severity::Debug);
+
+    // Act
+    producer_logger.log(Severity::Warning, StaticTestComponent::Storage, "disk slow", "f.cpp", 7);
+    producer_logger.log(Severity::Warning, StaticTestComponent::Network, "link down", "f.cpp", 8);
+    producer_logger.log(Severity::Warning, TestComponent::A, "dynamic", "f.cpp", 9);
+    const size_t replayed_count = collector.poll();
+    SharedMemoryRing::remove(ring_name);
+
+    // Assert
+    ASSERT_EQ(replayed_count, 3);
+    ASSERT_EQ(received_entries.size(), 1);
+    ASSERT_EQ(received_entries[0].message, "disk slow");
+    ASSERT_EQ(received_entries[0].severity, Severity::Warning);
+    ASSERT_EQ(received_entries[0].file, "f.cpp");
+    ASSERT_EQ(received_entries[0].line, 7);
+    ASSERT_EQ(received_entries[0].component, make_component_entry(StaticTestComponent::Storage));
+}
+
+TEST(CppCallbackLogger, SharedMemoryTransport_NonStaticComponent_NotMatchedByEnumFilterAndCounted)
+{
+    constexpr uint32_t logger_worker_count = 0;
+    constexpr size_t slot_count = 16;
+    // Arrange
+    const std::string ring_name = "cblog-test-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    CallbackLogger producer_logger(logger_worker_count);
+    CallbackLogger collector_logger(logger_worker_count);
+    uint32_t enum_filter_count = 0;
+    uint32_t severity_filter_count = 0;
+    collector_logger.register_function_callback([&](const LogEntry&) { ++enum_filter_count; },
+        std::set<TestComponent>{TestComponent::A});
+    collector_logger.register_function_callback([&](const LogEntry&) { ++severity_filter_count; }, Severity::Debug);
+    SharedMemoryCollector collector(collector_logger, ring_name, slot_count);
+    producer_logger.register_function_callback(SharedMemorySink(ring_name, slot_count), Severity::Debug);
+
+    // Act
+    producer_logger.log(Severity::Warning, TestComponent::A, "dynamic", "f.cpp", 1);
+    producer_logger.log(Severity::Warning, StaticTestComponent::Storage, "static", "f.cpp", 2);
+    (void)collector.poll();
+    SharedMemoryRing::remove(ring_name);
+
+    // Assert
+    ASSERT_EQ(enum_filter_count, 0u);
+    ASSERT_EQ(severity_filter_count, 2u);
+    ASSERT_EQ(collector.non_static_component_count(), 1u);
+}
+
+TEST(CppCallbackLogger, SharedMemoryTransport_FullRing_DropsAndCountsEntries)
+{
+    constexpr uint32_t logger_worker_count = 0;
+    constexpr size_t slot_count = 4;
+    constexpr uint32_t log_count = 6;
+    // Arrange
+    const std::string ring_name = "cblog-test-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    CallbackLogger producer_logger(logger_worker_count);
+    CallbackLogger collector_logger(logger_worker_count);
+    uint32_t received_count = 0;
+    collector_logger.register_function_callback([&](const LogEntry&) { ++received_count; }, Severity::Debug);
+    SharedMemoryCollector collector(collector_logger, ring_name, slot_count);
+    SharedMemorySink sink(ring_name, slot_count);
+    producer_logger.register_function_callback(sink, Severity::Debug);
+
+    // Act
+    for (uint32_t i = 0; i < log_count; ++i)
+        producer_logger.log(Severity::Info, TestComponent::A, "msg" + std::to_string(i), "f.cpp", 1);
+    collector.poll();
+    producer_logger.log(Severity::Info, TestComponent::A, "after drain", "f.cpp", 1);
+    collector.poll();
+    SharedMemoryRing::remove(ring_name);
+
+    // Assert
+    ASSERT_EQ(received_count, slot_count + 1);
+    ASSERT_EQ(sink.dropped_count(), log_count - slot_count);
+}
+
+TEST(CppCallbackLogger, SharedMemoryRing_OpenedWithAnotherSlotCount_ThrowsWithoutResizing)
+{
+    constexpr size_t slot_count = 4;
+    // Arrange
+    const std::string ring_name = "cblog-test-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    SharedMemoryRing ring(ring_name, slot_count);
+    const char record[] = "kept";
+
+    // Act
+    ASSERT_THROW(SharedMemoryRing(ring_name, slot_count * 2), std::runtime_error);
+    SharedMemoryRing same_layout_ring(ring_name, slot_count);
+    const bool is_pushed = same_layout_ring.try_push(record, sizeof(record));
+    std::vector<char> popped_record;
+    const bool is_popped = ring.try_pop(popped_record);
+    SharedMemoryRing::remove(ring_name);
+
+    // Assert
+    ASSERT_TRUE(is_pushed);
+    ASSERT_TRUE(is_popped);
+    ASSERT_EQ(std::string(popped_record.data()), "kept");
+}
+
+#if defined(__linux__)
+TEST(CppCallbackLogger, SharedMemoryTransport_ProducerProcesses_CollectedByOneProcess)
+{
+    constexpr uint32_t logger_worker_count = 0;
+    constexpr uint32_t process_count = 3;
+    // Arrange
+    const std::string ring_name = "cblog-test-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    CallbackLogger collector_logger(logger_worker_count);
+    std::set<std::string> received_messages;
+    collector_logger.register_function_callback([&](const LogEntry& entry) { received_messages.insert(entry.message); }, Severity::Debug);
+    SharedMemoryCollector collector(collector_logger, ring_name);
+
+    // Act
+    std::vector<pid_t> children;
+    for (uint32_t process_index = 0; process_index < process_count; ++process_index)
+    {
+        const pid_t child = fork();
+        if (child == 0)
+        {
+            CallbackLogger producer_logger(logger_worker_count);
+            producer_logger.register_function_callback(SharedMemorySink(ring_name), Severity::Debug);
+            producer_logger.log(Severity::Info, TestComponent::A, "from process " + std::to_string(process_index), "f.cpp", 1);
+            _exit(0);
+        }
+        children.push_back(child);
+    }
+    for (const pid_t child : children)
+        waitpid(child, nullptr, 0);
+    collector.poll();
+    SharedMemoryRing::remove(ring_name);
+
+    // Assert
+    ASSERT_EQ(received_messages, (std::set<std::string>{"from process 0", "from process 1", "from process 2"}));
+}
+#endif
+
+TEST(CppCallbackLogger, IoUringFileWriter_WithFsyncPolicy_WritesLinesInLogOrder)
+{
+    constexpr uint32_t log_count = 500;
+    // Arrange
+    const std::string file_name = temp_log_file();
+    std::remove(file_name.c_str());
+    LoggerOptions options{1};
+    options.file_writer.backend = FileWriterBackend::IoUring;
+    options.file_writer.fsync_policy = FsyncPolicy::OnSeverity;
+    options.file_writer.fsync_min_severity = Severity::Error;
+    {
+        CallbackLogger logger(options);
+        logger.register_file_callback(file_name, Severity::Debug);
+
+        // Act
+        for (uint32_t i = 0; i < log_count; ++i)
+        {
+            const Severity severity = (i % 50 == 0) ? Severity::Error : Severity::Info;
+            logger.log(severity, make_entry(TestComponent::A), "entry<" + std::to_string(i) + ">", "f.cpp", i + 1);
+        }
+        logger.shutdown();
+
+        // Assert
+        std::ifstream file_stream(file_name);
+        std::string line;
+        uint32_t expected_index = 0;
+        while (std::getline(file_stream, line))
+        {
+            ASSERT_NE(line.find("entry<" + std::to_string(expected_index) + ">"), std::string::npos);
+            ++expected_index;
+        }
+        ASSERT_EQ(expected_index, log_count);
+    }
+    std::remove(file_name.c_str());
+}
+
+TEST(CppCallbackLogger, IoUringFileWriter_FileAppendedByAnotherWriter_KeepsBothTexts)
+{
+    // Arrange
+    const std::string file_name = temp_log_file();
+    std::remove(file_name.c_str());
+    FileWriterOptions options;
+    options.backend = FileWriterBackend::IoUring;
+    {
+        FileWriter writer(file_name, options);
+
+        // Act
+        writer.write("first\n", Severity::Info);
+        writer.flush();
+        {
+            std::ofstream other_writer(file_name, std::ios::app);
+            other_writer << "other\n";
+        }
+        writer.write("second\n", Severity::Info);
+        writer.flush();
+    }
+
+    // Assert
+    std::ifstream file_stream(file_name);
+    std::stringstream file_content;
+    file_content << file_stream.rdbuf();
+    file_stream.close();
+    std::remove(file_name.c_str());
+    ASSERT_EQ(file_content.str(), "first\nother\nsecond\n");
+}
+
+TEST(CppCallbackLogger, IoUringFileWriter_ConcurrentWritersOverBuffers_CoalescesWithoutLosingText)
+{
+    constexpr size_t writer_thread_count = 4;
+    constexpr size_t writes_per_thread = 2000;
+    // Arrange
+    const std::string file_name = temp_log_file();
+    std::remove(file_name.c_str());
+    FileWriterOptions options;
+    options.backend = FileWriterBackend::IoUring;
+    options.max_buffered_bytes = 256;
+    const std::string line(100, 'x');
+    uint64_t failed_write_count = 0;
+    {
+        FileWriter writer(file_name, options);
+
+        // Act
+        std::vector<std::thread> threads;
+        for (size_t thread_index = 0; thread_index < writer_thread_count; ++thread_index)
+            threads.emplace_back([&writer, &line] {
+                for (size_t i = 0; i < writes_per_thread; ++i)
+                    writer.write(line + "\n", Severity::Info);
+            });
+        for (std::thread& thread : threads)
+            thread.join();
+        writer.flush();
+        failed_write_count = writer.failed_write_count();
+    }
+
+    // Assert
+    std::ifstream file_stream(file_name);
+    std::string read_line;
+    size_t line_count = 0;
+    while (std::getline(file_stream, read_line))
+    {
+        ASSERT_EQ(read_line, line);
+        ++line_count;
+    }
+    file_stream.close();
+    std::remove(file_name.c_str());
+    ASSERT_EQ(failed_write_count, 0u);
+    ASSERT_EQ(line_count, writer_thread_count * writes_per_thread);
+}
+
+TEST(CppCallbackLogger, BufferedStreamFileWriter_SingleThreaded_AppendsToExistingFileOnShutdown)
+{
+    // Arrange
+    const std::string file_name = temp_log_file();
+    {
+        std::ofstream existing(file_name);
+        existing << "existing line\n";
+    }
+    LoggerOptions options{0};
+    options.file_writer.backend = FileWriterBackend::BufferedStream;
+    CallbackLogger logger(options);
+    logger.register_file_callback(file_name, Severity::Info);
+
+    // Act
+    logger.log(Severity::Debug, make_entry(TestComponent::A), "filtered", "f.cpp", 1);
+    logger.log(Severity::Warning, make_entry(TestComponent::A), "buffered", "f.cpp", 2);
+    logger.shutdown();
+
+    // Assert
+    std::ifstream file_stream(file_name);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(file_stream, line))
+        lines.push_back(line);
+    file_stream.close();
+    std::remove(file_name.c_str());
+    ASSERT_EQ(lines.size(), 2u);
+    ASSERT_EQ(lines[0], "existing line");
+    ASSERT_NE(lines[1].find("[!] "), std::string::npos);
+    ASSERT_NE(lines[1].find("buffered"), std::string::npos);
+}
+
+TEST(CppCallbackLogger, FileSinkDeduplication_SamePathDifferentFilters_WritesEachEntryOnce)
+{
+    // Arrange
+    const std::string file_name = temp_log_file();
+    std::remove(file_name.c_str());
+    {
+        CallbackLogger logger(4);
+        logger.register_file_callback(file_name, Severity::Warning);
+        logger.register_file_callback("./" + file_name, std::set<ComponentEnumEntry>{make_entry(TestComponent::A)});
+        logger.register_file_callback(file_name, Severity::Debug, MessageFilter::contains("debug"));
+
+        // Act
+        logger.log(Severity::Error, make_entry(TestComponent::A), "all filters", "f.cpp", 1);
+        logger.log(Severity::Error, make_entry(TestComponent::B), "severity filter", "f.cpp", 2);
+        logger.log(Severity::Info, make_entry(TestComponent::A), "component filter", "f.cpp", 3);
+        logger.log(Severity::Debug, make_entry(TestComponent::C), "debug message filter", "f.cpp", 4);
+        logger.log(Severity::Info, make_entry(TestComponent::C), "no filter", "f.cpp", 5);
+        logger.shutdown();
+    }
+
+    // Assert
+    std::ifstream file_stream(file_name);
+    std::multiset<std::string> messages;
+    std::string line;
+    while (std::getline(file_stream, line))
+        messages.insert(line.substr(line.find("): ") + 3));
+    file_stream.close();
+    std::remove(file_name.c_str());
+    ASSERT_EQ(messages, (std::multiset<std::string>{"all filters", "severity filter", "component filter", "debug message filter"}));
+}
+
+TEST(CppCallbackLogger, FileSinkDeduplication_UnregisterOneOfSharedCallbacks_KeepsWritingThroughTheOther)
+{
+    // Arrange
+    const std::string file_name = temp_log_file();
+    std::remove(file_name.c_str());
+    LoggerOptions options{2};
+    options.file_writer.backend = FileWriterBackend::IoUring;
+    {
+        CallbackLogger logger(options);
+        const uint32_t first_handle = logger.register_file_callback(file_name, Severity::Info);
+        const uint32_t second_handle = logger.register_file_callback(file_name, Severity::Info);
+
+        // Act
+        logger.log(Severity::Info, make_entry(TestComponent::A), "shared", "f.cpp", 1);
+        logger.unregister_file_callback(first_handle);
+        logger.log(Severity::Info, make_entry(TestComponent::A), "second only", "f.cpp", 2);
+        logger.unregister_file_callback(second_handle);
+        logger.log(Severity::Info, make_entry(TestComponent::A), "unregistered", "f.cpp", 3);
+        logger.shutdown();
+    }
+
+    // Assert
+    std::ifstream file_stream(file_name);
+    std::vector<std::string> messages;
+    std::string line;
+    while (std::getline(file_stream, line))
+        messages.push_back(line.substr(line.find("): ") + 3));
+    file_stream.close();
+    std::remove(file_name.c_str());
+    ASSERT_EQ(messages, (std::vector<std::string>{"shared", "second only"}));
+}
+
+TEST(CppCallbackLogger, LogFields_FunctionCallback_ReceivesTypedFields)
+{
+    // Arrange
+    CallbackLogger logger(0);
+    std::vector<LogEntry> received_entries;
+    logger.register_function_callback([&](const LogEntry& entry) { received_entries.push_back(entry); }, Severity::Debug);
+    const std::string request_path = "/api/items";
+
+    // Act
+    LOG_FIELDS(logger, Severity::Info, TestComponent::A, "request done",
+               {"status", 200}, {"latency_ms", 3.5}, {"path", request_path});
+
+    // Assert
+    ASSERT_EQ(received_entries.size(), 1u);
+    const LogFields& fields = received_entries[0].fields;
+    ASSERT_EQ(fields.size(), 3u);
+    ASSERT_EQ(fields[0].type, LogFieldType::Int);
+    ASSERT_EQ(fields[0].int_value, 200);
+    ASSERT_EQ(fields.find("latency_ms")->double_value, 3.5);
+    ASSERT_EQ(fields.find("path")->string_value, "/api/items");
+    ASSERT_FALSE(fields.find("missing").has_value());
+}
+
+TEST(CppCallbackLogger, LogFields_FileCallback_RendersKeyValuePairsAfterMessage)
+{
+    // Arrange
+    const std::string file_name = temp_log_file();
+    std::remove(file_name.c_str());
+    {
+        CallbackLogger logger(0);
+        logger.register_file_callback(file_name, Severity::Debug);
+
+        // Act
+        logger.log(Severity::Info, make_entry(TestComponent::A), "request done",
+                   LogFields{{"status", 200}, {"ratio", 0.25}, {"user", "a \"b\""}}, "f.cpp", 1);
+        logger.shutdown();
+    }
+
+    // Assert
+    std::ifstream file_stream(file_name);
+    std::string line;
+    std::getline(file_stream, line);
+    file_stream.close();
+    std::remove(file_name.c_str());
+    ASSERT_EQ(line.substr(line.find("): ") + 3), "request done status=200 ratio=0.25 user=\"a \\\"b\\\"\"");
+}
+
+TEST(CppCallbackLogger, LogFields_DuplicateOrEmptyKey_ThrowsInvalidArgument)
+{
+    // Arrange
+    LogFields fields{{"key", 1}};
+
+    // Act & Assert
+    ASSERT_THROW(fields.add(LogField("key", 2)), std::invalid_argument);
+    ASSERT_THROW(fields.add(LogField("", 2)), std::invalid_argument);
+    ASSERT_EQ(fields.size(), 1u);
+}
+
+TEST(CppCallbackLogger, LogFields_OverCapacity_TruncatesOrDropsAndCountsInStats)
+{
+    constexpr uint32_t logger_worker_count = 0;
+    // Arrange
+    CallbackLogger logger(logger_worker_count);
+    std::vector<LogEntry> received_entries;
+    logger.register_function_callback([&](const LogEntry& entry) { received_entries.push_back(entry); }, Severity::Debug);
+    const std::string long_value(LogFields::TEXT_CAPACITY, 'x');
+    LogFields long_fields{{"key", 1}};
+    LogFields many_fields;
+
+    // Act
+    const bool is_long_added_whole = long_fields.add(LogField("long", std::string_view(long_value)));
+    const bool is_key_added_without_space = long_fields.add(LogField("extra", 2));
+    for (size_t index = 0; index < LogFields::MAX_FIELD_COUNT; ++index)
+        (void)many_fields.add(LogField("n" + std::to_string(index), 0));
+    const bool is_field_added_over_count = many_fields.add(LogField("over", 0));
+    logger.log(Severity::Info, TestComponent::A, "long", long_fields, "f.cpp", 1);
+    logger.log(Severity::Info, TestComponent::A, "many", many_fields, "f.cpp", 2);
+
+    // Assert
+    ASSERT_FALSE(is_long_added_whole);
+    ASSERT_FALSE(is_key_added_without_space);
+    ASSERT_FALSE(is_field_added_over_count);
+    ASSERT_EQ(received_entries.size(), 2u);
+    const LogFields& received_long_fields = received_entries[0].fields;
+    ASSERT_EQ(received_long_fields.size(), 2u);
+    ASSERT_EQ(received_long_fields.find("long")->string_value,
+              std::string(LogFields::TEXT_CAPACITY - std::string("key").size() - std::string("long").size(), 'x'));
+    ASSERT_EQ(received_entries[1].fields.size(), LogFields::MAX_FIELD_COUNT);
+    ASSERT_EQ(logger.stats().truncated_fields, 3u);
+}
+
+TEST(CppCallbackLogger, AppendJsonEscaped_EscapesAtEveryChunkPosition_MatchesCharacterByCharacterEscaping)
+{
+    // Arrange
+    const std::string clean(70, 'a');
+    const std::string special_characters = std::string("\"\\\n\t\x01\x1f", 6) + "\xc3\xa9";
+    const std::vector<std::string> expected_escapes{"\\\"", "\\\\", "\\n", "\\t", "\\u0001", "\\u001f", "\xc3", "\xa9"};
+
+    for (size_t position = 0; position < clean.size(); ++position)
+    {
+        for (size_t special_index = 0; special_index < special_characters.size(); ++special_index)
+        {
+            std::string value = clean;
+            value[position] = special_characters[special_index];
+            std::string escaped = "prefix";
+
+            // Act
+            append_json_escaped(escaped, value);
+
+            // Assert
+            const std::string expected = "prefix" + clean.substr(0, position) + expected_escapes[special_index]
+                + clean.substr(position + 1);
+            ASSERT_EQ(escaped, expected);
+        }
+    }
+}
+
+TEST(CppCallbackLogger, JsonLinesFileCallback_EntryWithFields_WritesOneJsonObjectPerLine)
+{
+    // Arrange
+    const std::string file_name = temp_log_file();
+    std::remove(file_name.c_str());
+    {
+        CallbackLogger logger(2);
+        logger.register_file_callback(file_name, Severity::Info, MessageFilter{}, FileFormat::JsonLines);
+
+        // Act
+        logger.log(Severity::Warning, make_entry(TestComponent::A), "say \"hi\"\n", "dir\\f.cpp", 7);
+        logger.log(Severity::Info, make_entry(TestComponent::B), "done",
+                   LogFields{{"status", 200}, {"ratio", 0.5}, {"user", "bob"}}, "f.cpp", 8);
+        logger.shutdown();
+    }
+
+    // Assert
+    std::ifstream file_stream(file_name);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(file_stream, line))
+        lines.push_back(line.substr(line.find("\",\"severity\"")));
+    file_stream.close();
+    std::remove(file_name.c_str());
+    ASSERT_EQ(lines.size(), 2u);
+    ASSERT_EQ(lines[0], "\",\"severity\":\"Warning\",\"component\":\"" + make_entry(TestComponent::A).to_string()
+        + "\",\"file\":\"dir\\\\f.cpp\",\"line\":7,\"message\":\"say \\\"hi\\\"\\n\"}");
+    ASSERT_EQ(lines[1], "\",\"severity\":\"Info\",\"component\":\"" + make_entry(TestComponent::B).to_string()
+        + "\",\"file\":\"f.cpp\",\"line\":8,\"message\":\"done\",\"fields\":{\"status\":200,\"ratio\":0.5,\"user\":\"bob\"}}");
+}
+
+TEST(CppCallbackLogger, RegisterFileCallback_SameFileInAnotherFormat_ThrowsInvalidArgument)
+{
+    // Arrange
+    const std::string file_name = temp_log_file();
+    CallbackLogger logger(0);
+    logger.register_file_callback(file_name, Severity::Info);
+
+    // Act & Assert
+    ASSERT_THROW(logger.register_file_callback(file_name, Severity::Info, MessageFilter{}, FileFormat::JsonLines),
+                 std::invalid_argument);
+    ASSERT_NO_THROW(logger.register_file_callback(file_name, Severity::Debug, MessageFilter{}, FileFormat::Text));
+    std::remove(file_name.c_str());
+}
+
+TEST(CppCallbackLogger, PatternFormatter_CustomPattern_WritesLinesInPatternLayout)
+{
+    // Arrange
+    const std::string file_name = temp_log_file();
+    std::remove(file_name.c_str());
+    {
+        CallbackLogger logger(2);
+        logger.register_file_callback(file_name, Severity::Info, MessageFilter{},
+                                      std::make_shared<const PatternFormatter>("%T [%S] %C %F:%L %M%A 100%%"));
+
+        // Act
+        logger.log(Severity::Error, make_entry(TestComponent::A), "disk full", LogFields{{"free", 0}}, "io.cpp", 12);
+        logger.shutdown();
+    }
+
+    // Assert
+    std::ifstream file_stream(file_name);
+    std::string line;
+    std::getline(file_stream, line);
+    file_stream.close();
+    std::remove(file_name.c_str());
+    ASSERT_EQ(line.substr(line.find(" [")),
+              " [Error] " + make_entry(TestComponent::A).to_string() + " io.cpp:12 disk full free=0 100%");
+}
+
+TEST(CppCallbackLogger, PatternFormatter_UnknownOrIncompleteDirective_ThrowsInvalidArgument)
+{
+    // Act & Assert
+    ASSERT_THROW(PatternFormatter("%M %Q"), std::invalid_argument);
+    ASSERT_THROW(PatternFormatter("%M %"), std::invalid_argument);
+    ASSERT_THROW(PatternFormatter(""), std::invalid_argument);
+}
+
+TEST(CppCallbackLogger, PatternFormatter_DefaultPattern_MatchesTextFileLayout)
+{
+    // Arrange
+    const LogEntry entry{Severity::Warning, make_entry(TestComponent::B), "careful", "f.cpp", 3, "2026-01-02 03:04:05.006",
+                         LogFields{{"attempt", 2}}};
+    const PatternFormatter formatter(PatternFormatter::DEFAULT_PATTERN);
+    std::string line = "kept ";
+
+    // Act
+    formatter.format(entry, line);
+
+    // Assert
+    ASSERT_EQ(line, "kept [!] [2026-01-02 03:04:05.006] [Warning] " + make_entry(TestComponent::B).to_string()
+        + " (f.cpp:3): careful attempt=2\n");
+    ASSERT_EQ(line.substr(5), format_file_log_line(entry));
+}
+
+TEST(CppCallbackLogger, SeverityName_EverySeverity_MatchesToString)
+{
+    // Arrange
+    const std::vector<Severity> severities{Severity::Debug, Severity::Info, Severity::Warning, Severity::Error,
+                                           Severity::Fatal, Severity::Uninitialized};
+
+    for (const Severity severity : severities)
+    {
+        // Act
+        const std::string_view name = severity_name(severity);
+
+        // Assert
+        ASSERT_EQ(std::string(name), to_string(severity));
+    }
+    static_assert(severity_name(Severity::Warning) == "Warning", "Severity names are available at compile time");
+}
+
+TEST(CppCallbackLogger, ComponentName_SameComponentFromSeveralThreads_SharesOneBuiltName)
+{
+    // Arrange
+    const ComponentEnumEntry component = make_entry(TestComponent::C);
+    const std::string_view name = component.name();
+    std::vector<std::string_view> thread_names(4);
+    std::vector<std::thread> threads;
+
+    // Act
+    for (size_t index = 0; index < thread_names.size(); ++index)
+        threads.emplace_back([&, index] { thread_names[index] = ComponentEnumEntry(component).name(); });
+    for (std::thread& thread : threads)
+        thread.join();
+
+    // Assert
+    ASSERT_EQ(std::string(name), component.to_string());
+    ASSERT_NE(name, make_entry(TestComponent::D).name());
+    for (const std::string_view thread_name : thread_names)
+        ASSERT_EQ(thread_name.data(), name.data());
+}
+
+namespace {
+
+// Keeps the only worker busy on an entry of component A until released, so the following tasks queue up
+void block_single_worker(CallbackLogger& logger, std::atomic<bool>& started, std::atomic<bool>& released)
+{
+    logger.register_function_callback([&started, &released](const LogEntry&) {
+        started = true;
+        while (!released)
+            std::this_thread::yield();
+    }, make_entry(TestComponent::A));
+    logger.log(Severity::Info, make_entry(TestComponent::A), "block", "f.cpp", 1);
+    while (!started)
+        std::this_thread::yield();
+}
+
+} // namespace
+
+TEST(CppCallbackLogger, SetCallbackPriority_HighCallback_OvertakesQueuedLowEntries)
+{
+    constexpr uint32_t log_count = 4;
+    // Arrange
+    CallbackLogger logger(LoggerOptions{1});
+    std::mutex order_mutex;
+    std::vector<std::string> order;
+    const auto record = [&order_mutex, &order](const std::string& lane) {
+        return [&order_mutex, &order, lane](const LogEntry&) {
+            std::lock_guard<std::mutex> lock(order_mutex);
+            order.push_back(lane);
+        };
+    };
+    const uint32_t low_handle = logger.register_function_callback(record("L"), make_entry(TestComponent::B));
+    const uint32_t high_handle = logger.register_function_callback(record("H"), make_entry(TestComponent::B));
+    logger.set_callback_priority(low_handle, CallbackPriority::Low);
+    logger.set_callback_priority(high_handle, CallbackPriority::High);
+    std::atomic<bool> started{false};
+    std::atomic<bool> released{false};
+    block_single_worker(logger, started, released);
+
+    // Act
+    for (uint32_t i = 0; i < log_count; ++i)
+        logger.log(Severity::Info, make_entry(TestComponent::B), "entry", "f.cpp", i + 2);
+    released = true;
+    logger.shutdown();
+
+    // Assert
+    const std::vector<std::string> expected{"H", "H", "H", "H", "L", "L", "L", "L"};
+    ASSERT_EQ(order, expected);
+    ASSERT_THROW(logger.set_callback_priority(high_handle + 100, CallbackPriority::Low), std::runtime_error);
+    ASSERT_THROW(logger.set_callback_priority(high_handle, CallbackPriority::PRIORITY_COUNT), std::invalid_argument);
+}
+
+TEST(CppCallbackLogger, LaneStarvationLimit_WaitingLowLane_ServedAfterLimitHighTasks)
+{
+    constexpr uint32_t log_count = 3;
+    // Arrange
+    LoggerOptions options{1};
+    options.lane_starvation_limit = 2;
+    CallbackLogger logger(options);
+    std::mutex order_mutex;
+    std::vector<std::string> order;
+    const auto record = [&order_mutex, &order](const std::string& lane) {
+        return [&order_mutex, &order, lane](const LogEntry&) {
+            std::lock_guard<std::mutex> lock(order_mutex);
+            order.push_back(lane);
+        };
+    };
+    logger.set_callback_priority(logger.register_function_callback(record("L"), make_entry(TestComponent::B)),
+                                 CallbackPriority::Low);
+    logger.set_callback_priority(logger.register_function_callback(record("H"), make_entry(TestComponent::B)),
+                                 CallbackPriority::High);
+    std::atomic<bool> started{false};
+    std::atomic<bool> released{false};
+    block_single_worker(logger, started, released);
+
+    // Act
+    for (uint32_t i = 0; i < log_count; ++i)
+        logger.log(Severity::Info, make_entry(TestComponent::B), "entry", "f.cpp", i + 2);
+    released = true;
+    logger.shutdown();
+
+    // Assert
+    const std::vector<std::string> expected{"H", "H", "L", "H", "L", "L"};
+    ASSERT_EQ(order, expected);
+    LoggerOptions invalid_options{1};
+    invalid_options.lane_starvation_limit = 0;
+    ASSERT_THROW(CallbackLogger{invalid_options}, std::invalid_argument);
+}
+
+TEST(CppCallbackLogger, HighPriorityMinSeverity_SevereEntries_PromotedToHighLane)
+{
+    // Arrange
+    LoggerOptions options{1};
+    options.high_priority_min_severity = Severity::Error;
+    CallbackLogger logger(options);
+    std::mutex order_mutex;
+    std::vector<std::string> order;
+    logger.register_function_callback([&order_mutex, &order](const LogEntry& entry) {
+        std::lock_guard<std::mutex> lock(order_mutex);
+        order.push_back(entry.message);
+    }, make_entry(TestComponent::B));
+    std::atomic<bool> started{false};
+    std::atomic<bool> released{false};
+    block_single_worker(logger, started, released);
+
+    // Act
+    logger.log(Severity::Info, make_entry(TestComponent::B), "info", "f.cpp", 2);
+    logger.log(Severity::Error, make_entry(TestComponent::B), "error", "f.cpp", 3);
+    const LoggerStatistics queued_statistics = logger.stats();
+    released = true;
+    logger.shutdown();
+    const LoggerStatistics statistics = logger.stats();
+
+    // Assert
+    const std::vector<std::string> expected{"error", "info"};
+    ASSERT_EQ(order, expected);
+    ASSERT_EQ(queued_statistics.lanes[static_cast<size_t>(CallbackPriority::High)].queue_depth, 1u);
+    ASSERT_EQ(queued_statistics.lanes[static_cast<size_t>(CallbackPriority::Normal)].queue_depth, 1u);
+    const LaneStatistics& high_lane = statistics.lanes[static_cast<size_t>(CallbackPriority::High)];
+    ASSERT_EQ(high_lane.tasks_dequeued, 1u);
+    uint64_t high_wait_count = 0;
+    for (const uint64_t count : high_lane.wait_histogram)
+        high_wait_count += count;
+    ASSERT_EQ(high_wait_count, 1u);
+}
+
+TEST(CppCallbackLogger, EpochDomain_PinnedReader_DelaysReclamationUntilUnpinned)
+{
+    struct Tracked
+    {
+        explicit Tracked(std::atomic<bool>& is_destroyed) : m_is_destroyed(is_destroyed) {}
+        ~Tracked() { m_is_destroyed = true; }
+        std::atomic<bool>& m_is_destroyed;
+    };
+    // Arrange
+    EpochDomain domain;
+    std::atomic<bool> is_destroyed{false};
+    std::atomic<bool> is_pinned{false};
+    std::atomic<bool> released{false};
+    std::thread reader([&] {
+        const EpochDomain::Guard guard(domain);
+        const EpochDomain::Guard nested_guard(domain);
+        is_pinned = true;
+        while (!released)
+            std::this_thread::yield();
+    });
+    while (!is_pinned)
+        std::this_thread::yield();
+
+    // Act
+    domain.retire(std::make_unique<Tracked>(is_destroyed));
+    const size_t pending_while_pinned = domain.reclaim();
+    const bool is_destroyed_while_pinned = is_destroyed;
+    released = true;
+    reader.join();
+    const size_t pending_after_unpin = domain.reclaim();
+
+    // Assert
+    ASSERT_EQ(pending_while_pinned, 1u);
+    ASSERT_FALSE(is_destroyed_while_pinned);
+    ASSERT_EQ(pending_after_unpin, 0u);
+    ASSERT_TRUE(is_destroyed);
+}
+
+TEST(CppCallbackLogger, EpochDomain_AlternatingDomainsOnOneThread_PinOnlyTheirOwnRecord)
+{
+    // Arrange
+    EpochDomain first_domain;
+    EpochDomain second_domain;
+    for (int round = 0; round < 3; ++round)
+    {
+        const EpochDomain::Guard first_guard(first_domain);
+        const EpochDomain::Guard second_guard(second_domain);
+    }
+
+    // Act
+    size_t first_pending_while_second_pinned = 0;
+    size_t second_pending_while_second_pinned = 0;
+    {
+        const EpochDomain::Guard second_guard(second_domain);
+        first_domain.retire(std::make_unique<int>(1));
+        second_domain.retire(std::make_unique<int>(2));
+        first_pending_while_second_pinned = first_domain.reclaim();
+        second_pending_while_second_pinned = second_domain.reclaim();
+    }
+    const size_t second_pending_after_unpin = second_domain.reclaim();
+
+    // Assert
+    ASSERT_EQ(first_pending_while_second_pinned, 0u);
+    ASSERT_EQ(second_pending_while_second_pinned, 1u);
+    ASSERT_EQ(second_pending_after_unpin, 0u);
+}
+
+TEST(CppCallbackLogger, SingleThreaded_ConcurrentRegisterAndUnregister_DeliversEveryEntry)
+{
+    constexpr size_t producer_count = 4;
+    constexpr uint32_t logs_per_producer = 2000;
+    // Arrange
+    CallbackLogger logger(0);
+    std::atomic<uint32_t> received_count{0};
+    logger.register_function_callback([&received_count](const LogEntry&) { ++received_count; }, Severity::Debug);
+    const std::string file_name = temp_log_file();
+    std::atomic<bool> is_done{false};
+
+    // Act
+    std::thread registrar([&] {
+        uint32_t iteration = 0;
+        while (!is_done)
+        {
+            const uint32_t function_handle = logger.register_function_callback([](const LogEntry&) {},
+                                                                               make_entry(TestComponent::B));
+            if (iteration++ % 16 == 0)
+            {
+                const uint32_t file_handle = logger.register_file_callback(file_name, Severity::Fatal);
+                logger.unregister_file_callback(file_handle);
+            }
+            logger.set_component_parent(make_entry(TestComponent::C), make_entry(TestComponent::D));
+            logger.unregister_function_callback(function_handle);
+        }
+    });
+    std::vector<std::thread> producers;
+    for (size_t producer = 0; producer < producer_count; ++producer)
+        producers.emplace_back([&logger] {
+            for (uint32_t i = 0; i < logs_per_producer; ++i)
+                logger.log(Severity::Info, make_entry(TestComponent::B), "entry", "f.cpp", i + 1);
+        });
+    for (std::thread& producer : producers)
+        producer.join();
+    is_done = true;
+    registrar.join();
+
+    // Assert
+    std::remove(file_name.c_str());
+    ASSERT_EQ(received_count.load(), producer_count * logs_per_producer);
+}
+
+TEST(CppCallbackLogger, SingleThreaded_CallbackUnregistersItselfDuringDispatch_StopsReceiving)
+{
+    // Arrange
+    CallbackLogger logger(0);
+    std::vector<std::string> self_removing_messages;
+    std::vector<std::string> added_messages;
+    uint32_t self_removing_handle = 0;
+    self_removing_handle = logger.register_function_callback([&](const LogEntry& entry) {
+        self_removing_messages.push_back(entry.message);
+        logger.unregister_function_callback(self_removing_handle);
+        logger.register_function_callback([&added_messages](const LogEntry& added_entry) {
+            added_messages.push_back(added_entry.message);
+        }, Severity::Debug);
+    }, Severity::Debug);
+
+    // Act
+    logger.log(Severity::Info, make_entry(TestComponent::A), "first", "f.cpp", 1);
+    logger.log(Severity::Info, make_entry(TestComponent::A), "second", "f.cpp", 2);
+
+    // Assert
+    ASSERT_EQ(self_removing_messages, std::vector<std::string>{"first"});
+    ASSERT_EQ(added_messages, std::vector<std::string>{"second"});
+}
+
+TEST(CppCallbackLogger, Flush_WithBlockedWorker_TimesOutThenDeliversAfterRelease)
+{
+    constexpr uint32_t log_count = 5;
+    // Arrange
+    CallbackLogger logger(LoggerOptions{1});
+    std::atomic<uint32_t> received_count{0};
+    logger.register_function_callback([&received_count](const LogEntry&) { ++received_count; }, make_entry(TestComponent::B));
+    std::atomic<bool> started{false};
+    std::atomic<bool> released{false};
+    block_single_worker(logger, started, released);
+    for (uint32_t i = 0; i < log_count; ++i)
+        logger.log(Severity::Info, make_entry(TestComponent::B), "entry", "f.cpp", i + 2);
+
+    // Act
+    const bool is_flushed_while_blocked = logger.flush(std::chrono::milliseconds(20));
+    released = true;
+    const bool is_flushed_after_release = logger.flush(std::chrono::seconds(10));
+
+    // Assert
+    ASSERT_FALSE(is_flushed_while_blocked);
+    ASSERT_TRUE(is_flushed_after_release);
+    ASSERT_EQ(received_count.load(), log_count);
+}
+
+TEST(CppCallbackLogger, Flush_WithSeveralWorkers_DeliversEveryEarlierEntryAndFlushesFiles)
+{
+    constexpr uint32_t log_count = 1000;
+    // Arrange
+    const std::string file_name = temp_log_file();
+    std::remove(file_name.c_str());
+    LoggerOptions options{4};
+    options.sink_ordering = SinkOrdering::PerSink;
+    options.file_writer.backend = FileWriterBackend::BufferedStream;
+    CallbackLogger logger(options);
+    std::atomic<uint32_t> received_count{0};
+    logger.register_function_callback([&received_count](const LogEntry& entry) {
+        if (entry.line % 100 == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        ++received_count;
+    }, Severity::Debug);
+    logger.register_file_callback(file_name, Severity::Debug);
+
+    // Act
+    for (uint32_t i = 0; i < log_count; ++i)
+        logger.log(Severity::Info, make_entry(TestComponent::A), "entry", "f.cpp", i + 1);
+    const bool is_flushed = logger.flush(std::chrono::seconds(10));
+
+    // Assert
+    ASSERT_TRUE(is_flushed);
+    ASSERT_EQ(received_count.load(), log_count);
+    std::ifstream file_stream(file_name);
+    std::string line;
+    uint32_t line_count = 0;
+    while (std::getline(file_stream, line))
+        ++line_count;
+    ASSERT_EQ(line_count, log_count);
+    logger.shutdown();
+    std::remove(file_name.c_str());
+}
+
+TEST(CppCallbackLogger, ShutdownWithDeadline_BlockedWorker_ReturnsAndReportsStuckWorker)
+{
+    constexpr uint32_t log_count = 5;
+    // Arrange
+    // Declared before the logger, the stuck worker reads them until the destructor joins it
+    std::atomic<bool> started{false};
+    std::atomic<bool> released{false};
+    std::atomic<uint32_t> received_count{0};
+    CallbackLogger logger(LoggerOptions{1});
+    logger.register_function_callback([&received_count](const LogEntry&) { ++received_count; }, make_entry(TestComponent::B));
+    block_single_worker(logger, started, released);
+    for (uint32_t i = 0; i < log_count; ++i)
+        logger.log(Severity::Info, make_entry(TestComponent::B), "entry", "f.cpp", i + 2);
+
+    // Act
+    const ShutdownReport report = logger.shutdown(std::chrono::steady_clock::now() + std::chrono::milliseconds(20));
+    const bool is_released_before_return = released;
+    released = true;
+    const ShutdownReport repeated_report = logger.shutdown(std::chrono::steady_clock::now());
+
+    // Assert
+    ASSERT_FALSE(is_released_before_return);
+    ASSERT_FALSE(report.is_drained);
+    ASSERT_EQ(report.stuck_workers, 1u);
+    ASSERT_EQ(report.dropped_tasks, log_count);
+    ASSERT_EQ(received_count.load(), 0u);
+    ASSERT_EQ(repeated_report.stuck_workers, 1u);
+    ASSERT_EQ(repeated_report.dropped_tasks, log_count);
+}
+
+TEST(CppCallbackLogger, ShutdownWithDeadline_ConcurrentCalls_ShareTheFirstReport)
+{
+    constexpr size_t caller_count = 4;
+    constexpr uint32_t log_count = 50;
+    // Arrange
+    CallbackLogger logger(LoggerOptions{2});
+    std::atomic<uint32_t> received_count{0};
+    logger.register_function_callback([&received_count](const LogEntry&) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        ++received_count;
+    }, Severity::Debug);
+    for (uint32_t i = 0; i < log_count; ++i)
+        logger.log(Severity::Info, make_entry(TestComponent::A), "entry", "f.cpp", i + 1);
+
+    // Act
+    std::vector<ShutdownReport> reports(caller_count);
+    std::vector<std::thread> callers;
+    for (size_t caller = 0; caller < caller_count; ++caller)
+        callers.emplace_back([&logger, &reports, caller] {
+            reports[caller] = logger.shutdown(std::chrono::steady_clock::now() + std::chrono::seconds(10));
+        });
+    for (std::thread& caller : callers)
+        caller.join();
+
+    // Assert
+    ASSERT_EQ(received_count.load(), log_count);
+    for (const ShutdownReport& report : reports)
+    {
+        ASSERT_TRUE(report.is_drained);
+        ASSERT_EQ(report.dropped_tasks, 0u);
+        ASSERT_EQ(report.stuck_workers, 0u);
+    }
+}
+
+TEST(CppCallbackLogger, ShutdownWithDeadline_IdleWorkers_DeliversEverything)
+{
+    constexpr uint32_t log_count = 100;
+    // Arrange
+    CallbackLogger logger(LoggerOptions{2});
+    std::atomic<uint32_t> received_count{0};
+    logger.register_function_callback([&received_count](const LogEntry&) { ++received_count; }, Severity::Debug);
+    for (uint32_t i = 0; i < log_count; ++i)
+        logger.log(Severity::Info, make_entry(TestComponent::A), "entry", "f.cpp", i + 1);
+
+    // Act
+    const ShutdownReport report = logger.shutdown(std::chrono::steady_clock::now() + std::chrono::seconds(10));
+
+    // Assert
+    ASSERT_TRUE(report.is_drained);
+    ASSERT_EQ(report.dropped_tasks, 0u);
+    ASSERT_EQ(received_count.load(), log_count);
+}
+
+#if defined(__linux__)
+namespace {
+
+std::vector<std::string> read_log_messages(const std::string& file_name)
+{
+    std::vector<std::string> messages;
+    std::ifstream file_stream(file_name);
+    std::string line;
+    while (std::getline(file_stream, line))
+        messages.push_back(line.substr(line.rfind(": ") + 2));
+    return messages;
+}
+
+} // namespace
+
+TEST(CppCallbackLogger, Fork_WorkerPoolLogger_ChildDeliversThroughItsOwnWorkers)
+{
+    constexpr uint32_t child_log_count = 20;
+    for (const SchedulerMode scheduler_mode : {SchedulerMode::SharedQueue, SchedulerMode::WorkStealing})
+    {
+        // Arrange
+        const std::string file_name = temp_log_file();
+        std::remove(file_name.c_str());
+        LoggerOptions options{2};
+        options.scheduler_mode = scheduler_mode;
+        options.fork_safe = true;
+        options.file_writer.backend = FileWriterBackend::BufferedStream;
+        CallbackLogger logger(options);
+        logger.register_file_callback(file_name, Severity::Debug);
+        std::atomic<uint32_t> received_count{0};
+        logger.register_function_callback([&received_count](const LogEntry&) { ++received_count; }, Severity::Debug);
+        logger.log(Severity::Info, make_entry(TestComponent::A), "before fork", "f.cpp", 1);
+        ASSERT_TRUE(logger.flush(std::chrono::seconds(10)));
+
+        // Act
+        const pid_t child = fork();
+        if (child == 0)
+        {
+            for (uint32_t i = 0; i < child_log_count; ++i)
+                logger.log(Severity::Info, make_entry(TestComponent::A), "from child", "f.cpp", i + 2);
+            const bool is_flushed = logger.flush(std::chrono::seconds(10));
+            _exit((is_flushed && received_count == child_log_count + 1) ? 0 : 1);
+        }
+        int child_status = 0;
+        waitpid(child, &child_status, 0);
+        logger.log(Severity::Info, make_entry(TestComponent::A), "after fork", "f.cpp", 1);
+        const bool is_flushed = logger.flush(std::chrono::seconds(10));
+
+        // Assert
+        ASSERT_TRUE(WIFEXITED(child_status));
+        ASSERT_EQ(WEXITSTATUS(child_status), 0);
+        ASSERT_TRUE(is_flushed);
+        ASSERT_EQ(received_count.load(), 2u);
+        const std::vector<std::string> messages = read_log_messages(file_name);
+        ASSERT_EQ(messages.size(), child_log_count + 2);
+        ASSERT_EQ(std::count(messages.begin(), messages.end(), "from child"), child_log_count);
+        ASSERT_EQ(std::count(messages.begin(), messages.end(), "before fork"), 1);
+        logger.shutdown();
+        std::remove(file_name.c_str());
+    }
+}
+
+TEST(CppCallbackLogger, Fork_WithTasksQueuedInParent_OnlyParentDeliversThem)
+{
+    constexpr uint32_t log_count = 5;
+    // Arrange
+    const std::string file_name = temp_log_file();
+    std::remove(file_name.c_str());
+    LoggerOptions options{1};
+    options.fork_safe = true;
+    options.file_writer.backend = FileWriterBackend::BufferedStream;
+    CallbackLogger logger(options);
+    logger.register_file_callback(file_name, make_entry(TestComponent::B));
+    std::atomic<bool> started{false};
+    std::atomic<bool> released{false};
+    block_single_worker(logger, started, released);
+    for (uint32_t i = 0; i < log_count; ++i)
+        logger.log(Severity::Info, make_entry(TestComponent::B), "from parent", "f.cpp", i + 2);
+
+    // Act
+    const pid_t child = fork();
+    if (child == 0)
+    {
+        logger.log(Severity::Info, make_entry(TestComponent::B), "from child", "f.cpp", 1);
+        _exit(logger.flush(std::chrono::seconds(10)) ? 0 : 1);
+    }
+    int child_status = 0;
+    waitpid(child, &child_status, 0);
+    released = true;
+    const bool is_flushed = logger.flush(std::chrono::seconds(10));
+
+    // Assert
+    ASSERT_TRUE(WIFEXITED(child_status));
+    ASSERT_EQ(WEXITSTATUS(child_status), 0);
+    ASSERT_TRUE(is_flushed);
+    const std::vector<std::string> messages = read_log_messages(file_name);
+    ASSERT_EQ(messages.size(), log_count + 1);
+    ASSERT_EQ(std::count(messages.begin(), messages.end(), "from parent"), log_count);
+    ASSERT_EQ(std::count(messages.begin(), messages.end(), "from child"), 1);
+    logger.shutdown();
+    std::remove(file_name.c_str());
+}
+
+TEST(CppCallbackLogger, Fork_WhileAnotherThreadNamesComponents_ChildNamesNewComponents)
+{
+    constexpr uint32_t fork_count = 20;
+    // Arrange
+    std::atomic<bool> stopped{false};
+    std::thread naming_thread([&stopped] {
+        for (uint32_t value = 0; !stopped; ++value)
+            (void)ComponentEnumEntry(std::string("ParentComponent"), value).name();
+    });
+
+    // Act
+    std::vector<int> child_statuses;
+    for (uint32_t i = 0; i < fork_count; ++i)
+    {
+        const pid_t child = fork();
+        if (child == 0)
+            _exit(ComponentEnumEntry(std::string("ChildComponent"), i).name() == "ChildComponent#" + std::to_string(i) ? 0 : 1);
+        int child_status = 0;
+        waitpid(child, &child_status, 0);
+        child_statuses.push_back(child_status);
+    }
+    stopped = true;
+    naming_thread.join();
+
+    // Assert
+    for (const int child_status : child_statuses)
+    {
+        ASSERT_TRUE(WIFEXITED(child_status));
+        ASSERT_EQ(WEXITSTATUS(child_status), 0);
+    }
+}
+
+TEST(CppCallbackLogger, Fork_SingleThreadedBufferedWriter_ParentTextWrittenOnce)
+{
+    // Arrange
+    const std::string file_name = temp_log_file();
+    std::remove(file_name.c_str());
+    LoggerOptions options{0};
+    options.fork_safe = true;
+    options.file_writer.backend = FileWriterBackend::BufferedStream;
+    CallbackLogger logger(options);
+    logger.register_file_callback(file_name, Severity::Debug);
+    // Still in the parent's stream buffer when forking
+    logger.log(Severity::Info, make_entry(TestComponent::A), "from parent", "f.cpp", 1);
+
+    // Act
+    const pid_t child = fork();
+    if (child == 0)
+    {
+        logger.log(Severity::Info, make_entry(TestComponent::A), "from child", "f.cpp", 2);
+        logger.shutdown();
+        _exit(0);
+    }
+    int child_status = 0;
+    waitpid(child, &child_status, 0);
+    logger.shutdown();
+
+    // Assert
+    ASSERT_TRUE(WIFEXITED(child_status));
+    ASSERT_EQ(read_log_messages(file_name), (std::vector<std::string>{"from child", "from parent"}));
+    std::remove(file_name.c_str());
+}
+#endif
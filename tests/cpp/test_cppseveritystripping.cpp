@@ -0,0 +1,41 @@
+// Compiles the logging macros with Warning as the lowest compiled-in severity, whatever the build configures
+#undef CALLBACK_LOGGER_MIN_SEVERITY
+#define CALLBACK_LOGGER_MIN_SEVERITY 2
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "CallbackLogger.hpp"
+
+enum class StrippingComponent { A };
+
+namespace {
+
+std::string counted_message(uint32_t& evaluation_count, const std::string& message)
+{
+    ++evaluation_count;
+    return message;
+}
+
+}
+
+TEST(CppSeverityStripping, SeverityMacros_BelowMinimalSeverity_AreNotEvaluated)
+{
+    constexpr uint32_t logger_worker_count = 0;
+    // Arrange
+    CallbackLogger logger(logger_worker_count);
+    std::vector<std::string> received_messages;
+    uint32_t evaluation_count = 0;
+    logger.register_function_callback([&](const LogEntry& entry) { received_messages.push_back(entry.message); }, Severity::Debug);
+
+    // Act
+    LOG_DEBUG(logger, StrippingComponent::A, counted_message(evaluation_count, "debug"));
+    LOG_INFO(logger, StrippingComponent::A, counted_message(evaluation_count, "info"));
+    LOG_WARNING(logger, StrippingComponent::A, counted_message(evaluation_count, "warning"));
+    LOG_ERROR(logger, StrippingComponent::A, counted_message(evaluation_count, "error"));
+
+    // Assert
+    ASSERT_EQ(evaluation_count, 2);
+    ASSERT_EQ(received_messages, (std::vector<std::string>{"warning", "error"}));
+}
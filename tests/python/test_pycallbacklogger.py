@@ -2,6 +2,7 @@ import pytest
 import pycallbacklogger
 import tempfile
 import os
+import json
 from enum import Enum
 
 def test_register_function_callback_info_message_received(logger, PyComponent, log_entry_collector):
@@ -550,3 +551,219 @@ def test_log_empty_message_throws(logger, PyComponent):
     # Act & Assert
     with pytest.raises(RuntimeError, match="Cannot log an empty message"):
         logger.log(pycallbacklogger.Severity.Info, COMPONENT_S, "", FILE_NAME, LINE_NUMBER)
+
+def test_stats_counts_logged_and_filtered_entries(logger, PyComponent):
+    # Arrange
+    FILE_NAME = "f.cpp"
+    handle = logger.register_function_callback(lambda entry: None, pycallbacklogger.Severity.Warning)
+
+    # Act
+    logger.log(pycallbacklogger.Severity.Info, PyComponent.S, "filtered", FILE_NAME, 1)
+    logger.log(pycallbacklogger.Severity.Error, PyComponent.M, "delivered", FILE_NAME, 2)
+    stats = logger.stats()
+
+    # Assert
+    assert stats.logged_per_severity[pycallbacklogger.Severity.Info] == 1
+    assert stats.logged_per_severity[pycallbacklogger.Severity.Error] == 1
+    assert stats.logged_per_component[PyComponent.S] == 1
+    assert stats.logged_per_component[PyComponent.M] == 1
+    assert stats.filtered_out == 1
+    assert stats.function_callbacks[handle].invocations == 1
+
+def test_callback_failure_threshold_disables_failing_callback(logger, PyComponent):
+    # Arrange
+    FILE_NAME = "f.cpp"
+    def failing_callback(entry):
+        raise RuntimeError("callback failure")
+    logger.set_callback_failure_threshold(2)
+    handle = logger.register_function_callback(failing_callback, pycallbacklogger.Severity.Debug)
+
+    # Act
+    for line in range(3):
+        logger.log(pycallbacklogger.Severity.Info, PyComponent.S, "fails", FILE_NAME, line)
+    logger.flush(5.0)
+    stats = logger.stats()
+
+    # Assert
+    assert stats.function_callbacks[handle].exceptions == 2
+    assert stats.function_callbacks[handle].is_disabled
+
+def test_set_component_parent_cycle_raises(logger, PyComponent):
+    # Arrange
+    logger.set_component_parent(PyComponent.M, PyComponent.S)
+
+    # Act & Assert
+    with pytest.raises(ValueError, match="cycle"):
+        logger.set_component_parent(PyComponent.S, PyComponent.M)
+
+def test_set_call_site_rate_limit_drops_repeated_call_site(logger, PyComponent, log_entry_collector):
+    # Arrange
+    callback, received_entries = log_entry_collector
+    FILE_NAME = "f.cpp"
+    LINE_NUMBER = 1
+    logger.register_function_callback(callback, pycallbacklogger.Severity.Debug)
+    logger.set_call_site_rate_limit(0.001, 1)
+
+    # Act
+    for _ in range(5):
+        logger.log(pycallbacklogger.Severity.Info, PyComponent.S, "hot", FILE_NAME, LINE_NUMBER)
+
+    # Assert
+    assert len(received_entries) == 1
+    assert logger.stats().rate_limited == 4
+
+def test_set_sampling_rate_zero_drops_and_counts_entries(logger, PyComponent, log_entry_collector):
+    # Arrange
+    callback, received_entries = log_entry_collector
+    FILE_NAME = "f.cpp"
+    logger.register_function_callback(callback, pycallbacklogger.Severity.Debug)
+    logger.set_sampling_rate(pycallbacklogger.Severity.Debug, 0.0)
+
+    # Act
+    logger.log(pycallbacklogger.Severity.Debug, PyComponent.S, "sampled out", FILE_NAME, 1)
+    logger.log(pycallbacklogger.Severity.Info, PyComponent.S, "kept", FILE_NAME, 2)
+
+    # Assert
+    assert [entry.message for entry in received_entries] == ["kept"]
+    assert logger.stats().sampled_out_per_severity[pycallbacklogger.Severity.Debug] == 1
+
+def test_flight_recorder_dump_contains_filtered_entries(logger, PyComponent, temp_log_file):
+    # Arrange
+    dump_path = temp_log_file
+    FILE_NAME = "f.cpp"
+    logger.register_function_callback(lambda entry: None, pycallbacklogger.Severity.Error)
+    logger.enable_flight_recorder(dump_path)
+
+    # Act
+    logger.log(pycallbacklogger.Severity.Debug, PyComponent.S, "recorded debug", FILE_NAME, 1)
+    is_dumped = logger.dump_flight_recorder()
+
+    # Assert
+    assert is_dumped
+    with open(dump_path, "r") as f:
+        content = f.read()
+    assert "recorded debug" in content
+
+def test_log_with_fields_passes_typed_fields_to_callback(logger, PyComponent, log_entry_collector):
+    # Arrange
+    callback, received_entries = log_entry_collector
+    FILE_NAME = "f.cpp"
+    logger.register_function_callback(callback, pycallbacklogger.Severity.Debug)
+
+    # Act
+    logger.log(pycallbacklogger.Severity.Info, PyComponent.S, "request done", FILE_NAME, 1,
+               fields={"status": 200, "latency_ms": 3.5, "path": "/api/items"})
+
+    # Assert
+    assert received_entries[0].fields == {"status": 200, "latency_ms": 3.5, "path": "/api/items"}
+
+def test_log_with_too_many_fields_drops_excess_and_counts_it(logger, PyComponent, log_entry_collector):
+    # Arrange
+    callback, received_entries = log_entry_collector
+    FILE_NAME = "f.cpp"
+    logger.register_function_callback(callback, pycallbacklogger.Severity.Debug)
+    fields = {f"k{index}": index for index in range(9)}
+
+    # Act
+    logger.log(pycallbacklogger.Severity.Info, PyComponent.S, "many fields", FILE_NAME, 1, fields=fields)
+
+    # Assert
+    assert len(received_entries[0].fields) == 8
+    assert logger.stats().truncated_fields == 1
+
+def test_register_file_callback_json_lines_writes_parsable_records(logger, PyComponent, temp_log_file):
+    # Arrange
+    FILE_NAME = "f.cpp"
+    logger.register_file_callback(temp_log_file, pycallbacklogger.Severity.Info, format=pycallbacklogger.FileFormat.JsonLines)
+
+    # Act
+    logger.log(pycallbacklogger.Severity.Info, PyComponent.S, 'quoted "text"', FILE_NAME, 3, fields={"count": 2})
+    logger.shutdown()
+
+    # Assert
+    with open(temp_log_file, "r") as f:
+        records = [json.loads(line) for line in f]
+    assert records[0]["message"] == 'quoted "text"'
+    assert records[0]["line"] == 3
+    assert records[0]["fields"] == {"count": 2}
+
+def test_register_file_callback_pattern_writes_custom_layout(logger, PyComponent, temp_log_file):
+    # Arrange
+    FILE_NAME = "f.cpp"
+    logger.register_file_callback(temp_log_file, pycallbacklogger.Severity.Info, pattern="%S|%F:%L|%M")
+
+    # Act
+    logger.log(pycallbacklogger.Severity.Warning, PyComponent.S, "custom", FILE_NAME, 9)
+    logger.shutdown()
+
+    # Assert
+    with open(temp_log_file, "r") as f:
+        assert f.read() == "Warning|f.cpp:9|custom\n"
+
+def test_set_callback_priority_keeps_delivering_and_rejects_unknown_handle(logger, PyComponent, log_entry_collector):
+    # Arrange
+    callback, received_entries = log_entry_collector
+    FILE_NAME = "f.cpp"
+    handle = logger.register_function_callback(callback, pycallbacklogger.Severity.Debug)
+
+    # Act
+    logger.set_callback_priority(handle, pycallbacklogger.CallbackPriority.High)
+    logger.log(pycallbacklogger.Severity.Info, PyComponent.S, "prioritized", FILE_NAME, 1)
+
+    # Assert
+    assert [entry.message for entry in received_entries] == ["prioritized"]
+    with pytest.raises(RuntimeError):
+        logger.set_callback_priority(handle + 1000, pycallbacklogger.CallbackPriority.Low)
+
+def test_flush_and_shutdown_with_timeout_report_delivery(logger, PyComponent, log_entry_collector):
+    # Arrange
+    callback, received_entries = log_entry_collector
+    FILE_NAME = "f.cpp"
+    logger.register_function_callback(callback, pycallbacklogger.Severity.Debug)
+    logger.log(pycallbacklogger.Severity.Info, PyComponent.S, "delivered", FILE_NAME, 1)
+
+    # Act
+    is_flushed = logger.flush(1.0)
+    report = logger.shutdown(1.0)
+
+    # Assert
+    assert is_flushed
+    assert report.is_drained
+    assert report.dropped_tasks == 0
+    assert report.stuck_workers == 0
+    assert [entry.message for entry in received_entries] == ["delivered"]
+
+def test_component_subtree_filter_receives_descendants(logger, PyComponent, log_entry_collector, temp_log_file):
+    # Arrange
+    callback, received_entries = log_entry_collector
+    FILE_NAME = "f.cpp"
+    logger.set_component_parent(PyComponent.M, PyComponent.S)
+    logger.register_function_callback(callback, pycallbacklogger.ComponentSubtreeFilter(PyComponent.S, pycallbacklogger.Severity.Info))
+    logger.register_file_callback(temp_log_file, pycallbacklogger.ComponentSubtreeFilter({PyComponent.S: pycallbacklogger.Severity.Info}))
+
+    # Act
+    logger.log(pycallbacklogger.Severity.Info, PyComponent.M, "child", FILE_NAME, 1)
+    logger.log(pycallbacklogger.Severity.Info, PyComponent.P, "outside", FILE_NAME, 2)
+
+    # Assert
+    assert [entry.message for entry in received_entries] == ["child"]
+    with open(temp_log_file, "r") as f:
+        content = f.read()
+    assert "child" in content
+    assert "outside" not in content
+
+def test_message_filter_receives_only_matching_messages(logger, PyComponent, log_entry_collector):
+    # Arrange
+    callback, received_entries = log_entry_collector
+    FILE_NAME = "f.cpp"
+    logger.register_function_callback(callback, pycallbacklogger.Severity.Debug,
+                                      message_filter=pycallbacklogger.MessageFilter.contains("disk"))
+
+    # Act
+    logger.log(pycallbacklogger.Severity.Info, PyComponent.S, "disk full", FILE_NAME, 1)
+    logger.log(pycallbacklogger.Severity.Info, PyComponent.S, "cpu hot", FILE_NAME, 2)
+
+    # Assert
+    assert [entry.message for entry in received_entries] == ["disk full"]
+    assert logger.stats().filtered_out == 1
+    assert logger.stats().message_filter_rejections == 1